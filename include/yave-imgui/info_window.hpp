@@ -10,6 +10,10 @@
 #include <yave/lib/time/time.hpp>
 #include <yave/lib/image/image_format.hpp>
 
+#include <chrono>
+#include <string>
+#include <vector>
+
 namespace yave::editor::imgui {
 
   class info_window : public wm::window
@@ -34,5 +38,16 @@ namespace yave::editor::imgui {
     uint32_t m_width, m_height;
     uint32_t m_fps;
     image_format m_format;
+
+    /// node costs of last execution
+    struct profile_entry
+    {
+      std::string name;
+      std::chrono::nanoseconds time;
+      uint64_t allocations;
+    };
+
+    bool m_profiling;
+    std::vector<profile_entry> m_profile;
   };
 }
\ No newline at end of file
@@ -6,6 +6,9 @@
 #pragma once
 
 #include <yave/compiler/pipeline.hpp>
+#include <yave/compiler/sema_cache.hpp>
+#include <yave/compiler/typecheck.hpp>
+#include <yave/compiler/profiler.hpp>
 #include <yave/node/core/structured_node_graph.hpp>
 #include <yave/node/core/node_declaration_store.hpp>
 #include <yave/node/core/node_definition_store.hpp>
@@ -19,7 +22,7 @@ namespace yave::compiler {
 
   /// Initialize program input
   /// output:
-  /// | 'ng'    as structured_node_graph
+  /// | 'ng'    as std::shared_ptr<const structured_node_graph>
   /// | 'os'    as socket_handle
   /// | 'decls' as node_declaraiton_map
   /// | 'defs'  as node_definition_map
@@ -30,10 +33,25 @@ namespace yave::compiler {
     node_declaration_map,
     node_definition_map);
 
+  /// Initialize program input from immutable snapshot of graph.
+  /// Compiler does not modify snapshot, and only clones it when it needs to
+  /// expand macros.
+  /// output:
+  /// | 'ng'    as std::shared_ptr<const structured_node_graph>
+  /// | 'os'    as socket_handle
+  /// | 'decls' as node_declaraiton_map
+  /// | 'defs'  as node_definition_map
+  void input(
+    pipeline& pipe,
+    std::shared_ptr<const structured_node_graph> ng,
+    socket_handle os,
+    node_declaration_map,
+    node_definition_map);
+
   /// Parse program input.
   /// input:
   /// | 'msg_map' as message_map
-  /// | 'ng'      as structured_node_graph
+  /// | 'ng'      as std::shared_ptr<const structured_node_graph>
   /// | 'os'      as socket_handle
   /// | 'decls'   as node_declaration_map
   void parse(pipeline& pipe);
@@ -44,25 +62,59 @@ namespace yave::compiler {
   ///  + typecheck
   ///  + executable graph gen
   /// input:
-  /// | 'msg_map' as message_map
-  /// | 'ng'      as structured_node_graph
-  /// | 'os'      as socket_handle
-  /// | 'defs'    as node_definition_map
+  /// | 'msg_map'    as message_map
+  /// | 'ng'         as std::shared_ptr<const structured_node_graph>
+  /// | 'os'         as socket_handle
+  /// | 'defs'       as node_definition_map
+  /// | 'sema_cache' as std::shared_ptr<sema_cache> (optional): reuse typed
+  /// |              subtrees of previous compilation, and update it.
+  /// | 'typecheck_backend' as typecheck_backend (optional): unification
+  /// |                     backend of type checker. Default is union_find.
+  /// | 'profiler' as std::shared_ptr<node_profiler> (optional): attach probes
+  /// |            to outputs of function nodes. 'sema_cache' is not used.
   /// output:
-  /// | 'exe'     as executable
+  /// | 'exe'      as executable
+  /// | 'typed_ir' as typed_ir: types of each node in 'exe'. Not available
+  /// |            with substitution backend.
   /// comsumes:
   /// | 'ng', 'os', 'defs'
   void sema(pipeline& pipe);
 
   /// Post sema verification.
+  /// Checks typing of each node in 'typed_ir' when available, otherwise runs
+  /// type inference on 'exe' again.
   /// input:
-  /// | 'msg_map' as message_map
-  /// | 'exe' as executable
+  /// | 'msg_map'     as message_map
+  /// | 'exe'         as executable
+  /// | 'typed_ir'    as typed_ir (optional)
+  /// | 'verify_full' as bool (optional): always run type inference (debug)
+  /// comsumes:
+  /// | 'typed_ir'
   void verify(pipeline& pipe);
 
   /// Optimize executable.
+  /// This stage includes:
+  ///  + dead argument elimination
+  ///  + common subexpression elimination
+  ///  + constant folding
+  ///  + sharing results of common subexpressions within a frame
+  ///  + memoization of time invariant subexpressions
+  ///  + caching results of pure signals by frame time
   /// input:
-  /// | 'msg_map' as message_map
-  /// | 'exe' as executable
+  /// | 'msg_map'      as message_map
+  /// | 'exe'          as executable
+  /// | 'opt_dump'     as bool (optional): log node counts of each pass
+  /// | 'signal_cache' as std::shared_ptr<signal_cache> (optional): cache
+  /// |                results of signals in this table
   void optimize(pipeline& pipe);
+
+  /// Lower executable to bytecode program.
+  /// Static subgraphs which wait for frame demand are compiled into
+  /// instructions, and replaced by registers which refer them. Other
+  /// subgraphs (lambdas, unevaluated arguments) are kept for graph reduction.
+  /// input:
+  /// | 'msg_map'    as message_map
+  /// | 'exe'        as executable
+  /// | 'lower_dump' as bool (optional): log number of instructions
+  void lower(pipeline& pipe);
 }
\ No newline at end of file
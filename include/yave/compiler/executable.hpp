@@ -8,8 +8,17 @@
 #include <yave/rts/object_ptr.hpp>
 #include <yave/data/frame_demand/frame_demand.hpp>
 
+#include <memory>
+
+namespace yave {
+  class bytecode_program;
+}
+
 namespace yave::compiler {
 
+  class memo_table;
+  class signal_cache;
+
   /// Executable wrapper
   class executable
   {
@@ -17,7 +26,12 @@ namespace yave::compiler {
     /// Ctor
     executable() = default;
     /// Ctor
-    executable(object_ptr<const Object> obj, object_ptr<const Type> type);
+    executable(
+      object_ptr<const Object> obj,
+      object_ptr<const Type> type,
+      std::shared_ptr<memo_table> memo             = nullptr,
+      std::shared_ptr<const bytecode_program> code = nullptr,
+      std::shared_ptr<signal_cache> cache          = nullptr);
     /// Ctor
     executable(const executable& other) = delete;
     /// Ctor
@@ -33,14 +47,33 @@ namespace yave::compiler {
     /// Get type.
     [[nodiscard]] auto type() const -> const object_ptr<const Type>&;
 
+    /// Get memo table.
+    [[nodiscard]] auto memo() const -> const std::shared_ptr<memo_table>&;
+
+    /// Get signal cache.
+    /// \returns nullptr when results are not cached.
+    [[nodiscard]] auto cache() const -> const std::shared_ptr<signal_cache>&;
+
+    /// Get bytecode program lowered from object.
+    /// \returns nullptr when executable is not lowered.
+    [[nodiscard]] auto program() const -> const bytecode_program*;
+
     /// Execute.
     [[nodiscard]] auto execute(const time& time) -> object_ptr<const Object>;
 
     /// Clone.
     [[nodiscard]] auto clone() const -> executable;
 
+    /// Discard memoized results, cached signals and registers of bytecode
+    /// program. Memo table, cache and program are shared between clones, so
+    /// this also affects all clones of this executable.
+    void clear_cache();
+
   private:
     object_ptr<const Object> m_obj;
     object_ptr<const Type> m_type;
+    std::shared_ptr<memo_table> m_memo;
+    std::shared_ptr<const bytecode_program> m_code;
+    std::shared_ptr<signal_cache> m_cache;
   };
 } // namespace yave
\ No newline at end of file
@@ -0,0 +1,80 @@
+//
+// Copyright (c) 2019 mocabe (https://github.com/mocabe)
+// Distributed under LGPLv3 License. See LICENSE for more details.
+//
+
+#pragma once
+
+#include <yave/rts/object_ptr.hpp>
+
+#include <vector>
+#include <mutex>
+
+namespace yave::compiler {
+
+  /// Result table of memoized subgraphs.
+  /// Shared between clones of executable, so results can outlive each
+  /// execution. Shared results are keyed by argument of each execution
+  /// instead, and discarded when the execution finishes.
+  class memo_table
+  {
+  public:
+    memo_table() = default;
+    memo_table(const memo_table&) = delete;
+    memo_table& operator=(const memo_table&) = delete;
+
+    /// Add new entry.
+    /// \returns index of new entry
+    [[nodiscard]] auto add() -> size_t;
+
+    /// Get result.
+    /// \returns nullptr when result is not available
+    [[nodiscard]] auto get(size_t idx) const -> object_ptr<const Object>;
+
+    /// Set result.
+    void set(size_t idx, object_ptr<const Object> obj);
+
+    /// Add new entry of shared results.
+    /// \returns index of new entry
+    [[nodiscard]] auto add_shared() -> size_t;
+
+    /// Get shared result for argument.
+    /// \returns nullptr when result is not available
+    [[nodiscard]] auto get_shared(
+      size_t idx,
+      const object_ptr<const Object>& arg) const -> object_ptr<const Object>;
+
+    /// Set shared result for argument.
+    void set_shared(
+      size_t idx,
+      object_ptr<const Object> arg,
+      object_ptr<const Object> obj);
+
+    /// Discard shared results of finished executions, which are results whose
+    /// argument is not referenced from outside of table.
+    void collect();
+
+    /// Discard all results.
+    void clear();
+
+    /// Number of entries.
+    [[nodiscard]] auto size() const -> size_t;
+
+    /// Number of shared results.
+    [[nodiscard]] auto shared_size() const -> size_t;
+
+  private:
+    struct shared_result
+    {
+      object_ptr<const Object> arg;
+      object_ptr<const Object> obj;
+    };
+
+  private:
+    mutable std::mutex m_mtx;
+    std::vector<object_ptr<const Object>> m_results;
+    /// results of each argument, one for each execution running
+    std::vector<std::vector<shared_result>> m_shared;
+  };
+
+} // namespace yave::compiler
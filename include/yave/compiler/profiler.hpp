@@ -0,0 +1,74 @@
+//
+// Copyright (c) 2019 mocabe (https://github.com/mocabe)
+// Distributed under LGPLv3 License. See LICENSE for more details.
+//
+
+#pragma once
+
+#include <yave/rts/object_ptr.hpp>
+#include <yave/node/core/node_handle.hpp>
+
+#include <chrono>
+#include <deque>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace yave::compiler {
+
+  /// Execution cost of node.
+  struct node_cost
+  {
+    /// id of node
+    uid node;
+    /// number of evaluations
+    uint64_t calls = 0;
+    /// evaluation time, excluding time spent in other profiled nodes
+    std::chrono::nanoseconds time = {};
+    /// number of allocated objects, excluding other profiled nodes
+    uint64_t allocations = 0;
+  };
+
+  /// Per-node execution profiler.
+  /// Costs are recorded by probes which sema attaches to outputs of function
+  /// nodes, and shared between clones of executable.
+  class node_profiler
+  {
+  public:
+    node_profiler() = default;
+    node_profiler(const node_profiler&) = delete;
+    node_profiler& operator=(const node_profiler&) = delete;
+
+    /// Add node.
+    /// \returns index of entry. Same node always has same entry.
+    [[nodiscard]] auto add(const node_handle& node) -> size_t;
+
+    /// Record cost of single evaluation.
+    void record(size_t idx, std::chrono::nanoseconds time, uint64_t allocs);
+
+    /// Get recorded costs of all nodes.
+    [[nodiscard]] auto results() const -> std::vector<node_cost>;
+
+    /// Get recorded costs and reset them.
+    [[nodiscard]] auto take() -> std::vector<node_cost>;
+
+    /// Reset recorded costs.
+    void reset();
+
+    /// Number of profiled nodes.
+    [[nodiscard]] auto size() const -> size_t;
+
+  private:
+    mutable std::mutex m_mtx;
+    std::deque<node_cost> m_costs;
+    std::map<uid, size_t> m_index;
+  };
+
+  /// Create probe for node.
+  /// Probe f x = f x, and records cost of evaluating f x to profiler.
+  [[nodiscard]] auto make_probe(
+    const std::shared_ptr<node_profiler>& profiler,
+    const node_handle& node) -> object_ptr<const Object>;
+
+} // namespace yave::compiler
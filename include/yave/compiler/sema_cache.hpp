@@ -0,0 +1,55 @@
+//
+// Copyright (c) 2019 mocabe (https://github.com/mocabe)
+// Distributed under LGPLv3 License. See LICENSE for more details.
+//
+
+#pragma once
+
+#include <yave/rts/object_ptr.hpp>
+#include <yave/rts/type_value.hpp>
+#include <yave/support/id.hpp>
+
+#include <map>
+
+namespace yave::compiler {
+
+  /// Typed subtrees of previous compilation.
+  /// Keyed by output socket ID of node which generated the subtree. Entries
+  /// are valid while structural hash of upstream nodes is unchanged, so sema
+  /// can reuse them instead of generating and typing the subtree again.
+  class sema_cache
+  {
+  public:
+    /// cache entry
+    struct entry
+    {
+      /// structural hash of upstream subgraph
+      size_t hash = 0;
+      /// overloading resolved subtree
+      object_ptr<const Object> obj;
+      /// monomorphic type of subtree
+      object_ptr<const Type> type;
+    };
+
+    sema_cache() = default;
+    sema_cache(const sema_cache&) = delete;
+    sema_cache& operator=(const sema_cache&) = delete;
+
+    /// Find valid entry.
+    /// \returns nullptr when not found or hash does not match.
+    [[nodiscard]] auto find(const uid& id, size_t hash) const -> const entry*;
+
+    /// Replace all entries.
+    void reset(std::map<uid, entry> entries);
+
+    /// Discard all entries.
+    void clear();
+
+    /// Number of entries.
+    [[nodiscard]] auto size() const -> size_t;
+
+  private:
+    std::map<uid, entry> m_entries;
+  };
+
+} // namespace yave::compiler
@@ -0,0 +1,113 @@
+//
+// Copyright (c) 2019 mocabe (https://github.com/mocabe)
+// Distributed under LGPLv3 License. See LICENSE for more details.
+//
+
+#pragma once
+
+#include <yave/rts/object_ptr.hpp>
+#include <yave/lib/time/time.hpp>
+
+#include <cstdint>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+
+namespace yave::compiler {
+
+  /// LRU table of signal results keyed by structural hash of subgraph and
+  /// frame time.
+  /// Results are kept until total size of them exceeds memory budget, so
+  /// frames which were computed recently (loop playback, scrubbing) can be
+  /// reused. Shared between clones of executable.
+  class signal_cache
+  {
+  public:
+    /// Default memory budget in bytes.
+    static constexpr size_t default_budget = 256 * 1024 * 1024;
+
+    /// Ctor
+    signal_cache(size_t budget = default_budget);
+    signal_cache(const signal_cache&) = delete;
+    signal_cache& operator=(const signal_cache&) = delete;
+
+    /// Get result.
+    /// \returns nullptr when result is not available
+    [[nodiscard]] auto get(uint64_t hash, const time& t)
+      -> object_ptr<const Object>;
+
+    /// Set result.
+    /// Least recently used results are discarded to fit in budget. Results
+    /// larger than budget are not stored.
+    void set(uint64_t hash, const time& t, object_ptr<const Object> obj);
+
+    /// Discard all results.
+    void clear();
+
+    /// Get memory budget.
+    [[nodiscard]] auto budget() const -> size_t;
+
+    /// Set memory budget. Discards results which do not fit.
+    void set_budget(size_t bytes);
+
+    /// Total size of results in bytes.
+    [[nodiscard]] auto usage() const -> size_t;
+
+    /// Number of results.
+    [[nodiscard]] auto size() const -> size_t;
+
+    /// Number of lookups which found result.
+    [[nodiscard]] auto hits() const -> uint64_t;
+
+    /// Number of lookups which did not find result.
+    [[nodiscard]] auto misses() const -> uint64_t;
+
+    /// Estimate memory size of result.
+    [[nodiscard]] static auto cost_of(const object_ptr<const Object>& obj)
+      -> size_t;
+
+  private:
+    struct key
+    {
+      uint64_t hash;
+      time::value_type t;
+
+      bool operator==(const key&) const = default;
+    };
+
+    struct key_hash
+    {
+      auto operator()(const key& k) const noexcept -> size_t;
+    };
+
+    struct entry
+    {
+      key k;
+      object_ptr<const Object> obj;
+      size_t cost;
+    };
+
+    /// evict entries until usage fits in budget
+    void evict(std::list<entry>& evicted);
+
+  private:
+    mutable std::mutex m_mtx;
+    /// entries from most recently used
+    std::list<entry> m_entries;
+    std::unordered_map<key, std::list<entry>::iterator, key_hash> m_index;
+    size_t m_budget;
+    size_t m_usage    = 0;
+    uint64_t m_hits   = 0;
+    uint64_t m_misses = 0;
+  };
+
+  /// Create cache point.
+  /// Cache f x = f x, and result of f x is looked up from cache by hash of f
+  /// and time of frame demand x.
+  /// \param hash structural hash of f
+  [[nodiscard]] auto make_cache_point(
+    const std::shared_ptr<signal_cache>& cache,
+    uint64_t hash) -> object_ptr<const Object>;
+
+} // namespace yave::compiler
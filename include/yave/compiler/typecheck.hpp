@@ -7,6 +7,7 @@
 
 #include <yave/compiler/overloaded.hpp>
 #include <yave/compiler/location.hpp>
+#include <yave/compiler/typed_ir.hpp>
 #include <yave/rts/dynamic_typing.hpp>
 #include <yave/node/core/node_handle.hpp>
 #include <yave/node/core/socket_handle.hpp>
@@ -44,7 +45,38 @@ namespace yave::compiler {
       const object_ptr<const Type>& class_id) const -> const overloaded_class*;
   };
 
+  /// Subtree typing cache for incremental compilation.
+  struct typing_cache
+  {
+    /// Subtrees reused from previous compilation.
+    /// These subtrees are already overloading resolved and have monomorphic
+    /// types, so type checker trusts them without traversing.
+    /// map of (subtree, type)
+    std::map<const Object*, object_ptr<const Type>> known;
+
+    /// Subtrees to record typing results.
+    /// After type checking, contains overloading resolved subtree and its type
+    /// when the subtree has monomorphic type. Otherwise both are nullptr.
+    /// map of (subtree, (resolved subtree, type))
+    std::map<
+      const Object*,
+      std::pair<object_ptr<const Object>, object_ptr<const Type>>>
+      record;
+  };
+
+  /// Unification backend of type_of_overloaded().
+  enum class typecheck_backend
+  {
+    /// Substitution maps. Applies every binding to types on each step.
+    substitution,
+    /// Mutable union-find store. Binds each type variable once and resolves
+    /// bindings lazily.
+    union_find,
+  };
+
   /// \brief dynamic type checker with overloading extension.
+  /// \param ir when not null, receives resolved app tree annotated with types.
+  /// Only union_find backend records types; left empty otherwise.
   /// \returns pair of type of apply tree and overloading resolved app tree.
   /// FIXME: Current implementation is very hacky and probably not theoritically
   /// correct. Would be better to implement type scheme based inference with
@@ -52,7 +84,20 @@ namespace yave::compiler {
   [[nodiscard]] auto type_of_overloaded(
     const object_ptr<const Object>& obj,
     class_env&& classes,
-    location_map&& loc)
+    location_map&& loc,
+    typecheck_backend backend = typecheck_backend::substitution,
+    typed_ir* ir              = nullptr)
+    -> std::pair<object_ptr<const Type>, object_ptr<const Object>>;
+
+  /// \brief dynamic type checker with overloading extension.
+  /// \param cache subtrees to reuse and record.
+  [[nodiscard]] auto type_of_overloaded(
+    const object_ptr<const Object>& obj,
+    class_env&& classes,
+    location_map&& loc,
+    typing_cache& cache,
+    typecheck_backend backend = typecheck_backend::substitution,
+    typed_ir* ir              = nullptr)
     -> std::pair<object_ptr<const Type>, object_ptr<const Object>>;
 
 } // namespace yave::compiler
@@ -0,0 +1,59 @@
+//
+// Copyright (c) 2019 mocabe (https://github.com/mocabe)
+// Distributed under LGPLv3 License. See LICENSE for more details.
+//
+
+#pragma once
+
+#include <yave/rts/object_ptr.hpp>
+#include <yave/rts/type_value.hpp>
+
+#include <unordered_map>
+
+namespace yave::compiler {
+
+  /// Apply graph annotated with types inferred by type checker.
+  /// Holds types of Apply and Lambda nodes, so typing of each node can be
+  /// checked locally without running type inference again.
+  class typed_ir
+  {
+  public:
+    /// types of Apply or Lambda node
+    struct node_type
+    {
+      /// type of node
+      object_ptr<const Type> type;
+      /// Apply: type of function, Lambda: type of variable.
+      /// nullptr when subtree is trusted (typed by previous compilation).
+      object_ptr<const Type> t1;
+      /// Apply: type of argument, Lambda: type of body.
+      object_ptr<const Type> t2;
+    };
+
+    /// Ctor
+    typed_ir() = default;
+    /// Ctor
+    typed_ir(
+      object_ptr<const Object> obj,
+      std::unordered_map<const Object*, node_type> types);
+
+    /// Get annotated apply graph.
+    [[nodiscard]] auto object() const -> const object_ptr<const Object>&;
+
+    /// Find types of node.
+    /// \returns nullptr when node is not annotated.
+    [[nodiscard]] auto find(const Object* node) const -> const node_type*;
+
+    /// Number of annotated nodes.
+    [[nodiscard]] auto size() const -> size_t;
+
+    /// Check typing of each node in linear time.
+    /// \param type expected type of apply graph
+    [[nodiscard]] bool check(const object_ptr<const Type>& type) const;
+
+  private:
+    object_ptr<const Object> m_obj;
+    std::unordered_map<const Object*, node_type> m_types;
+  };
+
+} // namespace yave::compiler
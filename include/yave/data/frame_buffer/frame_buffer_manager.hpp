@@ -63,6 +63,11 @@ namespace yave::data {
     /// Get internal texture data
     [[nodiscard]] auto get_texture_data(uid id) -> vulkan::texture_data&;
 
+    /// Lock frame buffers and command pool/queue of offscreen context.
+    /// GPU commands on frame buffers should be submitted while holding this
+    /// lock, since they can be executed from multiple threads.
+    [[nodiscard]] auto lock() const -> std::unique_lock<std::recursive_mutex>;
+
   private:
     class impl;
     std::unique_ptr<impl> m_pimpl;
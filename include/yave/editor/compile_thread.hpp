@@ -7,6 +7,7 @@
 
 #include <yave/compiler/message.hpp>
 #include <yave/compiler/executable.hpp>
+#include <yave/compiler/profiler.hpp>
 
 #include <yave/editor/data_context.hpp>
 
@@ -75,6 +76,15 @@ namespace yave::editor {
     /// get executable
     auto last_executable() const -> const std::optional<compiler::executable>&;
 
+    /// get profiler attached to executable
+    /// \returns nullptr when executable is not profiled
+    auto last_profiler() const
+      -> const std::shared_ptr<compiler::node_profiler>&;
+
+    /// get version of executable.
+    /// incremented each time when compile result is updated.
+    auto version() const -> uint64_t;
+
   private:
     friend class compile_thread;
 
@@ -82,6 +92,7 @@ namespace yave::editor {
     {
       compiler::message_map last_msg;
       std::optional<compiler::executable> last_exe;
+      std::shared_ptr<compiler::node_profiler> last_profiler;
     };
     void set_results(compile_results results);
     void clear_results();
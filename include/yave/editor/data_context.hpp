@@ -8,6 +8,7 @@
 #include <yave/config/config.hpp>
 #include <yave/lib/unique_any/unique_any.hpp>
 #include <yave/lib/util/locked_reference.hpp>
+#include <yave/support/trace.hpp>
 
 #include <mutex>
 #include <stdexcept>
@@ -105,7 +106,12 @@ namespace yave::editor {
     {
       if (auto p = _get_data(typeid(T))) {
 
-        auto lck = std::unique_lock(p->mtx);
+        auto lck = std::unique_lock(p->mtx, std::try_to_lock);
+
+        if (!lck.owns_lock()) {
+          YAVE_TRACE_SPAN("get_data wait", "lock");
+          lck.lock();
+        }
 
         if (auto d = unique_any_cast<T>(&p->data))
           return shared_locked_reference(
@@ -64,6 +64,16 @@ namespace yave::editor {
     /// node graph
     auto node_graph() const -> const structured_node_graph &;
     auto node_graph() -> structured_node_graph &;
+    /// immutable snapshot of node graph.
+    /// snapshot is shared until node graph is modified. clones node graph
+    /// when snapshot was not updated by update_node_graph_snapshot().
+    auto node_graph_snapshot() -> std::shared_ptr<const structured_node_graph>;
+    /// check if snapshot of node graph is up to date
+    bool node_graph_snapshot_updated() const;
+    /// set snapshot of node graph taken at version
+    void set_node_graph_snapshot(
+      std::shared_ptr<const structured_node_graph> snapshot,
+      uint64_t version);
     /// node group
     auto root_group() const -> const node_handle &;
     auto root_group() -> node_handle &;
@@ -81,4 +91,9 @@ namespace yave::editor {
     auto update_channel() -> node_argument_update_channel &;
     auto update_channel() const -> const node_argument_update_channel &;
   };
+
+  /// update snapshot of node graph.
+  /// node graph is cloned without holding lock of editor data, so this should
+  /// be called from data thread, which is the only thread modifying graph.
+  void update_node_graph_snapshot(data_context &dctx);
 } // namespace yave::editor
\ No newline at end of file
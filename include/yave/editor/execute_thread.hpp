@@ -6,6 +6,8 @@
 #pragma once
 
 #include <yave/editor/data_context.hpp>
+#include <yave/editor/frame_cache.hpp>
+#include <yave/compiler/profiler.hpp>
 #include <yave/obj/frame_buffer/frame_buffer.hpp>
 #include <yave/lib/time/time.hpp>
 #include <yave/lib/image/image.hpp>
@@ -54,7 +56,12 @@ namespace yave::editor {
     void stop();
 
     /// async execute with current arg time.
+    /// cancels frame currently executing when its time, executable or
+    /// arguments are different from current ones.
     void notify_execute();
+
+    /// cancel frame currently executing, without new execution.
+    void cancel_execute();
   };
 
   /// Execute thread data
@@ -90,6 +97,34 @@ namespace yave::editor {
     /// set loop execution flag
     void set_loop_execution(bool b);
 
+    /// is parallel evaluation enabled?
+    bool parallel_execution() const;
+    /// set parallel evaluation flag
+    void set_parallel_execution(bool b);
+
+    /// is per-node profiling enabled?
+    bool profiling() const;
+    /// set per-node profiling flag. takes effect on next compilation.
+    void set_profiling(bool b);
+
+    /// get memory budget of signal cache in bytes. 0 when disabled.
+    auto signal_cache_budget() const -> size_t;
+    /// set memory budget of signal cache. takes effect on next execution,
+    /// enabling/disabling cache takes effect on next compilation.
+    void set_signal_cache_budget(size_t bytes);
+
+    /// get number of frames rendered in parallel ahead of playhead in
+    /// continuous execution. 0 when disabled, number of workers of task pool
+    /// by default. Frames ahead are also limited by size of preview cache.
+    auto look_ahead() const -> size_t;
+    /// set number of frames rendered ahead of playhead
+    void set_look_ahead(size_t n);
+
+    /// get RAM preview cache of rendered frames
+    auto frame_cache() const -> const editor::frame_cache&;
+    /// get RAM preview cache of rendered frames
+    auto frame_cache() -> editor::frame_cache&;
+
     /// get time argument to execute.
     auto last_arg_time() const -> yave::time;
 
@@ -104,6 +139,10 @@ namespace yave::editor {
     /// get compute time of last execution
     auto last_compute_time() const -> std::chrono::milliseconds;
 
+    /// get cost of each node in last execution.
+    /// empty when profiling is disabled.
+    auto last_profile() const -> const std::vector<compiler::node_cost>&;
+
   private:
     friend class execute_thread;
     struct result_data
@@ -113,6 +152,7 @@ namespace yave::editor {
       std::chrono::milliseconds compute_time;
       std::chrono::steady_clock::time_point begin_time;
       std::chrono::steady_clock::time_point end_time;
+      std::vector<compiler::node_cost> profile;
     };
     void set_result(result_data data);
   };
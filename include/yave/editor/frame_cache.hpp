@@ -0,0 +1,83 @@
+//
+// Copyright (c) 2019 mocabe (https://github.com/mocabe)
+// Distributed under LGPLv3 License. See LICENSE for more details.
+//
+
+#pragma once
+
+#include <yave/lib/time/time.hpp>
+#include <yave/lib/image/image.hpp>
+
+#include <cstdint>
+#include <list>
+#include <memory>
+#include <unordered_map>
+
+namespace yave::editor {
+
+  /// RAM preview cache of rendered frames.
+  /// Frames are keyed by version of executable and time. Frames of older
+  /// versions are discarded when frame of new version is set, and least
+  /// recently used frames are discarded to fit in memory budget.
+  class frame_cache
+  {
+  public:
+    /// Default memory budget in bytes.
+    static constexpr size_t default_budget = size_t(1024) * 1024 * 1024;
+
+    /// Ctor
+    frame_cache(size_t budget = default_budget);
+    frame_cache(frame_cache&&) noexcept;
+    ~frame_cache() noexcept;
+    frame_cache& operator=(frame_cache&&) noexcept;
+
+    /// Get frame.
+    /// \returns nullptr when frame is not available
+    [[nodiscard]] auto get(uint64_t version, const time& t)
+      -> std::shared_ptr<const image>;
+
+    /// Check if frame is available without touching it.
+    [[nodiscard]] bool contains(uint64_t version, const time& t) const;
+
+    /// Set frame.
+    /// Frames larger than budget are not stored.
+    void set(uint64_t version, const time& t, std::shared_ptr<const image> img);
+
+    /// Discard all frames.
+    void clear();
+
+    /// Get version of frames in cache.
+    [[nodiscard]] auto version() const -> uint64_t;
+
+    /// Get memory budget.
+    [[nodiscard]] auto budget() const -> size_t;
+
+    /// Set memory budget. Discards frames which do not fit.
+    void set_budget(size_t bytes);
+
+    /// Total size of frames in bytes.
+    [[nodiscard]] auto usage() const -> size_t;
+
+    /// Number of frames.
+    [[nodiscard]] auto size() const -> size_t;
+
+  private:
+    struct entry
+    {
+      time::value_type t;
+      std::shared_ptr<const image> img;
+    };
+
+    /// evict frames until usage fits in budget
+    void evict();
+
+  private:
+    /// frames from most recently used
+    std::list<entry> m_entries;
+    std::unordered_map<time::value_type, std::list<entry>::iterator> m_index;
+    uint64_t m_version = 0;
+    size_t m_budget;
+    size_t m_usage = 0;
+  };
+
+} // namespace yave::editor
@@ -0,0 +1,98 @@
+//
+// Copyright (c) 2019 mocabe (https://github.com/mocabe)
+// Distributed under LGPLv3 License. See LICENSE for more details.
+//
+
+#pragma once
+
+#include <yave/compiler/executable.hpp>
+#include <yave/lib/time/time.hpp>
+#include <yave/lib/image/image.hpp>
+
+#include <functional>
+#include <optional>
+#include <memory>
+
+namespace yave::editor {
+
+  /// Pipelined frame renderer.
+  /// Queued frames are rendered concurrently on worker threads, each of them
+  /// executes its own clone of executable. Frames are delivered in the order
+  /// they were queued.
+  class frame_pipeline
+  {
+    class impl;
+    std::unique_ptr<impl> m_pimpl;
+
+  public:
+    /// Render function.
+    /// Returns nullptr when failed to render frame.
+    using render_function = std::function<
+      std::shared_ptr<const yave::image>(compiler::executable&&, yave::time)>;
+
+    /// Rendered frame
+    struct frame
+    {
+      /// time of frame
+      yave::time time;
+      /// version of executable
+      uint64_t version;
+      /// nullptr when failed to render
+      std::shared_ptr<const yave::image> image;
+    };
+
+    /// Get number of workers to render frames ahead.
+    /// \param n requested number of workers, 0 when disabled
+    /// \param frames number of frames which fit in preview cache, including
+    /// current frame
+    [[nodiscard]] static auto worker_count(size_t n, size_t frames) -> size_t;
+
+    /// Ctor
+    /// \param n_workers number of worker threads
+    /// \param capacity max number of queued frames
+    frame_pipeline(size_t n_workers, size_t capacity, render_function render);
+    /// Dtor. Cancels queued frames and waits for running frames.
+    ~frame_pipeline() noexcept;
+
+    /// Number of worker threads
+    [[nodiscard]] auto workers() const -> size_t;
+    /// Max number of queued frames
+    [[nodiscard]] auto capacity() const -> size_t;
+    /// Number of queued frames
+    [[nodiscard]] auto size() const -> size_t;
+    /// Check if new frame can be queued
+    [[nodiscard]] bool full() const;
+
+    /// Set executable to render. Cancels queued frames.
+    void reset(const compiler::executable& exe, uint64_t version);
+    /// Get version of executable
+    [[nodiscard]] auto version() const -> uint64_t;
+
+    /// Queue frame.
+    /// \returns false when pipeline is full, frame is already queued or
+    /// executable is not set.
+    bool push(yave::time t);
+
+    /// Check if frame is queued
+    [[nodiscard]] bool contains(yave::time t) const;
+
+    /// Cancel queued frames which satisfy predicate.
+    /// Frames already running are cancelled through cancel_token and
+    /// their results are discarded.
+    void cancel_if(const std::function<bool(yave::time)>& pred);
+    /// Cancel all queued frames.
+    void cancel();
+
+    /// Check if any worker is running frame.
+    [[nodiscard]] bool busy() const;
+    /// Wait until no worker is running frame.
+    void wait();
+
+    /// Take first frame, waiting until it's rendered.
+    /// \returns std::nullopt when no frame is queued.
+    auto pop() -> std::optional<frame>;
+    /// Take first frame if it's already rendered.
+    auto try_pop() -> std::optional<frame>;
+  };
+
+} // namespace yave::editor
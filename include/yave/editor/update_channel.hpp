@@ -35,7 +35,14 @@ namespace yave::editor {
     void push_update(update_data data);
 
     /// execute all updates
-    void apply_updates();
+    /// \returns true when any update was applied
+    bool apply_updates();
+
+    /// check if any update is queued
+    [[nodiscard]] bool has_updates() const;
+
+    /// get version of updates, incremented by each push_update()
+    [[nodiscard]] auto version() const -> uint64_t;
 
     /// get current change
     [[nodiscard]] auto get_current_value(
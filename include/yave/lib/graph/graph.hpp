@@ -11,7 +11,9 @@
 #include <algorithm>
 #include <random>
 #include <chrono>
-#include <map>
+#include <memory>
+#include <unordered_map>
+#include <cstddef>
 
 namespace yave::graph {
 
@@ -22,7 +24,6 @@ namespace yave::graph {
   // between sockets. Also, Edge has direction.
 
   // TODO: Possibly replace internal representation using Boost.Graph library.
-  // TODO: Use memory pool for allocation to improve data locality.
 
   struct graph_id_generator
   {
@@ -38,6 +39,11 @@ namespace yave::graph {
     }
   };
 
+  /// Dense slot storage for graph objects.
+  /// Values are allocated in fixed size blocks which are never moved, so
+  /// descriptors (pointers to values) stay valid until the value is destroyed.
+  /// Live descriptors are packed into a dense array for contiguous iteration,
+  /// and both descriptor and id lookups are O(1) hash lookups.
   template <template <class> class ValueType, class Graph>
   struct graph_container
   {
@@ -48,29 +54,60 @@ namespace yave::graph {
     // id type
     using id_type = typename Graph::id_type;
 
+    /// Number of slots in single block
+    static constexpr size_t block_size = 256;
+
+    /// Storage of single value
+    struct slot
+    {
+      alignas(value_type) std::byte storage[sizeof(value_type)];
+    };
+
     /// Internal container type for graph
     struct container_type
     {
-      // descriptor map.
-      std::map<descriptor_type, id_type> dsc_map;
-      // id map.
-      std::map<id_type, value_type> id_map;
+      // blocks of slots.
+      std::vector<std::unique_ptr<slot[]>> blocks;
+      // free slots.
+      std::vector<slot *> free;
+      // live descriptors.
+      std::vector<descriptor_type> dense;
+      // descriptor -> index in dense array.
+      std::unordered_map<descriptor_type, size_t> dsc_map;
+      // id -> descriptor.
+      std::unordered_map<id_type, descriptor_type> id_map;
     };
 
+    graph_container() = default;
+
+    graph_container(graph_container &&other) noexcept
+      : m_container {std::move(other.m_container)}
+    {
+      other.m_container = {};
+    }
+
+    graph_container &operator=(graph_container &&other) noexcept
+    {
+      if (this != &other) {
+        _destroy_all();
+        m_container       = std::move(other.m_container);
+        other.m_container = {};
+      }
+      return *this;
+    }
+
+    ~graph_container() noexcept
+    {
+      _destroy_all();
+    }
+
     /// Check if a descriptor exists in a container.
     /// \param descriptor descriptor
     /// \param return true when descriptor is valid and exists in the container
     bool exists(const descriptor_type &descriptor) const noexcept
     {
-      auto &c   = m_container;
-      auto &map = c.dsc_map;
-
-      auto iter = map.find(descriptor);
-
-      if (iter != map.end())
-        return true;
-
-      return false;
+      auto &map = m_container.dsc_map;
+      return map.find(descriptor) != map.end();
     }
 
     /// Check if an Id exists in a container.
@@ -78,28 +115,21 @@ namespace yave::graph {
     /// \param return true when the id exists in the container
     bool exists(const id_type &id) const noexcept
     {
-      auto &c   = m_container;
-      auto &map = c.id_map;
-
-      auto iter = map.find(id);
-
-      if (iter != map.end())
-        return true;
-
-      return false;
+      auto &map = m_container.id_map;
+      return map.find(id) != map.end();
     }
+
     /// Find descriptor from ID value.
     /// \param id id
     /// \returns nullptr when not found
     auto find_descriptor(const id_type &id) const noexcept -> descriptor_type
     {
-      auto &c   = m_container;
-      auto &map = c.id_map;
+      auto &map = m_container.id_map;
 
       auto iter = map.find(id);
 
       if (iter != map.end())
-        return &iter->second;
+        return iter->second;
 
       return nullptr;
     }
@@ -112,25 +142,27 @@ namespace yave::graph {
     void destroy(const descriptor_type &descriptor, const id_type &id) noexcept
     {
       auto &c = m_container;
-      // remove id
-      {
-        auto &map = c.id_map;
-
-        auto iter = map.find(id);
 
-        if (iter != map.end())
-          map.erase(iter);
-      }
+      auto iter = c.dsc_map.find(descriptor);
 
-      // remove descriptor
-      {
-        auto &map = c.dsc_map;
-
-        auto iter = map.find(descriptor);
+      if (iter == c.dsc_map.end())
+        return;
 
-        if (iter != map.end())
-          map.erase(iter);
+      // swap with last element of dense array
+      auto idx = iter->second;
+      if (idx != c.dense.size() - 1) {
+        auto last          = c.dense.back();
+        c.dense[idx]       = last;
+        c.dsc_map.at(last) = idx;
       }
+      c.dense.pop_back();
+      c.dsc_map.erase(iter);
+      c.id_map.erase(id);
+
+      // release slot
+      auto p = const_cast<value_type *>(descriptor);
+      p->~value_type();
+      c.free.push_back(reinterpret_cast<slot *>(p));
     }
 
     /// Instance in a container and return descriptor.
@@ -141,20 +173,22 @@ namespace yave::graph {
     {
       auto &c = m_container;
 
-      descriptor_type dsc;
-      {
-        // insert id
-        auto [iter, succ] =
-          c.id_map.emplace(id, value_type(id, std::forward<Args>(args)...));
-        dsc = succ ? &iter->second : nullptr;
-      }
-
       // duplicated id
-      if (!dsc)
+      if (c.id_map.find(id) != c.id_map.end())
         return nullptr;
 
-      // insert dsc
-      c.dsc_map.emplace(dsc, id);
+      if (c.free.empty())
+        _grow();
+
+      auto s = c.free.back();
+
+      auto dsc = static_cast<descriptor_type>(
+        new (s->storage) value_type(id, std::forward<Args>(args)...));
+
+      c.free.pop_back();
+      c.id_map.emplace(id, dsc);
+      c.dsc_map.emplace(dsc, c.dense.size());
+      c.dense.push_back(dsc);
 
       return dsc;
     }
@@ -162,16 +196,7 @@ namespace yave::graph {
     /// Get list of descriptors.
     auto descriptors() const
     {
-      auto &c = m_container;
-
-      std::vector<descriptor_type> ret;
-      ret.reserve(c.dsc_map.size());
-
-      for (auto &&pair : c.dsc_map) {
-        ret.push_back(pair.first);
-      }
-
-      return ret;
+      return m_container.dense;
     }
 
     /// Get list of IDs.
@@ -181,10 +206,10 @@ namespace yave::graph {
       auto &c = m_container;
 
       std::vector<id_type> ret;
-      ret.reserve(c.id_map.size());
+      ret.reserve(c.dense.size());
 
-      for (auto &&pair : c.id_map) {
-        ret.push_back(pair.first);
+      for (auto &&dsc : c.dense) {
+        ret.push_back(dsc->id());
       }
 
       return ret;
@@ -195,7 +220,8 @@ namespace yave::graph {
     {
       auto &c = m_container;
       assert(c.dsc_map.size() == c.id_map.size());
-      return c.dsc_map.size();
+      assert(c.dense.size() == c.id_map.size());
+      return c.dense.size();
     }
 
     /// Access function.
@@ -240,6 +266,30 @@ namespace yave::graph {
       return access(descriptor);
     }
 
+  private:
+    /// Allocate new block of slots
+    void _grow()
+    {
+      auto &c = m_container;
+
+      auto block = std::make_unique<slot[]>(block_size);
+
+      // push in reverse order to pop slots from front of block
+      for (size_t i = 0; i < block_size; ++i)
+        c.free.push_back(&block[block_size - i - 1]);
+
+      c.blocks.push_back(std::move(block));
+    }
+
+    /// Destroy all values
+    void _destroy_all() noexcept
+    {
+      for (auto &&dsc : m_container.dense)
+        const_cast<value_type *>(dsc)->~value_type();
+
+      m_container.dense.clear();
+    }
+
   private:
     // container
     container_type m_container;
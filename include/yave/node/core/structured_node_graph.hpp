@@ -353,6 +353,11 @@ namespace yave {
     void bring_back(const node_handle& node);
 
   public:
+    /// Get version stamp of graph.
+    /// Version changes on every modification, and is unique among graphs, so
+    /// it can be used to check if a graph is modified since last clone().
+    [[nodiscard]] auto version() const -> uint64_t;
+
     /// clone
     [[nodiscard]] auto clone() const -> structured_node_graph;
 
@@ -29,6 +29,9 @@ namespace yave {
 
     struct Generator : Function<Generator, NodeArgument, FrameDemand, Color>
     {
+      static constexpr auto _attributes =
+        closure_attributes::pure | closure_attributes::forward_last_arg;
+
       auto code() const -> return_type
       {
         auto arg  = eval_arg<0>();
@@ -6,6 +6,7 @@
 #pragma once
 
 #include <yave/rts/box.hpp>
+#include <yave/rts/immediate.hpp>
 
 namespace yave {
 
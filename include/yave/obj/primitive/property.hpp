@@ -58,6 +58,10 @@ namespace yave {
 
     struct Generator : Function<Generator, NodeArgument, FrameDemand, T>
     {
+      // value does not depend on frame demand
+      static constexpr auto _attributes =
+        closure_attributes::pure | closure_attributes::forward_last_arg;
+
       auto code() const -> typename Generator::return_type
       {
         auto arg  = this->template eval_arg<0>();
@@ -156,6 +160,9 @@ namespace yave {
 
     struct Generator : Function<Generator, NodeArgument, FrameDemand, T>
     {
+      static constexpr auto _attributes =
+        closure_attributes::pure | closure_attributes::forward_last_arg;
+
       auto code() const -> typename Generator::return_type
       {
         auto arg = this->template eval_arg<0>();
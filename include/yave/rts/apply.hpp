@@ -9,9 +9,19 @@
 
 namespace yave {
 
+  namespace detail {
+    /// true when apply nodes can be evaluated by other threads concurrently.
+    /// set by task_pool.
+    inline thread_local bool concurrent_eval = false;
+  } // namespace detail
+
   // ------------------------------------------
   // apply object storage
 
+  /// Storage of Apply.
+  /// Result can be set concurrently; first result wins and never changes
+  /// after that. When concurrent evaluation is enabled, closure and argument
+  /// are kept until destruction since other threads may still read them.
   struct apply_object_value_storage
   {
     apply_object_value_storage(
@@ -24,34 +34,59 @@ namespace yave {
 
     [[nodiscard]] auto app() const noexcept -> object_ptr<const Object>&
     {
-      assert(!is_result());
+      assert(m_app);
       return m_app;
     }
 
     [[nodiscard]] auto arg() const noexcept -> object_ptr<const Object>&
     {
-      assert(!is_result());
+      assert(m_app);
       return m_arg;
     }
 
+    /// check if closure and argument are still available
+    [[nodiscard]] bool has_arg() const noexcept
+    {
+      return m_app != nullptr;
+    }
+
     [[nodiscard]] bool is_result() const noexcept
     {
-      return m_app == nullptr;
+      return _get_storage(m_result).atomic_load(std::memory_order_acquire)
+             != nullptr;
     }
 
     /// get cache of object
     [[nodiscard]] auto get_result() const noexcept -> object_ptr<const Object>
     {
       assert(is_result());
-      return m_arg;
+      // result can be set by other thread concurrently
+      return m_result.atomic_load(std::memory_order_acquire);
     }
 
     /// set cache of object
     void set_result(const object_ptr<const Object>& obj) const noexcept
     {
-      assert(!is_result());
-      m_app = nullptr;
-      m_arg = obj;
+      assert(obj);
+
+      if (is_result())
+        return;
+
+      auto result            = obj;
+      const Object* expected = nullptr;
+
+      // other thread already set result
+      if (!_get_storage(m_result).atomic_compare_exchange(
+            expected, _get_storage(result).get(), std::memory_order_acq_rel))
+        return;
+
+      // ownership moved to m_result
+      (void)result.release();
+
+      if (!detail::concurrent_eval) {
+        m_app = nullptr;
+        m_arg = nullptr;
+      }
     }
 
   private:
@@ -59,6 +94,8 @@ namespace yave {
     mutable object_ptr<const Object> m_app;
     /// argument
     mutable object_ptr<const Object> m_arg;
+    /// result
+    mutable object_ptr<const Object> m_result;
   };
 
   /// value of Apply
@@ -13,6 +13,7 @@
 namespace yave {
 
   /// Atomic reference count.
+  /// Also provides non-atomic operations for thread confined objects.
   template <class T>
   class atomic_refcount
   {
@@ -81,6 +82,20 @@ namespace yave {
       return ref.fetch_sub(1u, std::memory_order_release);
     }
 
+    /// Non-atomic increment.
+    /// Only for objects which are not visible from other threads.
+    T fetch_add_local() noexcept
+    {
+      return m_val++;
+    }
+
+    /// Non-atomic decrement.
+    /// Only for objects which are not visible from other threads.
+    T fetch_sub_local() noexcept
+    {
+      return m_val--;
+    }
+
   private:
     T m_val;
   };
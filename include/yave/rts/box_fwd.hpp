@@ -70,7 +70,7 @@ namespace yave {
           && "Dont forget setting memory_resource after calling new()");
 
         return object_new<T>(
-          obj->memory_resource, *static_cast<const T *>(obj));
+          object_resource(obj->memory_resource), *static_cast<const T *>(obj));
       } catch (...) {
         // TODO: return Exception object
         return nullptr;
@@ -0,0 +1,301 @@
+//
+// Copyright (c) 2019 mocabe (https://github.com/mocabe)
+// Distributed under LGPLv3 License. See LICENSE for more details.
+//
+
+#pragma once
+
+#include <yave/rts/function.hpp>
+#include <yave/rts/eval.hpp>
+#include <yave/rts/frame_arena.hpp>
+
+#include <mutex>
+#include <atomic>
+#include <memory>
+#include <vector>
+
+namespace yave {
+
+  /// Instruction of bytecode program.
+  /// Holds closure instance which already has all static arguments in its
+  /// local stack and only waits for its last argument, so it can be called
+  /// without walking spine or cloning closure. Results of pure closures are
+  /// kept in register slot of instruction, keyed by the last argument.
+  class bytecode_instruction
+  {
+  public:
+    /// Check if apply graph can be compiled into instruction.
+    /// Bottom closure should wait only for its last argument, and arguments
+    /// should not contain unevaluated subgraphs.
+    [[nodiscard]] static bool is_lowerable(const object_ptr<const Object>& obj)
+    {
+      if (!value_cast_if<Apply>(obj))
+        return false;
+
+      auto [depth, bottom] = detail::inspect_spine(obj);
+      auto closure         = value_cast_if<Closure<>>(bottom);
+
+      if (!closure || closure->arity != depth + 1)
+        return false;
+
+      auto* cur = &obj;
+      object_ptr<const Object> cached;
+
+      while (auto vert = value_cast_if<Apply>(*cur)) {
+
+        auto& storage = _get_storage(*vert);
+
+        if (storage.is_result()) {
+          cached = storage.get_result();
+          cur    = &cached;
+          continue;
+        }
+
+        // subgraphs which are evaluated in place or instantiated
+        auto& arg = storage.arg();
+
+        if (auto app = value_cast_if<Apply>(arg))
+          if (!_get_storage(*app).is_result())
+            return false;
+
+        if (value_cast_if<Lambda>(arg) || value_cast_if<Variable>(arg))
+          return false;
+
+        cur = &storage.app();
+      }
+      return true;
+    }
+
+    /// Ctor
+    /// \requires is_lowerable(obj)
+    explicit bytecode_instruction(const object_ptr<const Object>& obj)
+    {
+      assert(is_lowerable(obj));
+
+      auto [depth, bottom] = detail::inspect_spine(obj);
+
+      auto closure = value_cast_if<Closure<>>(bottom).clone();
+      m_pure       = closure->has_attributes(closure_attributes::pure);
+
+      // dump static arguments to local stack, leaving slot of last argument.
+      auto idx  = closure->arity - depth;
+      auto* cur = &obj;
+
+      object_ptr<const Object> cached;
+
+      while (auto vert = value_cast_if<Apply>(*cur)) {
+
+        auto& storage = _get_storage(*vert);
+
+        if (storage.is_result()) {
+          cached = storage.get_result();
+          cur    = &cached;
+          continue;
+        }
+
+        cur                        = &storage.app();
+        closure->vertebrae(idx++) = std::move(vert);
+      }
+      assert(idx == closure->arity);
+
+      closure->arity -= depth;
+
+      m_closure  = closure.clone();
+      m_template = std::move(closure);
+    }
+
+    bytecode_instruction(const bytecode_instruction&) = delete;
+    bytecode_instruction& operator=(const bytecode_instruction&) = delete;
+
+    /// Call closure.
+    /// \param app apply node of the last argument, which receives result.
+    /// \throws exception_result when closure returned exception.
+    [[nodiscard]] auto call(const object_ptr<const Apply>& app) const
+      -> object_ptr<const Object>
+    {
+      auto& storage = _get_storage(*app);
+
+      if (storage.is_result())
+        return storage.get_result();
+
+      auto key = storage.arg();
+
+      if (m_pure) {
+        auto lck = std::unique_lock(m_mtx);
+        if (m_key == key) {
+          auto result = m_value;
+          lck.unlock();
+          storage.set_result(result);
+          return result;
+        }
+      }
+
+      auto result = [&] {
+        if (!m_busy.exchange(true, std::memory_order_acquire)) {
+          m_closure->vertebrae(0) = app;
+          auto ret                = m_closure->call();
+          m_closure->vertebrae(0) = nullptr;
+          m_busy.store(false, std::memory_order_release);
+          return ret;
+        }
+        // reentrant or concurrent call
+        auto fun           = m_template.clone();
+        fun->vertebrae(0) = app;
+        return fun->call();
+      }();
+
+      if (auto e = value_cast_if<Exception>(result))
+        throw exception_result(e);
+
+      if (m_pure) {
+        // register is shared between clones of executable
+        frame_arena::instance().share();
+
+        auto lck = std::unique_lock(m_mtx);
+        m_key    = std::move(key);
+        m_value  = result;
+      }
+      return result;
+    }
+
+    /// Discard result in register.
+    void clear() const
+    {
+      auto lck = std::unique_lock(m_mtx);
+      m_key    = nullptr;
+      m_value  = nullptr;
+    }
+
+    /// Closure instance.
+    [[nodiscard]] auto closure() const -> object_ptr<const Closure<>>
+    {
+      return m_template;
+    }
+
+  private:
+    /// closure waiting for last argument, never modified
+    object_ptr<const Closure<>> m_template;
+    /// instance of template, only used by owner of m_busy
+    object_ptr<Closure<>> m_closure;
+    /// cache results?
+    bool m_pure = false;
+    /// closure instance is in use
+    mutable std::atomic<bool> m_busy = false;
+
+  private:
+    mutable std::mutex m_mtx;
+    mutable object_ptr<const Object> m_key;
+    mutable object_ptr<const Object> m_value;
+  };
+
+  namespace detail {
+    class Register_X;
+    class Register_Y;
+  } // namespace detail
+
+  /// Reference to instruction of bytecode program.
+  /// Applying register to an argument calls the instruction, so registers can
+  /// replace original subgraphs in apply graph.
+  struct Register
+    : Function<Register, detail::Register_X, detail::Register_Y>
+  {
+    Register(std::shared_ptr<const bytecode_instruction> instr)
+      : m_instr {std::move(instr)}
+    {
+    }
+
+    auto code() const -> return_type
+    {
+      auto cthis = reinterpret_cast<const Closure<>*>(this);
+      return static_object_cast<const VarValueProxy<detail::Register_Y>>(
+        m_instr->call(cthis->vertebrae(0)));
+    }
+
+    /// Call instruction directly.
+    [[nodiscard]] auto invoke(const object_ptr<const Apply>& app) const
+    {
+      return m_instr->call(app);
+    }
+
+    /// Get instruction.
+    [[nodiscard]] auto instruction() const -> const bytecode_instruction&
+    {
+      return *m_instr;
+    }
+
+  private:
+    std::shared_ptr<const bytecode_instruction> m_instr;
+  };
+
+  /// Get register when object is Register which is not applied yet.
+  /// \returns nullptr when obj is not register.
+  template <class T>
+  [[nodiscard]] auto get_register(const object_ptr<T>& obj) noexcept
+    -> const Register*
+  {
+    auto& storage = _get_storage(obj);
+
+    if (!obj || !storage.template match_info_table_tag<Closure<>>())
+      return nullptr;
+
+    auto closure = reinterpret_cast<const Closure<>*>(storage.get());
+
+    if (
+      closure->get_info_table()->code != &detail::vtbl_code_func<Register>
+      || closure->is_pap())
+      return nullptr;
+
+    return static_cast<const Register*>(closure);
+  }
+
+  /// Bytecode program.
+  /// Linear sequence of instructions lowered from static part of apply graph.
+  /// Instructions are stored in evaluation order; operands of each
+  /// instruction appear before it.
+  class bytecode_program
+  {
+  public:
+    bytecode_program() = default;
+    bytecode_program(const bytecode_program&) = delete;
+    bytecode_program& operator=(const bytecode_program&) = delete;
+
+    ~bytecode_program() noexcept
+    {
+      // results in registers may reference instructions
+      clear();
+    }
+
+    /// Add instruction.
+    /// \returns register which refers the instruction
+    [[nodiscard]] auto add(const object_ptr<const Object>& obj)
+      -> object_ptr<const Register>
+    {
+      auto instr = std::make_shared<const bytecode_instruction>(obj);
+      m_code.push_back(instr);
+      return make_object<Register>(std::move(instr));
+    }
+
+    /// Discard results in all registers.
+    void clear() const noexcept
+    {
+      for (auto&& instr : m_code)
+        instr->clear();
+    }
+
+    /// Number of instructions.
+    [[nodiscard]] auto size() const noexcept -> size_t
+    {
+      return m_code.size();
+    }
+
+    /// Get instruction.
+    [[nodiscard]] auto operator[](size_t i) const -> const bytecode_instruction&
+    {
+      return *m_code[i];
+    }
+
+  private:
+    std::vector<std::shared_ptr<const bytecode_instruction>> m_code;
+  };
+
+} // namespace yave
@@ -0,0 +1,80 @@
+//
+// Copyright (c) 2019 mocabe (https://github.com/mocabe)
+// Distributed under LGPLv3 License. See LICENSE for more details.
+//
+
+#pragma once
+
+#include <yave/rts/result_error.hpp>
+
+#include <atomic>
+#include <memory>
+
+namespace yave {
+
+  namespace detail {
+    /// cancel flag of evaluation on current thread.
+    /// set by cancel_token::scope and task_pool.
+    inline thread_local const std::atomic<bool>* cancel_flag = nullptr;
+
+    /// Check cancel flag of current thread.
+    /// \throws result_error::cancelled when evaluation is cancelled.
+    inline void check_cancel()
+    {
+      if (cancel_flag && cancel_flag->load(std::memory_order_relaxed))
+        throw result_error::cancelled();
+    }
+  } // namespace detail
+
+  /// Cooperative cancellation of evaluation.
+  /// Evaluation checks token of current thread between reductions, and stops
+  /// by result_error::cancelled after cancel() is called. Copies of token
+  /// share the same state.
+  class cancel_token
+  {
+    std::shared_ptr<std::atomic<bool>> m_flag;
+
+  public:
+    /// Ctor
+    cancel_token()
+      : m_flag {std::make_shared<std::atomic<bool>>(false)}
+    {
+    }
+
+    /// Request cancellation. Can be called from any thread.
+    void cancel() const noexcept
+    {
+      m_flag->store(true, std::memory_order_relaxed);
+    }
+
+    /// Check if cancellation is requested.
+    [[nodiscard]] bool is_cancelled() const noexcept
+    {
+      return m_flag->load(std::memory_order_relaxed);
+    }
+
+    /// Check token while evaluating on current thread in this scope.
+    class scope
+    {
+      std::shared_ptr<std::atomic<bool>> m_flag;
+      const std::atomic<bool>* m_prev;
+
+    public:
+      scope(const cancel_token& token) noexcept
+        : m_flag {token.m_flag}
+        , m_prev {detail::cancel_flag}
+      {
+        detail::cancel_flag = m_flag.get();
+      }
+
+      ~scope() noexcept
+      {
+        detail::cancel_flag = m_prev;
+      }
+
+      scope(const scope&) = delete;
+      scope& operator=(const scope&) = delete;
+    };
+  };
+
+} // namespace yave
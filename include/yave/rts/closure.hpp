@@ -7,6 +7,31 @@
 
 #include <yave/rts/box.hpp>
 #include <yave/rts/apply.hpp>
+#include <yave/support/enum_flag.hpp>
+
+namespace yave {
+
+  // ------------------------------------------
+  // closure_attributes
+
+  /// Static attributes of closure code.
+  /// These are only hints for compiler analysis. Closures without attributes
+  /// are always handled conservatively.
+  enum class closure_attributes : uint64_t
+  {
+    /// no attribute
+    none = 0,
+    /// Result of code() only depends on its arguments, and code() has no
+    /// observable side effect.
+    pure = 1 << 0,
+    /// code() never inspects value of the last argument. It is only passed to
+    /// other closures as their last argument (e.g. frame demand).
+    forward_last_arg = 1 << 1,
+  };
+
+}
+
+YAVE_DECL_ENUM_FLAG(yave::closure_attributes);
 
 namespace yave {
 
@@ -38,6 +63,8 @@ namespace yave {
     const uint64_t n_args;
     /// vtable for code
     object_ptr<const Object> (*code)(const Closure<>*) noexcept;
+    /// attributes of code
+    const closure_attributes attributes;
   };
 
   // ------------------------------------------
@@ -66,6 +93,18 @@ namespace yave {
       return get_info_table()->n_args;
     }
 
+    /// Get attributes of code
+    [[nodiscard]] auto attributes() const noexcept
+    {
+      return get_info_table()->attributes;
+    }
+
+    /// Check if code has all of specified attributes
+    [[nodiscard]] bool has_attributes(closure_attributes attrs) const noexcept
+    {
+      return (attributes() & attrs) == attrs;
+    }
+
     /// PAP?
     [[nodiscard]] bool is_pap() const noexcept
     {
@@ -134,10 +173,12 @@ namespace yave {
       auto& app     = spine[N - Arg - 1];
       auto& storage = _get_storage(*app);
 
-      if (storage.is_result())
-        return storage.get_result();
-      else
+      // vertebrae can be evaluated by other threads while code is running,
+      // so prefer argument while it is kept.
+      if (storage.has_arg())
         return storage.arg();
+      else
+        return storage.get_result();
     }
   };
 }
\ No newline at end of file
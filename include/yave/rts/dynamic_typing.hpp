@@ -17,7 +17,9 @@
 #include <vector>
 #include <algorithm>
 #include <map>
+#include <unordered_map>
 #include <optional>
+#include <cstring>
 
 namespace yave {
 
@@ -101,6 +103,12 @@ namespace yave {
       auto* l = left.value();
       auto* r = right.value();
 
+      // interned types are equal only when they are identical
+      auto lid = _get_storage(*l).intern_id.load(std::memory_order_relaxed);
+      auto rid = _get_storage(*r).intern_id.load(std::memory_order_relaxed);
+      if (lid != 0 && lid == rid)
+        return false;
+
       if (_get_storage(*l).index != _get_storage(*r).index)
         return false;
 
@@ -130,6 +138,203 @@ namespace yave {
     return detail::same_type_impl(lhs, rhs);
   }
 
+  // ------------------------------------------
+  // type_interner
+
+  /// Hash-consing table of types.
+  /// Structurally equal types interned by the same interner share single
+  /// object, so same_type() can compare them by address. Interned objects are
+  /// kept alive until the interner is destroyed.
+  /// Type constructors in this file use interner installed on current thread.
+  class type_interner
+  {
+  public:
+    type_interner() noexcept
+      : m_id {next_id()}
+    {
+    }
+
+    type_interner(const type_interner&) = delete;
+    type_interner& operator=(const type_interner&) = delete;
+
+    /// Get interner installed on current thread.
+    /// \returns nullptr when no interner is installed.
+    [[nodiscard]] static auto current() noexcept -> type_interner*
+    {
+      return current_interner();
+    }
+
+    /// Install interner on current thread in this scope.
+    class scope
+    {
+      type_interner* m_prev;
+
+    public:
+      scope(type_interner& interner) noexcept
+        : m_prev {current_interner()}
+      {
+        current_interner() = &interner;
+      }
+
+      ~scope() noexcept
+      {
+        current_interner() = m_prev;
+      }
+
+      scope(const scope&) = delete;
+      scope& operator=(const scope&) = delete;
+    };
+
+    /// Get interned instance of type.
+    /// Objects of given type are reused when possible.
+    [[nodiscard]] auto intern(const object_ptr<const Type>& t)
+      -> object_ptr<const Type>
+    {
+      if (owns(t))
+        return t;
+
+      if (auto con = get_if<tcon_type>(t.value()))
+        return find_or_insert(*con, [&] { return t; });
+
+      if (auto var = get_if<tvar_type>(t.value()))
+        return find_or_insert(*var, [&] { return t; });
+
+      if (auto ap = get_if<tap_type>(t.value())) {
+        auto key = tap_type {intern(ap->t1), intern(ap->t2)};
+        return find_or_insert(key, [&] {
+          if (key.t1 == ap->t1 && key.t2 == ap->t2)
+            return t;
+          return object_ptr<const Type>(make_object<const Type>(key));
+        });
+      }
+
+      unreachable();
+    }
+
+    /// Get interned type application.
+    [[nodiscard]] auto tap(
+      const object_ptr<const Type>& t1,
+      const object_ptr<const Type>& t2) -> object_ptr<const Type>
+    {
+      auto key = tap_type {intern(t1), intern(t2)};
+      return find_or_insert(key, [&] {
+        return object_ptr<const Type>(make_object<const Type>(key));
+      });
+    }
+
+    /// Check if type is interned by this interner.
+    [[nodiscard]] bool owns(const object_ptr<const Type>& t) const noexcept
+    {
+      auto& storage = _get_storage(*t.value());
+      return storage.intern_id.load(std::memory_order_relaxed) == m_id;
+    }
+
+    /// Number of interned types.
+    [[nodiscard]] auto size() const noexcept -> size_t
+    {
+      return m_table.size();
+    }
+
+  private:
+    static auto current_interner() noexcept -> type_interner*&
+    {
+      thread_local type_interner* interner = nullptr;
+      return interner;
+    }
+
+    static auto next_id() noexcept -> uint64_t
+    {
+      static std::atomic<uint64_t> id = 0;
+      return ++id;
+    }
+
+    static auto hash(const tcon_type& con) noexcept -> size_t
+    {
+      uint64_t h;
+      std::memcpy(&h, con.id.data(), sizeof(h));
+      return h;
+    }
+
+    static auto hash(const tvar_type& var) noexcept -> size_t
+    {
+      return std::hash<uint64_t>()(var.id);
+    }
+
+    static auto hash(const tap_type& ap) noexcept -> size_t
+    {
+      auto h = std::hash<const void*>()(ap.t1.get());
+      h ^= std::hash<const void*>()(ap.t2.get()) + 0x9e3779b97f4a7c15
+           + (h << 6) + (h >> 2);
+      return h;
+    }
+
+    static bool equal(const object_ptr<const Type>& t, const tcon_type& con)
+    {
+      auto p = get_if<tcon_type>(t.value());
+      return p && detail::same_tcon(*p, con);
+    }
+
+    static bool equal(const object_ptr<const Type>& t, const tvar_type& var)
+    {
+      auto p = get_if<tvar_type>(t.value());
+      return p && detail::same_tvar(*p, var);
+    }
+
+    static bool equal(const object_ptr<const Type>& t, const tap_type& ap)
+    {
+      auto p = get_if<tap_type>(t.value());
+      return p && p->t1 == ap.t1 && p->t2 == ap.t2;
+    }
+
+    template <class T, class F>
+    auto find_or_insert(const T& key, F&& make) -> object_ptr<const Type>
+    {
+      auto h           = hash(key);
+      auto [beg, last] = m_table.equal_range(h);
+
+      for (auto it = beg; it != last; ++it) {
+        if (equal(it->second, key))
+          return it->second;
+      }
+
+      auto t = std::forward<F>(make)();
+      _get_storage(*t.value()).intern_id.store(m_id, std::memory_order_relaxed);
+      m_table.emplace(h, t);
+      return t;
+    }
+
+  private:
+    /// id of this interner
+    uint64_t m_id;
+    /// map of (shallow hash, type)
+    std::unordered_multimap<size_t, object_ptr<const Type>> m_table;
+  };
+
+  namespace detail {
+
+    /// make type application.
+    /// uses interner installed on current thread.
+    inline auto make_tap_type(
+      const object_ptr<const Type>& t1,
+      const object_ptr<const Type>& t2) -> object_ptr<const Type>
+    {
+      if (auto interner = type_interner::current())
+        return interner->tap(t1, t2);
+
+      return make_object<const Type>(tap_type {t1, t2});
+    }
+
+    /// intern type if interner is installed on current thread
+    inline auto intern_type(const object_ptr<const Type>& t)
+      -> object_ptr<const Type>
+    {
+      if (auto interner = type_interner::current())
+        return interner->intern(t);
+
+      return t;
+    }
+  } // namespace detail
+
   // ------------------------------------------
   // Utils
 
@@ -194,8 +399,8 @@ namespace yave {
     const object_ptr<const Type>& t1,
     const object_ptr<const Type>& t2)
   {
-    return make_object<const Type>(
-      tap_type {make_object<const Type>(tap_type {arrow_type_tcon(), t1}), t2});
+    return detail::make_tap_type(
+      detail::make_tap_type(arrow_type_tcon(), t1), t2);
   }
 
   [[nodiscard]] inline auto is_arrow_type(const object_ptr<const Type>& t)
@@ -212,7 +417,8 @@ namespace yave {
 
   [[nodiscard]] inline auto make_var_type(uint64_t id)
   {
-    return make_object<const Type>(tvar_type {id /* kstar */});
+    return detail::intern_type(
+      make_object<const Type>(tvar_type {id /* kstar */}));
   }
 
   // ------------------------------------------
@@ -221,7 +427,8 @@ namespace yave {
   /// generate new type variable
   [[nodiscard]] inline auto genvar() -> object_ptr<const Type>
   {
-    return make_object<const Type>(tvar_type::random_generate());
+    return detail::intern_type(
+      make_object<const Type>(tvar_type::random_generate()));
   }
 
   // ------------------------------------------
@@ -277,9 +484,9 @@ namespace yave {
       if (auto tap = is_tap_type_if(in)) {
         auto t1 = apply_type_arrow_impl_rec(ta, tap->t1);
         auto t2 = apply_type_arrow_impl_rec(ta, tap->t2);
-        return (!t1 && !t2) ? nullptr
-                            : make_object<Type>(
-                              tap_type {t1 ? t1 : tap->t1, t2 ? t2 : tap->t2});
+        return (!t1 && !t2)
+                 ? nullptr
+                 : make_tap_type(t1 ? t1 : tap->t1, t2 ? t2 : tap->t2);
       }
 
       if (same_type(in, ta.t1))
@@ -654,7 +861,7 @@ namespace yave {
           auto r1 = generalize_impl_rec(tap1->t1, tap2->t1, table);
           auto r2 = generalize_impl_rec(tap1->t2, tap2->t2, table);
           if (r1 && r2)
-            return make_object<Type>(tap_type {r1, r2});
+            return make_tap_type(r1, r2);
         }
       }
 
@@ -819,15 +1026,15 @@ namespace yave {
 
       // tap
       if (has_tap_type(obj))
-        return genpoly(get_type(obj), env);
+        return genpoly(intern_type(get_type(obj)), env);
 
       // tcon
       if (has_tcon_type(obj))
-        return get_type(obj);
+        return intern_type(get_type(obj));
 
       // tvar
       if (has_tvar_type(obj))
-        return get_type(obj);
+        return intern_type(get_type(obj));
 
       unreachable();
     }
@@ -839,6 +1046,10 @@ namespace yave {
   {
     type_arrow_map env; // type environment
 
+    // share structurally equal types while checking
+    auto interner = type_interner();
+    auto scope    = type_interner::scope(interner);
+
     auto ty = detail::type_of_impl(obj, env);
 
     // FIXME: Is subst_type_all(env, ty) necessary?
@@ -865,6 +1076,15 @@ namespace yave {
   {
     static_assert(std::is_same_v<std::decay_t<Type>, Tag>);
 
+    // immediate values only have scalar types
+    if (_get_storage(obj).is_immediate()) {
+      if constexpr (detail::is_immediate_box_v<const Type>)
+        return detail::match_immediate<typename Type::value_type>(
+          _get_storage(obj).bits());
+      else
+        return false;
+    }
+
     if constexpr (detail::has_info_table_tag<Type>())
       // optimize type check on certain types
       return likely(obj)
@@ -9,9 +9,19 @@
 #include <yave/rts/closure.hpp>
 #include <yave/rts/static_typing.hpp>
 #include <yave/rts/result_error.hpp>
+#include <yave/rts/cancel_token.hpp>
 #include <yave/rts/lambda.hpp>
+#include <yave/rts/task_pool.hpp>
 
+#include <algorithm>
 #include <map>
+#include <unordered_map>
+#include <optional>
+#include <tuple>
+#include <utility>
+#include <vector>
+#include <memory>
+#include <cstddef>
 
 namespace yave {
 
@@ -47,6 +57,19 @@ namespace yave {
           map.emplace(std::move(apply), new_app);
           return new_app;
         }
+
+        // subtrees of lambda body are shared between instances of the body,
+        // so copy them too.
+        if (auto lambda = value_cast_if<Lambda>(obj)) {
+
+          auto& lambda_storage = _get_storage(*lambda);
+
+          object_ptr<const Object> new_lam = make_object<Lambda>(
+            lambda_storage.var, rec(lambda_storage.body, map));
+
+          map.emplace(std::move(lambda), new_lam);
+          return new_lam;
+        }
         return obj;
       }
     } impl;
@@ -65,100 +88,476 @@ namespace yave {
     inline auto inspect_spine(const object_ptr<const Object>& obj)
       -> std::pair<size_t, object_ptr<const Object>>
     {
-      if (auto apply = value_cast_if<Apply>(obj)) {
+      size_t depth = 0;
+      auto* cur    = &obj;
+
+      object_ptr<const Object> result;
+
+      while (auto apply = value_cast_if<Apply>(*cur)) {
 
         auto& storage = _get_storage(*apply);
 
-        if (storage.is_result())
-          return inspect_spine(storage.get_result());
+        if (storage.is_result()) {
+          result = storage.get_result();
+          cur    = &result;
+          continue;
+        }
 
-        auto [depth, bottom] = inspect_spine(storage.app());
-        return {depth + 1, std::move(bottom)};
+        ++depth;
+        cur = &storage.app();
       }
-      return {0, obj};
+      return {depth, *cur};
     }
 
-    /// Assign each vertebrae to spine stack
-    /// \param obj apply tree
-    /// \param stack mutable ref to stack buffer
-    /// \param depth current depth of recursion
-    inline void assign_spine_stack(
-      const object_ptr<const Object>& obj,
-      std::vector<object_ptr<const Apply>>& stack,
-      const size_t& depth)
+    /// Spine stack with small buffer.
+    /// Vertebrae are stored from top of spine to bottom.
+    class spine_stack
     {
-      if (auto apply = value_cast_if<Apply>(obj)) {
+    public:
+      using value_type = object_ptr<const Apply>;
 
-        auto& storage = _get_storage(*apply);
+      /// size of local buffer
+      static constexpr size_t buffer_size = 16;
+
+      spine_stack() noexcept
+        : m_data {reinterpret_cast<value_type*>(m_buff)}
+      {
+      }
 
-        if (storage.is_result())
-          return assign_spine_stack(storage.get_result(), stack, depth);
+      ~spine_stack() noexcept
+      {
+        shrink(0);
+      }
 
-        assert(depth < stack.size());
-        stack[depth] = std::move(apply);
+      spine_stack(const spine_stack&) = delete;
+      spine_stack& operator=(const spine_stack&) = delete;
 
-        assign_spine_stack(storage.app(), stack, depth + 1);
+      [[nodiscard]] auto size() const noexcept
+      {
+        return m_size;
       }
-    }
 
-    /// Assign each vertebrae to local stack
-    /// \param obj apply tree
-    /// \param closure bottom closure
-    /// \param arity arity of bottom closure
-    /// \param size size of local stack of bottom closure
-    /// \param depth current depth of recursion
-    inline void assign_spine_stack_direct(
+      [[nodiscard]] auto& operator[](size_t i) noexcept
+      {
+        assert(i < m_size);
+        return m_data[i];
+      }
+
+      [[nodiscard]] auto& back() noexcept
+      {
+        assert(m_size != 0);
+        return m_data[m_size - 1];
+      }
+
+      void reserve(size_t n)
+      {
+        while (m_capacity < n)
+          grow();
+      }
+
+      void push_back(value_type v)
+      {
+        if (m_size == m_capacity)
+          grow();
+        new (m_data + m_size) value_type(std::move(v));
+        ++m_size;
+      }
+
+      void pop_back() noexcept
+      {
+        assert(m_size != 0);
+        m_data[--m_size].~value_type();
+      }
+
+      /// pop elements until size becomes n
+      void shrink(size_t n) noexcept
+      {
+        while (m_size > n)
+          pop_back();
+      }
+
+    private:
+      void grow()
+      {
+        auto cap  = m_capacity * 2;
+        auto heap = std::make_unique<std::byte[]>(sizeof(value_type) * cap);
+        auto data = reinterpret_cast<value_type*>(heap.get());
+
+        for (size_t i = 0; i < m_size; ++i) {
+          new (data + i) value_type(std::move(m_data[i]));
+          m_data[i].~value_type();
+        }
+
+        m_heap     = std::move(heap);
+        m_data     = data;
+        m_capacity = cap;
+      }
+
+    private:
+      alignas(value_type) std::byte m_buff[sizeof(value_type) * buffer_size];
+      std::unique_ptr<std::byte[]> m_heap;
+      value_type* m_data;
+      size_t m_size     = 0;
+      size_t m_capacity = buffer_size;
+    };
+
+    /// Push vertebrae of apply tree to spine stack.
+    /// \returns bottom of spine
+    inline auto push_spine(
       const object_ptr<const Object>& obj,
-      const object_ptr<Closure<>>& closure,
-      const size_t& arity,
-      const size_t& size,
-      const size_t& depth)
+      spine_stack& stack) -> object_ptr<const Object>
     {
-      if (auto apply = value_cast_if<Apply>(obj)) {
+      auto* cur = &obj;
 
-        auto& storage = _get_storage(*apply);
+      object_ptr<const Object> result;
 
-        if (storage.is_result())
-          return assign_spine_stack_direct(
-            storage.get_result(), closure, arity, size, depth);
+      while (auto apply = value_cast_if<Apply>(*cur)) {
 
-        assert(depth < size);
-        closure->vertebrae(arity - size + depth) = std::move(apply);
+        auto& storage = _get_storage(*apply);
 
-        assign_spine_stack_direct(
-          storage.app(), closure, arity, size, depth + 1);
+        if (storage.is_result()) {
+          result = storage.get_result();
+          cur    = &result;
+          continue;
+        }
+
+        cur = &storage.app();
+        stack.push_back(std::move(apply));
       }
+      return *cur;
     }
 
-    /// instantiate lambda body with actual argument
-    inline auto instantiate_lambda_body(
-      const object_ptr<const Object>& obj,
+    /// Number of lambda body plans built by current thread.
+    /// Only used for profiling.
+    inline thread_local uint64_t lambda_body_plans = 0;
+
+    /// operands of nodes in plan
+    using lambda_body_operand_map =
+      std::unordered_map<const Object*, lambda_body_plan::operand>;
+
+    /// build instantiation plan of lambda body
+    /// \param outer operands of enclosing plan when lambda is nested
+    inline auto make_lambda_body_plan(
       const object_ptr<const Variable>& var,
-      const object_ptr<const Object>& arg) -> object_ptr<const Object>
+      const object_ptr<const Object>& body,
+      const lambda_body_operand_map* outer = nullptr)
+      -> std::unique_ptr<lambda_body_plan>
     {
-      if (auto apply = value_cast_if<Apply>(obj)) {
-        auto& storage = _get_storage(*apply);
+      using operand      = lambda_body_plan::operand;
+      using operand_kind = lambda_body_plan::operand_kind;
+
+      ++lambda_body_plans;
+
+      auto plan = std::make_unique<lambda_body_plan>();
+      auto map  = lambda_body_operand_map();
+      auto id   = var->id();
+
+      // depends on variable of this lambda
+      auto is_local = [](const operand& op) {
+        return op.kind == operand_kind::arg || op.kind == operand_kind::node;
+      };
+
+      // subtree which does not depend on variable of this lambda
+      auto capture = [&](const object_ptr<const Object>& obj) -> operand {
+        if (outer) {
+          if (auto it = outer->find(obj.get()); it != outer->end()) {
+            auto& op = it->second;
+            if (op.kind != operand_kind::shared) {
+              auto& cs = plan->captures;
+              auto c   = std::find_if(cs.begin(), cs.end(), [&](auto& x) {
+                return x.kind == op.kind && x.index == op.index;
+              });
+              if (c == cs.end())
+                c = cs.insert(cs.end(), op);
+              return {operand_kind::env, size_t(c - cs.begin()), nullptr};
+            }
+          }
+        }
+        return {operand_kind::shared, 0, obj};
+      };
 
-        // assume result does not contain variable
-        if (storage.is_result())
-          return storage.get_result();
+      auto rec = [&](auto&& self, const object_ptr<const Object>& obj) {
+        if (auto it = map.find(obj.get()); it != map.end())
+          return it->second;
 
-        return make_object<Apply>(
-          instantiate_lambda_body(storage.app(), var, arg),
-          instantiate_lambda_body(storage.arg(), var, arg));
-      }
+        auto ret = std::optional<operand>();
 
-      if (auto lambda = value_cast_if<Lambda>(obj)) {
-        auto& storage = _get_storage(*lambda);
-        return make_object<Lambda>(
-          storage.var, instantiate_lambda_body(storage.body, var, arg));
+        if (auto apply = value_cast_if<Apply>(obj)) {
+          auto& storage = _get_storage(*apply);
+          // assume result does not contain variable
+          if (!storage.is_result()) {
+            auto app = self(self, storage.app());
+            auto arg = self(self, storage.arg());
+            if (is_local(app) || is_local(arg)) {
+              plan->nodes.push_back(
+                {nullptr, std::move(app), std::move(arg), nullptr});
+              ret = {operand_kind::node, plan->nodes.size() - 1, nullptr};
+            }
+          }
+        } else if (auto lambda = value_cast_if<Lambda>(obj)) {
+          auto& storage = _get_storage(*lambda);
+          // variable can be shadowed by nested lambda
+          if (storage.var->id() != id) {
+            auto body = self(self, storage.body);
+            if (is_local(body)) {
+              // plan of nested lambda refers operands of this plan
+              auto nested =
+                make_lambda_body_plan(storage.var, storage.body, &map);
+              plan->nodes.push_back(
+                {storage.var, std::move(body), {}, std::move(nested)});
+              ret = {operand_kind::node, plan->nodes.size() - 1, nullptr};
+            }
+          }
+        } else if (auto variable = value_cast_if<Variable>(obj)) {
+          if (variable->id() == id)
+            ret = {operand_kind::arg, 0, nullptr};
+        }
+
+        if (!ret)
+          ret = capture(obj);
+
+        map.emplace(obj.get(), *ret);
+        return *ret;
+      };
+
+      plan->root = rec(rec, body);
+      return plan;
+    }
+
+    /// get instantiation plan of lambda body
+    inline auto get_lambda_body_plan(const lambda_object_value_storage& lam)
+      -> const lambda_body_plan&
+    {
+      if (lam.nested_plan)
+        return *lam.nested_plan;
+
+      if (auto p = lam.plan.load(std::memory_order_acquire))
+        return *p;
+
+      auto plan = make_lambda_body_plan(lam.var, lam.body);
+
+      // other thread may have built plan concurrently
+      const lambda_body_plan* expected = nullptr;
+      if (!lam.plan.compare_exchange_strong(
+            expected, plan.get(), std::memory_order_acq_rel))
+        return *expected;
+
+      return *plan.release();
+    }
+
+    /// instantiate lambda body with actual argument.
+    /// Only nodes which depend on the variable are created, other subtrees
+    /// are shared between instances.
+    inline auto instantiate_lambda_body(
+      const lambda_object_value& lam,
+      const object_ptr<const Object>& arg) -> object_ptr<const Object>
+    {
+      using operand_kind = lambda_body_plan::operand_kind;
+
+      auto& storage = _get_storage(lam);
+      auto& plan    = get_lambda_body_plan(storage);
+
+      auto insts = std::vector<object_ptr<const Object>>();
+
+      auto get = [&](const auto& op) -> const object_ptr<const Object>& {
+        switch (op.kind) {
+          case operand_kind::arg:
+            return arg;
+          case operand_kind::node:
+            return insts[op.index];
+          case operand_kind::env:
+            return (*storage.env)[op.index];
+          default:
+            return op.obj;
+        }
+      };
+
+      if (plan.nodes.empty())
+        return get(plan.root);
+
+      insts.reserve(plan.nodes.size());
+
+      for (auto&& n : plan.nodes) {
+        if (n.var) {
+          // share plan of nested lambda, capturing values it refers
+          auto env = std::make_shared<std::vector<object_ptr<const Object>>>();
+          env->reserve(n.plan->captures.size());
+          for (auto&& c : n.plan->captures)
+            env->push_back(get(c));
+          insts.push_back(
+            make_object<Lambda>(n.var, get(n.fst), n.plan, std::move(env)));
+        } else
+          insts.push_back(make_object<Apply>(get(n.fst), get(n.snd)));
       }
 
-      if (auto variable = value_cast_if<Variable>(obj)) {
-        return (variable->id() == var->id()) ? arg : variable;
+      return get(plan.root);
+    }
+
+    /// Set by evaluator right before calling code of closure, to tell the
+    /// closure that it may return unevaluated tail call instead of evaluating
+    /// it on native stack. Cleared by callee on entry.
+    inline thread_local bool accept_tail_call = false;
+
+    /// Call code of saturated closure.
+    /// \returns result of code, or unevaluated apply node of tail call.
+    inline auto call_tail(const Closure<>* cfun) -> object_ptr<const Object>
+    {
+      accept_tail_call = true;
+      auto result      = cfun->call();
+      accept_tail_call = false;
+
+      // detect exception
+      if (auto e = value_cast_if<Exception>(result))
+        throw exception_result(e);
+
+      return result;
+    }
+
+    /// pending result of spine segment
+    struct spine_frame
+    {
+      /// vertebrae which receives result of segment
+      object_ptr<const Apply> vert;
+      /// base of suspended segment
+      size_t base;
+    };
+
+    /// Reduce spine on stack until no arguments left.
+    /// Spine is unwound on explicit stack, and lambda bodies and tail calls
+    /// are evaluated in the same loop. Native stack is only used by code of
+    /// closures.
+    /// \param stack spine stack
+    /// \param bottom bottom of spine
+    /// \param vert vertebrae which receives result, can be null
+    inline auto eval_spine_loop(
+      spine_stack& stack,
+      object_ptr<const Object> bottom,
+      object_ptr<const Apply> vert) -> object_ptr<const Object>
+    {
+      std::vector<spine_frame> frames;
+
+      // base of spine segment currently evaluating
+      size_t base = 0;
+
+      if (vert)
+        frames.push_back({std::move(vert), base});
+
+      for (;;) {
+
+        detail::check_cancel();
+
+        // no more arguments to apply
+        if (stack.size() == base) {
+
+          if (frames.empty())
+            return bottom;
+
+          // resume suspended segment with result
+          auto f = std::move(frames.back());
+          frames.pop_back();
+
+          assert(bottom);
+          assert(!has_type<Exception>(bottom));
+
+          // cache result
+          _get_storage(*f.vert).set_result(bottom);
+          base = f.base;
+          continue;
+        }
+
+        // Handle lambda application
+        if (auto lam = value_cast_if<Lambda>(bottom)) {
+          // arg vartebrae
+          auto arg = std::move(stack.back());
+          stack.pop_back();
+          // instantiate
+          auto inst = instantiate_lambda_body(*lam, _get_storage(*arg).arg());
+
+          // eval body of lambda on top of stack
+          frames.push_back({std::move(arg), base});
+          base   = stack.size();
+          bottom = push_spine(inst, stack);
+          continue;
+        }
+
+        assert(value_cast_if<Closure<>>(bottom));
+
+        // clone bottom closure
+        auto fun   = bottom.clone();
+        auto cfun  = reinterpret_cast<Closure<>*>(fun.get());
+        auto arity = cfun->arity;
+        auto size  = stack.size() - base;
+        auto asmin = std::min(arity, size);
+        auto top   = stack.size() - asmin;
+
+        // dump to local stack
+        for (size_t i = 0; i < asmin; ++i) {
+          cfun->vertebrae(arity - asmin + i) = std::move(stack[top + i]);
+        }
+        cfun->arity -= asmin;
+
+        // unwind stack consumed
+        stack.shrink(top);
+
+        // not enough arguments; return PAP
+        if (asmin != arity) {
+          bottom = std::move(fun);
+          continue;
+        }
+
+        // call code
+        auto result = call_tail(cfun);
+
+        // tail call: reduce it in this loop
+        if (auto tail = value_cast_if<Apply>(result)) {
+
+          auto top_vert = cfun->vertebrae(0);
+          fun           = nullptr;
+
+          // result is only observable when vertebrae is shared
+          if (top_vert.use_count() != 1) {
+            frames.push_back({std::move(top_vert), base});
+            base = stack.size();
+          }
+          bottom = push_spine(tail, stack);
+          continue;
+        }
+
+        // loop
+        bottom = std::move(result);
       }
+    }
 
-      return obj;
+    /// evaluete apply graph using spine stack.
+    /// \param apply top of spine
+    /// \param depth depth of spine
+    /// \param bottom bottom of spine
+    inline auto eval_spine_stack(
+      object_ptr<const Apply> apply,
+      size_t depth,
+      object_ptr<const Object> bottom) -> object_ptr<const Object>
+    {
+      spine_stack stack;
+
+      auto& apply_storage = _get_storage(*apply);
+
+      stack.reserve(depth);
+      stack.push_back(std::move(apply));
+      (void)push_spine(apply_storage.app(), stack);
+
+      return eval_spine_loop(stack, std::move(bottom), nullptr);
+    }
+
+    /// evaluate tail call returned from closure.
+    /// \param vert vertebrae which receives result
+    /// \param tail apply node of tail call
+    inline auto eval_tail_call(
+      object_ptr<const Apply> vert,
+      const object_ptr<const Apply>& tail) -> object_ptr<const Object>
+    {
+      spine_stack stack;
+      auto bottom = push_spine(tail, stack);
+      return eval_spine_loop(stack, std::move(bottom), std::move(vert));
     }
 
     /// evaluete apply graph
@@ -177,8 +576,7 @@ namespace yave {
         // inspect spine structure without allocation
         auto [depth, bottom] = inspect_spine(apply_storage.app());
 
-        // avoid allocation of stack buffer when spine stack can fit in local
-        // stack of closure.
+        // avoid spine stack when spine can fit in local stack of closure.
         if (auto closure = value_cast_if<Closure<>>(bottom)) {
 
           auto arity = closure->arity;
@@ -189,97 +587,46 @@ namespace yave {
             auto fun = closure.clone();
 
             // dump to local stack directly
-            assign_spine_stack_direct(apply_storage.app(), fun, arity, size, 1);
-            fun->vertebrae(arity - size) = std::move(apply);
-            fun->arity -= size;
+            auto idx  = arity - size + 1;
+            auto* cur = &apply_storage.app();
 
-            if (size != arity)
-              return fun;
+            object_ptr<const Object> cached;
 
-            auto result = fun->call();
+            while (auto vert = value_cast_if<Apply>(*cur)) {
 
-            if (auto e = value_cast_if<Exception>(std::move(result)))
-              throw exception_result(e);
+              auto& storage = _get_storage(*vert);
 
-            return result;
-          }
-        }
-
-        // build spine stack on heap.
-        // TODO: support allocating on stack when size of buffer is small
-        // enough, but more than local stack size.
-        auto stack = std::vector<object_ptr<const Apply>>(depth + 1);
-        assign_spine_stack(apply_storage.app(), stack, 1);
-        stack[0] = std::move(apply);
-
-        for (;;) {
-
-          // Handle lambda application
-          // TODO: optimization
-          if (auto lam = value_cast_if<Lambda>(bottom)) {
-            // arg vartebrae
-            auto& vert = _get_storage(*stack.back());
-            // instantiate
-            auto& lam_storage = _get_storage(*lam);
-            auto inst         = instantiate_lambda_body(
-              lam_storage.body, lam_storage.var, vert.arg());
-
-            // eval body of lambda
-            auto result = eval_obj(inst);
-
-            assert(result);
-            assert(!has_type<Exception>(result));
-
-            // cache result
-            vert.set_result(result);
-
-            if (stack.size() == 1)
-              return result;
-
-            stack.pop_back();
-            bottom = std::move(result);
-            continue;
-          }
+              if (storage.is_result()) {
+                cached = storage.get_result();
+                cur    = &cached;
+                continue;
+              }
 
-          assert(value_cast_if<Closure<>>(bottom));
+              cur                   = &storage.app();
+              fun->vertebrae(idx++) = std::move(vert);
+            }
+            assert(idx == arity);
 
-          // clone bottom closure
-          auto fun   = bottom.clone();
-          auto cfun  = reinterpret_cast<Closure<>*>(fun.get());
-          auto arity = cfun->arity;
-          auto size  = stack.size();
-
-          auto asmin     = std::min(arity, size);
-          auto base_iter = stack.end() - asmin;
+            fun->vertebrae(arity - size) = std::move(apply);
+            fun->arity -= size;
 
-          // dump to local stack
-          for (size_t i = 0; i < asmin; ++i) {
-            cfun->vertebrae(arity - asmin + i) = std::move(*(base_iter + i));
-          }
-          cfun->arity -= asmin;
+            if (size != arity)
+              return fun;
 
-          // not enough arguments; return PAP
-          if (asmin != arity)
-            return fun;
+            detail::check_cancel();
 
-          // call code
-          auto result = cfun->call();
+            auto result = call_tail(fun.get());
 
-          // detect exception
-          if (auto e = value_cast_if<Exception>(std::move(result)))
-            throw exception_result(e);
+            if (auto tail = value_cast_if<Apply>(result)) {
+              auto top_vert = fun->vertebrae(0);
+              fun           = nullptr;
+              return eval_tail_call(std::move(top_vert), tail);
+            }
 
-          // completed
-          if (stack.size() == arity)
             return result;
-
-          // unwind stack consumed
-          stack.erase(base_iter, stack.end());
-
-          // loop
-          bottom = std::move(result);
-          continue;
+          }
         }
+        return eval_spine_stack(std::move(apply), depth + 1, std::move(bottom));
       }
       return obj;
     }
@@ -334,4 +681,32 @@ namespace yave {
     return detail::eval_return<T>(std::move(result));
   }
 
+  /// evaluate objects in parallel.
+  /// falls back to sequential evaluation when task pool is not enabled on
+  /// current thread.
+  /// \returns tuple of results
+  template <class... Ts>
+  [[nodiscard]] auto eval_parallel(const object_ptr<Ts>&... objs)
+  {
+    using result_type = std::tuple<decltype(eval(objs))...>;
+
+    auto* pool = task_pool::current();
+
+    if (!pool || sizeof...(Ts) < 2)
+      return result_type {eval(objs)...};
+
+    auto args    = std::forward_as_tuple(objs...);
+    auto results = result_type();
+
+    [&]<size_t... Is>(std::index_sequence<Is...>)
+    {
+      pool->invoke([&] {
+        std::get<Is>(results) = eval(std::get<Is>(args));
+      }...);
+    }
+    (std::index_sequence_for<Ts...>());
+
+    return results;
+  }
+
 } // namespace yave
\ No newline at end of file
@@ -0,0 +1,340 @@
+//
+// Copyright (c) 2019 mocabe (https://github.com/mocabe)
+// Distributed under LGPLv3 License. See LICENSE for more details.
+//
+
+#pragma once
+
+#include <yave/rts/object.hpp>
+
+#include <memory_resource>
+#include <new>
+#include <atomic>
+#include <mutex>
+#include <vector>
+#include <cstddef>
+#include <cstdint>
+#include <algorithm>
+
+namespace yave {
+
+  /// Arena memory resource for short-lived objects created while evaluating
+  /// single frame.
+  ///
+  /// Each thread bump-allocates from its own block. Blocks count live
+  /// allocations and are recycled when all objects in them are freed, so
+  /// objects which escape from a frame (results, memoized values, cached
+  /// values in apply graph) stay valid and simply keep their block alive.
+  /// Deallocation can happen from any thread.
+  ///
+  /// Objects store pointer to their memory resource, so the arena is never
+  /// destroyed. Use instance() to get the global arena.
+  ///
+  /// Blocks allocated in confined scope are owned by the thread, and objects
+  /// in them use non-atomic reference counting. Objects become shared (use
+  /// atomic reference counting) when share() is called or the confined scope
+  /// exits, so objects must not be passed to other threads before that.
+  class frame_arena : public std::pmr::memory_resource
+  {
+  public:
+    /// Size of single block.
+    static constexpr size_t block_size = 64 * 1024;
+    /// Allocations larger than this go to upstream resource.
+    /// They have their own block header which is always shared.
+    static constexpr size_t max_alloc_size = block_size / 8;
+    /// Max number of free blocks to keep.
+    static constexpr size_t max_free_blocks = 64;
+
+  private:
+    /// block header
+    struct alignas(std::max_align_t) block
+    {
+      /// published allocations - deallocations
+      std::atomic<std::ptrdiff_t> live = 0;
+      /// objects in this block can be accessed from other threads
+      std::atomic<bool> shared = true;
+      /// thread which allocated confined objects in this block
+      std::atomic<const void*> owner = nullptr;
+    };
+
+    /// current block of thread
+    struct thread_block
+    {
+      frame_arena* arena = nullptr;
+      block* blk         = nullptr;
+      std::byte* cur     = nullptr;
+      std::byte* end     = nullptr;
+      /// number of allocations not published to block yet
+      std::ptrdiff_t n_alloc = 0;
+      /// allocate thread confined objects
+      bool confined = false;
+      /// blocks which are not shared yet
+      std::vector<block*> local;
+
+      ~thread_block() noexcept
+      {
+        if (arena) {
+          arena->share();
+          arena->retire(*this);
+        }
+      }
+    };
+
+  public:
+    /// Get global arena.
+    [[nodiscard]] static auto instance() -> frame_arena&
+    {
+      // never destroyed, see above
+      static auto* arena = [] {
+        auto p = new frame_arena();
+        s_confined_mr.store(p, std::memory_order_relaxed);
+        return p;
+      }();
+      return *arena;
+    }
+
+    /// Check if object is confined to current thread.
+    /// Confined objects seen from other threads are treated as shared.
+    /// \param obj root object header
+    [[nodiscard]] static bool is_confined(const Object* obj) noexcept
+    {
+      auto mr = s_confined_mr.load(std::memory_order_relaxed);
+      if (obj->memory_resource != mr)
+        return false;
+
+      auto b = block_of(obj);
+      return !b->shared.load(std::memory_order_relaxed)
+             && b->owner.load(std::memory_order_relaxed) == &current();
+    }
+
+    frame_arena(const frame_arena&) = delete;
+    frame_arena& operator=(const frame_arena&) = delete;
+
+    /// Install arena as object memory resource of current thread in this scope.
+    class scope
+    {
+      frame_arena& m_arena;
+      std::pmr::memory_resource* m_prev;
+      bool m_prev_confined;
+
+    public:
+      /// \param confined allocate thread confined objects. Confined objects
+      /// are shared when this scope exits.
+      scope(
+        frame_arena& arena = frame_arena::instance(),
+        bool confined      = false) noexcept
+        : m_arena {arena}
+        , m_prev {detail::installed_resource}
+        , m_prev_confined {current().confined}
+      {
+        detail::installed_resource = &arena;
+
+        if (confined && !m_prev_confined)
+          m_arena.retire(current());
+
+        current().confined = confined;
+      }
+
+      ~scope() noexcept
+      {
+        if (current().confined)
+          m_arena.share();
+
+        current().confined         = m_prev_confined;
+        detail::installed_resource = m_prev;
+      }
+
+      scope(const scope&) = delete;
+      scope& operator=(const scope&) = delete;
+    };
+
+    /// Make all objects allocated by current thread visible from other
+    /// threads.
+    void share() noexcept
+    {
+      auto& tb = current();
+
+      for (auto&& b : tb.local)
+        b->shared.store(true, std::memory_order_relaxed);
+
+      tb.local.clear();
+
+      // start new block for later allocations
+      if (tb.blk && tb.confined)
+        retire(tb);
+    }
+
+    /// Number of blocks allocated from upstream and not released yet.
+    [[nodiscard]] auto n_blocks() const noexcept -> size_t
+    {
+      return m_n_blocks.load(std::memory_order_relaxed);
+    }
+
+    /// Number of free blocks kept for reuse.
+    [[nodiscard]] auto n_free_blocks() -> size_t
+    {
+      auto lck = std::unique_lock(m_mtx);
+      return m_free.size();
+    }
+
+  private:
+    frame_arena() = default;
+
+    static bool is_large(size_t bytes, size_t alignment) noexcept
+    {
+      return bytes > max_alloc_size || alignment > alignof(std::max_align_t);
+    }
+
+    /// offset of large allocation from its header
+    static auto large_offset(size_t alignment) noexcept -> size_t
+    {
+      return std::max(sizeof(block), alignment);
+    }
+
+    static auto block_of(const void* p) noexcept -> block*
+    {
+      return reinterpret_cast<block*>(
+        reinterpret_cast<uintptr_t>(p) & ~uintptr_t(block_size - 1));
+    }
+
+    static auto current() noexcept -> thread_block&
+    {
+      thread_local thread_block tb;
+      return tb;
+    }
+
+    auto acquire() -> block*
+    {
+      {
+        auto lck = std::unique_lock(m_mtx);
+        if (!m_free.empty()) {
+          auto b = m_free.back();
+          m_free.pop_back();
+          return b;
+        }
+      }
+
+      auto p = ::operator new(block_size, std::align_val_t(block_size));
+      m_n_blocks.fetch_add(1, std::memory_order_relaxed);
+      return new (p) block();
+    }
+
+    void recycle(block* b) noexcept
+    {
+      // confined blocks are only freed by owner thread
+      if (!b->shared.load(std::memory_order_relaxed)) {
+        auto& local = current().local;
+        local.erase(std::remove(local.begin(), local.end(), b), local.end());
+        b->shared.store(true, std::memory_order_relaxed);
+      }
+
+      {
+        auto lck = std::unique_lock(m_mtx);
+        if (m_free.size() < max_free_blocks) {
+          try {
+            m_free.push_back(b);
+            return;
+          } catch (...) {
+          }
+        }
+      }
+
+      b->~block();
+      ::operator delete(b, block_size, std::align_val_t(block_size));
+      m_n_blocks.fetch_sub(1, std::memory_order_relaxed);
+    }
+
+    /// publish allocations of current block and release it
+    void retire(thread_block& tb) noexcept
+    {
+      if (!tb.blk)
+        return;
+
+      auto n = tb.n_alloc;
+      if (tb.blk->live.fetch_add(n, std::memory_order_acq_rel) + n == 0)
+        recycle(tb.blk);
+
+      tb.blk     = nullptr;
+      tb.cur     = nullptr;
+      tb.end     = nullptr;
+      tb.n_alloc = 0;
+    }
+
+    void* do_allocate(size_t bytes, size_t alignment) override
+    {
+      if (is_large(bytes, alignment)) {
+
+        // header should be found by block_of()
+        if (alignment >= block_size)
+          throw std::bad_alloc();
+
+        auto off = large_offset(alignment);
+        auto p   = m_upstream->allocate(off + bytes, block_size);
+        new (p) block();
+        return static_cast<std::byte*>(p) + off;
+      }
+
+      auto& tb = current();
+
+      auto size = (bytes + alignof(std::max_align_t) - 1)
+                  & ~(alignof(std::max_align_t) - 1);
+
+      if (!tb.blk || size_t(tb.end - tb.cur) < size) {
+        retire(tb);
+        auto b = acquire();
+
+        if (tb.confined) {
+          tb.local.push_back(b);
+          b->owner.store(&tb, std::memory_order_relaxed);
+          b->shared.store(false, std::memory_order_relaxed);
+        }
+
+        tb.arena = this;
+        tb.blk   = b;
+        tb.cur   = reinterpret_cast<std::byte*>(b) + sizeof(block);
+        tb.end   = reinterpret_cast<std::byte*>(b) + block_size;
+      }
+
+      auto p = tb.cur;
+      tb.cur += size;
+      ++tb.n_alloc;
+      return p;
+    }
+
+    void do_deallocate(void* p, size_t bytes, size_t alignment) override
+    {
+      if (is_large(bytes, alignment)) {
+        auto off = large_offset(alignment);
+        auto b   = block_of(p);
+        b->~block();
+        return m_upstream->deallocate(b, off + bytes, block_size);
+      }
+
+      auto b = block_of(p);
+
+      // live count reaches zero only after owner thread retired the block
+      if (b->live.fetch_sub(1, std::memory_order_acq_rel) == 1)
+        recycle(b);
+    }
+
+    bool do_is_equal(
+      const std::pmr::memory_resource& other) const noexcept override
+    {
+      return this == &other;
+    }
+
+  private:
+    /// global arena instance
+    static inline std::atomic<std::pmr::memory_resource*> s_confined_mr =
+      nullptr;
+
+  private:
+    std::pmr::memory_resource* m_upstream = std::pmr::new_delete_resource();
+    std::atomic<size_t> m_n_blocks        = 0;
+
+  private:
+    std::mutex m_mtx;
+    std::vector<block*> m_free;
+  };
+
+} // namespace yave
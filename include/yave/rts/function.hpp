@@ -27,6 +27,21 @@ namespace yave {
     // ------------------------------------------
     // vtbl_code_func
 
+    template <class M>
+    struct member_class;
+
+    template <class C, class M>
+    struct member_class<M C::*>
+    {
+      using type = C;
+    };
+
+    /// T overrides _cache()?
+    template <class T>
+    constexpr bool has_custom_cache = std::is_same_v<
+      typename member_class<decltype(&T::_cache)>::type,
+      T>;
+
     /// vtable function to call code()
     template <class T>
     auto vtbl_code_func(const Closure<>* _cthis) noexcept
@@ -34,6 +49,9 @@ namespace yave {
     {
       auto _this = static_cast<const T*>(_cthis);
 
+      // caller can evaluate tail call in its own loop
+      auto tail = std::exchange(accept_tail_call, false);
+
       try {
 
         // code()
@@ -45,6 +63,13 @@ namespace yave {
         if (unlikely(has_type<Exception>(code_result)))
           return code_result;
 
+        // Return tail call to caller, which caches result instead of us.
+        // Recursion through tail calls does not consume native stack.
+        if constexpr (!has_custom_cache<T>) {
+          if (tail && value_cast_if<Apply>(code_result))
+            return code_result;
+        }
+
         // TODO: Since we know return type at compile time, we can directly
         // convert applications into PAP without loop by analyzing TApply
         // tree. Same on other return types; we can bypass some of runtime
@@ -76,6 +101,8 @@ namespace yave {
         /* result error */
       } catch (const result_error::null_result& e) {
         return make_exception(e);
+      } catch (const result_error::cancelled& e) {
+        return make_exception(e);
       } catch (const result_error::result_error& e) {
         return make_exception(e);
 
@@ -240,7 +267,17 @@ namespace yave {
       return eval(this->template arg<N>());
     }
 
+    /// evaluate arguments in parallel and take results
+    template <uint64_t... Ns>
+    [[nodiscard]] auto eval_args() const
+    {
+      return eval_parallel(this->template arg<Ns>()...);
+    }
+
   public: /* customization points */
+    /// default closure attributes.
+    static constexpr closure_attributes _attributes = closure_attributes::none;
+
     /// default self-update function.
     void _cache(const object_ptr<const Object>& result) const noexcept
     {
@@ -280,7 +317,8 @@ namespace yave {
          detail::vtbl_destroy_func<T>,                  //
          detail::vtbl_clone_func<T>},                   //
         sizeof...(Ts) - 1,                              //
-        detail::vtbl_code_func<T>};                     //
+        detail::vtbl_code_func<T>,                      //
+        T::_attributes};                                //
     };
   };
 
@@ -0,0 +1,81 @@
+//
+// Copyright (c) 2019 mocabe (https://github.com/mocabe)
+// Distributed under LGPLv3 License. See LICENSE for more details.
+//
+
+#pragma once
+
+#include <yave/rts/box.hpp>
+
+namespace yave {
+
+  namespace detail {
+
+    /// immediate values are not reference counted
+    inline void vtbl_immediate_destroy_func(const Object*) noexcept
+    {
+    }
+
+    /// clone immediate value into heap-allocated object
+    template <class T>
+    auto vtbl_immediate_clone_func(const Object* obj) noexcept -> Object*
+    {
+      try {
+        using value_type = typename T::value_type;
+        return object_new<T>(
+          object_resource(std::pmr::get_default_resource()),
+          decode_immediate<value_type>(std::bit_cast<uintptr_t>(obj)));
+      } catch (...) {
+        return nullptr;
+      }
+    }
+
+    /// info table of immediate value
+    template <class T>
+    inline const object_info_table immediate_info_table = {
+      object_type<T>(),
+      sizeof(T),
+      object_type_traits<T>::name,
+      vtbl_immediate_destroy_func,
+      vtbl_immediate_clone_func<T>};
+
+    /// register info table of immediate value type T
+    template <class T>
+    void register_immediate_info_table() noexcept
+    {
+      using value_type = typename T::value_type;
+
+      for (uintptr_t tag = 1; tag < 8; ++tag)
+        if (match_immediate<value_type>(tag))
+          immediate_info_tables[tag] = &immediate_info_table<T>;
+    }
+
+  } // namespace detail
+
+  /// Check if T can be stored as immediate value.
+  template <class T>
+  inline constexpr bool is_immediate_type_v =
+    detail::is_immediate_box_v<const T>;
+
+  /// Make object which does not require heap allocation when possible.
+  /// Small integers, doubles in common range and bools are stored in
+  /// object_ptr itself. Other values are allocated as normal objects.
+  /// \requires T is Box<int64_t>, Box<double> or Box<bool>.
+  template <class T>
+  [[nodiscard]] auto make_immediate(const typename T::value_type& value)
+    -> object_ptr<const T>
+  {
+    static_assert(is_immediate_type_v<T>, "T is not immediate type");
+
+    [[maybe_unused]] static const auto init = [] {
+      detail::register_immediate_info_table<T>();
+      return true;
+    }();
+
+    if (auto bits = detail::encode_immediate(value); likely(bits))
+      return reinterpret_cast<const T*>(bits);
+
+    return make_object<T>(value);
+  }
+
+} // namespace yave
@@ -8,6 +8,10 @@
 #include <yave/rts/box.hpp>
 #include <yave/support/id.hpp>
 
+#include <atomic>
+#include <memory>
+#include <vector>
+
 namespace yave {
 
   // ------------------------------------------
@@ -48,12 +52,104 @@ namespace yave {
   // ------------------------------------------
   // Lambda
 
+  /// Instantiation plan of lambda body.
+  /// Lists nodes of body which depend on variable of lambda in post order.
+  /// Other subtrees are shared between all instances of the body.
+  /// Plans of nested lambdas are built with plan of enclosing lambda, and
+  /// shared by all of their instances.
+  struct lambda_body_plan
+  {
+    /// kind of operand
+    enum class operand_kind : uint8_t
+    {
+      shared, ///< subtree which does not contain variable
+      arg,    ///< variable of lambda
+      node,   ///< instance of node in plan
+      env,    ///< value captured from instance of enclosing lambda
+    };
+
+    /// operand of node
+    struct operand
+    {
+      operand_kind kind;
+      /// index of node
+      size_t index;
+      /// shared subtree
+      object_ptr<const Object> obj;
+    };
+
+    /// node to instantiate
+    struct node
+    {
+      /// variable of nested lambda, null for apply
+      object_ptr<const Variable> var;
+      /// closure of apply, or body of lambda
+      operand fst;
+      /// argument of apply
+      operand snd;
+      /// plan of nested lambda
+      std::shared_ptr<const lambda_body_plan> plan;
+    };
+
+    /// nodes in post order
+    std::vector<node> nodes;
+    /// instance of body
+    operand root;
+    /// operands of enclosing plan captured by instances of nested lambda
+    std::vector<operand> captures;
+  };
+
   struct lambda_object_value_storage
   {
     /// pointer to variable object
     object_ptr<const Variable> var;
     /// pointer to body of lambda
     object_ptr<const Object> body;
+    /// instantiation plan of body, built on first application
+    mutable std::atomic<const lambda_body_plan*> plan = nullptr;
+    /// plan of nested lambda, when instantiated from enclosing lambda
+    std::shared_ptr<const lambda_body_plan> nested_plan;
+    /// values captured from instance of enclosing lambda
+    std::shared_ptr<const std::vector<object_ptr<const Object>>> env;
+
+    lambda_object_value_storage() noexcept = default;
+
+    lambda_object_value_storage(
+      object_ptr<const Variable> v,
+      object_ptr<const Object> b) noexcept
+      : var {std::move(v)}
+      , body {std::move(b)}
+    {
+    }
+
+    lambda_object_value_storage(
+      object_ptr<const Variable> v,
+      object_ptr<const Object> b,
+      std::shared_ptr<const lambda_body_plan> p,
+      std::shared_ptr<const std::vector<object_ptr<const Object>>> e) noexcept
+      : var {std::move(v)}
+      , body {std::move(b)}
+      , nested_plan {std::move(p)}
+      , env {std::move(e)}
+    {
+    }
+
+    lambda_object_value_storage(
+      const lambda_object_value_storage& other) noexcept
+      : var {other.var}
+      , body {other.body}
+      , nested_plan {other.nested_plan}
+      , env {other.env}
+    {
+    }
+
+    ~lambda_object_value_storage() noexcept
+    {
+      delete plan.load(std::memory_order_acquire);
+    }
+
+    lambda_object_value_storage& operator=(
+      const lambda_object_value_storage&) = delete;
   };
 
   /// value of Lambda
@@ -84,6 +180,20 @@ namespace yave {
     {
     }
 
+    /// instance of nested lambda
+    lambda_object_value(
+      object_ptr<const Variable> var,
+      object_ptr<const Object> body,
+      std::shared_ptr<const lambda_body_plan> plan,
+      std::shared_ptr<const std::vector<object_ptr<const Object>>> env) noexcept
+      : m_storage {
+        std::move(var),
+        std::move(body),
+        std::move(plan),
+        std::move(env)}
+    {
+    }
+
   private:
     lambda_object_value_storage m_storage;
   };
@@ -119,6 +119,23 @@ namespace yave {
 
   namespace detail {
 
+    /// Memory resource installed on current thread.
+    /// When set, new objects and clones are allocated from it.
+    inline thread_local std::pmr::memory_resource* installed_resource = nullptr;
+
+    /// Get memory resource for new objects.
+    /// \param fallback resource to use when nothing is installed
+    [[nodiscard]] inline auto object_resource(
+      std::pmr::memory_resource* fallback) noexcept
+      -> std::pmr::memory_resource*
+    {
+      return installed_resource ? installed_resource : fallback;
+    }
+
+    /// Number of objects allocated by current thread.
+    /// Only used for profiling.
+    inline thread_local uint64_t object_allocations = 0;
+
     /// Construct new object from arguments, with its memory allocated from
     /// memory_resource.
     template <class T, class... Args>
@@ -127,6 +144,7 @@ namespace yave {
       using newT = std::remove_const_t<T>;
       auto p     = new (sizeof(T), mr) newT(std::forward<Args>(args)...);
       p->memory_resource = mr;
+      ++object_allocations;
       return p;
     }
 
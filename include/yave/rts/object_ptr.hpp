@@ -15,6 +15,29 @@ namespace yave {
   [[nodiscard]] auto static_object_cast(object_ptr<U>&& o) noexcept
     -> object_ptr<T>;
 
+  // fwd
+  template <class T>
+  struct Box;
+
+  namespace detail {
+
+    /// Box types which can be stored as immediate value in object_ptr
+    template <class T>
+    struct is_immediate_box : std::false_type
+    {
+    };
+
+    template <class T>
+    struct is_immediate_box<const Box<T>>
+      : std::bool_constant<is_immediate_value_type<T>()>
+    {
+    };
+
+    template <class T>
+    inline constexpr bool is_immediate_box_v = is_immediate_box<T>::value;
+
+  } // namespace detail
+
   // ------------------------------------------
   // object_ptr
 
@@ -97,7 +120,7 @@ namespace yave {
     /// \requires not null.
     [[nodiscard]] auto* value() const noexcept
     {
-      assert(get());
+      assert(get() && !m_storage.is_immediate());
       return &get()->value();
     }
 
@@ -170,13 +193,21 @@ namespace yave {
     }
 
     /// operator*
-    [[nodiscard]] auto& operator*() const noexcept
+    /// \notes returns copy of value for types which can be immediate value.
+    [[nodiscard]] decltype(auto) operator*() const noexcept
     {
-      return *value();
+      if constexpr (detail::is_immediate_box_v<T>) {
+        using value_type = typename T::value_type;
+        if (m_storage.is_immediate())
+          return m_storage.template immediate_value<value_type>();
+        return value_type(*value());
+      } else
+        return *value();
     }
 
     /// operator->
     [[nodiscard]] auto* operator-> () const noexcept
+      requires(!detail::is_immediate_box_v<T>)
     {
       return value();
     }
@@ -236,9 +267,13 @@ namespace yave {
   inline void object_ptr_storage::decrement_refcount() const noexcept
   {
     if (likely(get() && !is_static())) {
-      if (root_head()->refcount.fetch_sub() == 1) {
+      auto head = root_head();
+      if (frame_arena::is_confined(head)) {
+        if (head->refcount.fetch_sub_local() == 1)
+          root_info_table()->destroy(get());
+      } else if (head->refcount.fetch_sub() == 1) {
         // use load as fence
-        (void)root_head()->refcount.load_acquire();
+        (void)head->refcount.load_acquire();
         root_info_table()->destroy(get());
       }
     }
@@ -454,11 +489,13 @@ namespace yave {
   }
 
   /// make object with default allocator
+  /// Uses memory resource installed on current thread if any.
   template <class T, class... Args>
   [[nodiscard]] auto make_object(Args&&... args)
   {
     return make_object<T>(
-      std::pmr::get_default_resource(), std::forward<Args>(args)...);
+      detail::object_resource(std::pmr::get_default_resource()),
+      std::forward<Args>(args)...);
   }
 
 } // namespace yave
\ No newline at end of file
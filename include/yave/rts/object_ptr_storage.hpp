@@ -7,13 +7,119 @@
 
 #include <yave/rts/object.hpp>
 #include <yave/rts/info_table_tags.hpp>
+#include <yave/rts/frame_arena.hpp>
 
 #include <cstring>
+#include <bit>
 
 namespace yave {
 
   struct object_info_table; // defined in object_ptr.hpp
 
+  namespace detail {
+
+    // Object pointer tags.
+    // Uses lowest 3 bits of object pointer. Heap objects are aligned to at
+    // least 8 bytes, so other bit patterns are used to store small scalar
+    // values in pointer itself (immediate values).
+    enum class object_ptr_tags : uintptr_t
+    {
+      // h <---------------------> l
+      //                       |<->|
+      //                       tag (3bit)
+      pointer      = 0, // ...000 : pointer to heap object
+      integer      = 1, // ....x1 : 63bit signed integer
+      floating     = 2, // ...x10 : rotated double (see encode_immediate)
+      boolean      = 4, // ...100 : bool
+      extract_mask = 0x0000000000000007,
+    };
+
+    /// Info tables of immediate values, indexed by lowest 3 bits of pointer.
+    /// Registered by make_immediate() (see immediate.hpp) before first
+    /// immediate value of each type is created.
+    inline const object_info_table* immediate_info_tables[8] = {};
+
+    /// \returns 0 when value can not be immediate value
+    [[nodiscard]] constexpr auto encode_immediate(int64_t v) noexcept
+      -> uintptr_t
+    {
+      constexpr auto max = int64_t(1) << 62;
+
+      if (v < -max || max <= v)
+        return 0;
+
+      return (static_cast<uintptr_t>(v) << 1)
+             | static_cast<uintptr_t>(object_ptr_tags::integer);
+    }
+
+    /// \returns 0 when value can not be immediate value
+    [[nodiscard]] constexpr auto encode_immediate(double v) noexcept
+      -> uintptr_t
+    {
+      // Doubles with exponent in range around 1 are stored by rotating sign
+      // and top 2 bits of exponent into tag bits. Those 2 bits are either 01
+      // or 10, so it can be recovered from the next bit.
+      auto bits = std::bit_cast<uint64_t>(v);
+      auto exp  = (bits >> 60) & 7;
+
+      // 0x3000000000000000 is used by +0.0 after rotation
+      if (bits != 0x3000000000000000 && (exp == 3 || exp == 4))
+        return (std::rotl(bits, 3) & ~uintptr_t(1))
+               | static_cast<uintptr_t>(object_ptr_tags::floating);
+
+      if (bits == 0)
+        return 0x8000000000000002;
+
+      return 0;
+    }
+
+    /// \returns 0 when value can not be immediate value
+    [[nodiscard]] constexpr auto encode_immediate(bool v) noexcept
+      -> uintptr_t
+    {
+      return (static_cast<uintptr_t>(v) << 3)
+             | static_cast<uintptr_t>(object_ptr_tags::boolean);
+    }
+
+    /// decode immediate value of type T
+    template <class T>
+    [[nodiscard]] constexpr auto decode_immediate(uintptr_t bits) noexcept
+      -> T
+    {
+      if constexpr (std::is_same_v<T, int64_t>) {
+        return static_cast<int64_t>(bits) >> 1;
+      } else if constexpr (std::is_same_v<T, double>) {
+        if (bits == 0x8000000000000002)
+          return 0.0;
+        auto e = uintptr_t(2) - (bits >> 63);
+        return std::bit_cast<double>(std::rotr((bits & ~uintptr_t(3)) | e, 3));
+      } else {
+        static_assert(std::is_same_v<T, bool>);
+        return static_cast<bool>(bits >> 3);
+      }
+    }
+
+    /// check if T is value type of immediate values
+    template <class T>
+    [[nodiscard]] constexpr bool is_immediate_value_type() noexcept
+    {
+      return std::is_same_v<T, int64_t> || std::is_same_v<T, double>
+             || std::is_same_v<T, bool>;
+    }
+
+    /// check if bits represent immediate value of type T
+    template <class T>
+    [[nodiscard]] constexpr bool match_immediate(uintptr_t bits) noexcept
+    {
+      if constexpr (std::is_same_v<T, int64_t>)
+        return bits & 1;
+      else if constexpr (std::is_same_v<T, double>)
+        return (bits & 3) == 2;
+      else
+        return (bits & 7) == 4;
+    }
+  } // namespace detail
+
   /// internal storage of object_ptr
   struct object_ptr_storage
   {
@@ -23,17 +129,29 @@ namespace yave {
       return m_ptr;
     }
 
+    /// get raw bits of pointer
+    [[nodiscard]] auto bits() const noexcept -> uintptr_t
+    {
+      return std::bit_cast<uintptr_t>(m_ptr);
+    }
+
+    /// immediate value?
+    [[nodiscard]] bool is_immediate() const noexcept
+    {
+      return bits() & static_cast<uintptr_t>(detail::object_ptr_tags::extract_mask);
+    }
+
     /// get address of header of this object.
     [[nodiscard]] auto this_head() const noexcept -> const Object*
     {
-      assert(get());
+      assert(get() && !is_immediate());
       return get();
     }
 
     /// get address of heaedr of root object.
     [[nodiscard]] auto root_head() const noexcept -> const Object*
     {
-      assert(get());
+      assert(get() && !is_immediate());
       auto* this_ptr = get();
       auto* root_ptr =
         (const Object*)(((const char*)this_ptr) - this_ptr->offset);
@@ -45,6 +163,10 @@ namespace yave {
       -> const object_info_table*
     {
       assert(get());
+
+      if (unlikely(is_immediate()))
+        return detail::immediate_info_tables[bits() & 7];
+
       return detail::clear_info_table_tag(this_head()->info_table);
     }
 
@@ -53,6 +175,10 @@ namespace yave {
       -> const object_info_table*
     {
       assert(get());
+
+      if (unlikely(is_immediate()))
+        return detail::immediate_info_tables[bits() & 7];
+
       return detail::clear_info_table_tag(root_head()->info_table);
     }
 
@@ -60,14 +186,27 @@ namespace yave {
     template <class T>
     [[nodiscard]] bool match_info_table_tag() const noexcept
     {
-      return detail::check_info_table_tag(
-        this_head()->info_table, detail::get_info_table_tag<T>());
+      // immediate values do not have tagged types
+      return !is_immediate()
+             && detail::check_info_table_tag(
+               this_head()->info_table, detail::get_info_table_tag<T>());
+    }
+
+    /// get immediate value
+    template <class T>
+    [[nodiscard]] auto immediate_value() const noexcept -> T
+    {
+      assert(detail::match_immediate<T>(bits()));
+      return detail::decode_immediate<T>(bits());
     }
 
     /// static?
     [[nodiscard]] bool is_static() const noexcept
     {
       assert(get());
+      // immediate values are not reference counted
+      if (is_immediate())
+        return true;
       // inherit from root object
       return root_head()->refcount.load_relaxed() == 0;
     }
@@ -76,14 +215,21 @@ namespace yave {
     [[nodiscard]] auto use_count() const noexcept -> uint64_t
     {
       assert(get());
+      if (is_immediate())
+        return 0;
       return root_head()->refcount.load_relaxed();
     }
 
     /// increment refcount (mutable)
     void increment_refcount() const noexcept
     {
-      if (likely(get() && !is_static()))
-        root_head()->refcount.fetch_add();
+      if (likely(get() && !is_static())) {
+        auto head = root_head();
+        if (frame_arena::is_confined(head))
+          head->refcount.fetch_add_local();
+        else
+          head->refcount.fetch_add();
+      }
     }
 
     /// decrement refcount (mutable)
@@ -112,6 +258,16 @@ namespace yave {
       return ref.exchange(ptr, ord);
     }
 
+    /// atomic compare exchange with memory order
+    [[nodiscard]] bool atomic_compare_exchange(
+      const Object*& expected,
+      const Object* desired,
+      std::memory_order ord) const noexcept
+    {
+      const auto ref = std::atomic_ref(const_cast<const Object*&>(m_ptr));
+      return ref.compare_exchange_strong(expected, desired, ord);
+    }
+
   public:
     /// Ctor
     template <class T>
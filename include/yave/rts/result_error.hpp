@@ -17,6 +17,7 @@ namespace yave {
     unknown     = 0,
     null_result = 1, // return value is null
     stdexcept   = 2, // detected std::exception
+    cancelled   = 3, // evaluation was cancelled
   };
 
   struct result_error_object_value
@@ -51,6 +52,16 @@ namespace yave {
       }
     };
 
+    /// evaluation was cancelled by cancel_token
+    class cancelled : public result_error
+    {
+    public:
+      cancelled()
+        : result_error(u8"Evaluation cancelled")
+      {
+      }
+    };
+
   } // namespace result_error
 
   [[nodiscard]] inline auto make_exception(const result_error::result_error& e)
@@ -67,6 +78,13 @@ namespace yave {
       e.what(), make_object<ResultError>(result_error_type::null_result));
   }
 
+  [[nodiscard]] inline auto make_exception(const result_error::cancelled& e)
+    -> object_ptr<Exception>
+  {
+    return make_object<Exception>(
+      e.what(), make_object<ResultError>(result_error_type::cancelled));
+  }
+
   // ------------------------------------------
   // Exception result
 
@@ -6,6 +6,7 @@
 #pragma once
 
 #include <yave/rts/box.hpp>
+#include <yave/rts/immediate.hpp>
 #include <yave/rts/function.hpp>
 #include <yave/rts/eval.hpp>
 #include <yave/rts/list.hpp>
@@ -0,0 +1,300 @@
+//
+// Copyright (c) 2019 mocabe (https://github.com/mocabe)
+// Distributed under LGPLv3 License. See LICENSE for more details.
+//
+
+#pragma once
+
+#include <yave/rts/apply.hpp>
+#include <yave/rts/cancel_token.hpp>
+
+#include <thread>
+#include <mutex>
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <vector>
+#include <functional>
+#include <exception>
+#include <memory>
+
+namespace yave {
+
+  /// Work-stealing thread pool for parallel evaluation.
+  /// Each worker pushes and pops tasks from back of its own queue, and steals
+  /// tasks from front of other worker's queue when it runs out of tasks.
+  class task_pool
+  {
+    /// task
+    struct task
+    {
+      std::function<void()> func   = {};
+      std::exception_ptr exception = {};
+      std::atomic<bool> done       = false;
+      /// object memory resource of parent thread
+      std::pmr::memory_resource* resource = nullptr;
+      /// cancel flag of parent thread
+      const std::atomic<bool>* cancel = nullptr;
+    };
+
+    /// task queue of each worker
+    struct worker_queue
+    {
+      std::mutex mtx;
+      std::deque<task*> tasks;
+    };
+
+  public:
+    /// Ctor
+    /// \param n_workers number of worker threads
+    explicit task_pool(size_t n_workers = default_worker_count())
+    {
+      // slot for external threads
+      m_queues.push_back(std::make_unique<worker_queue>());
+
+      for (size_t i = 0; i < n_workers; ++i)
+        m_queues.push_back(std::make_unique<worker_queue>());
+
+      for (size_t i = 0; i < n_workers; ++i)
+        m_workers.emplace_back([this, i] { worker_loop(i + 1); });
+    }
+
+    /// Dtor
+    ~task_pool() noexcept
+    {
+      {
+        auto lck = std::unique_lock(m_mtx);
+        m_terminate = true;
+      }
+      m_cond.notify_all();
+
+      for (auto&& w : m_workers)
+        w.join();
+    }
+
+    task_pool(const task_pool&) = delete;
+    task_pool& operator=(const task_pool&) = delete;
+
+    /// Number of worker threads
+    [[nodiscard]] auto size() const noexcept
+    {
+      return m_workers.size();
+    }
+
+    /// Default number of worker threads
+    [[nodiscard]] static auto default_worker_count() noexcept -> size_t
+    {
+      auto n = std::thread::hardware_concurrency();
+      return n > 1 ? n - 1 : 1;
+    }
+
+    /// Get task pool enabled on current thread.
+    /// \returns nullptr when parallel evaluation is disabled.
+    [[nodiscard]] static auto current() noexcept -> task_pool*
+    {
+      return current_pool();
+    }
+
+    /// Enable parallel evaluation on current thread in this scope.
+    class scope
+    {
+      task_pool* m_prev;
+      bool m_prev_concurrent;
+
+    public:
+      scope(task_pool& pool) noexcept
+        : m_prev {current_pool()}
+        , m_prev_concurrent {detail::concurrent_eval}
+      {
+        current_pool()         = &pool;
+        detail::concurrent_eval = true;
+      }
+
+      ~scope() noexcept
+      {
+        current_pool()         = m_prev;
+        detail::concurrent_eval = m_prev_concurrent;
+      }
+
+      scope(const scope&) = delete;
+      scope& operator=(const scope&) = delete;
+    };
+
+    /// Invoke functions in parallel and wait for all of them.
+    /// First function is executed on current thread. Current thread executes
+    /// other tasks while waiting.
+    /// \throws first exception thrown from functions.
+    template <class F, class... Fs>
+    void invoke(F&& f, Fs&&... fs)
+    {
+      if constexpr (sizeof...(Fs) == 0) {
+        std::forward<F>(f)();
+      } else {
+        task tasks[sizeof...(Fs)];
+        {
+          auto* t = tasks;
+          ((t++->func = std::forward<Fs>(fs)), ...);
+        }
+
+        for (auto&& t : tasks)
+          push(&t);
+
+        std::exception_ptr exception;
+
+        try {
+          std::forward<F>(f)();
+        } catch (...) {
+          exception = std::current_exception();
+        }
+
+        for (auto&& t : tasks)
+          wait(&t);
+
+        if (!exception) {
+          for (auto&& t : tasks) {
+            if (t.exception) {
+              exception = t.exception;
+              break;
+            }
+          }
+        }
+
+        if (exception)
+          std::rethrow_exception(exception);
+      }
+    }
+
+  private:
+    static auto current_pool() noexcept -> task_pool*&
+    {
+      thread_local task_pool* pool = nullptr;
+      return pool;
+    }
+
+    /// index of queue owned by current thread
+    static auto current_index() noexcept -> size_t&
+    {
+      thread_local size_t index = 0;
+      return index;
+    }
+
+    auto own_queue() -> worker_queue&
+    {
+      // external threads share the first queue
+      return current_pool() == this ? *m_queues[current_index()]
+                                    : *m_queues[0];
+    }
+
+    void push(task* t)
+    {
+      t->resource = detail::installed_resource;
+      t->cancel   = detail::cancel_flag;
+      {
+        auto lck = std::unique_lock(m_mtx);
+        ++m_pending;
+      }
+      {
+        auto& q  = own_queue();
+        auto lck = std::unique_lock(q.mtx);
+        q.tasks.push_back(t);
+      }
+      m_cond.notify_one();
+    }
+
+    /// pop task from own queue, or steal from others
+    auto pop() -> task*
+    {
+      auto& own = own_queue();
+      {
+        auto lck = std::unique_lock(own.mtx);
+        if (!own.tasks.empty()) {
+          auto t = own.tasks.back();
+          own.tasks.pop_back();
+          return t;
+        }
+      }
+
+      auto n = m_queues.size();
+      auto b = m_steal_index.fetch_add(1, std::memory_order_relaxed);
+
+      for (size_t i = 0; i < n; ++i) {
+        auto& q = *m_queues[(b + i) % n];
+        if (&q == &own)
+          continue;
+        auto lck = std::unique_lock(q.mtx);
+        if (!q.tasks.empty()) {
+          auto t = q.tasks.front();
+          q.tasks.pop_front();
+          return t;
+        }
+      }
+      return nullptr;
+    }
+
+    void run(task* t) noexcept
+    {
+      {
+        auto lck = std::unique_lock(m_mtx);
+        --m_pending;
+      }
+
+      auto prev                  = detail::installed_resource;
+      auto prev_cancel           = detail::cancel_flag;
+      detail::installed_resource = t->resource;
+      detail::cancel_flag        = t->cancel;
+
+      try {
+        t->func();
+      } catch (...) {
+        t->exception = std::current_exception();
+      }
+
+      detail::installed_resource = prev;
+      detail::cancel_flag        = prev_cancel;
+      t->done.store(true, std::memory_order_release);
+    }
+
+    void wait(task* t)
+    {
+      while (!t->done.load(std::memory_order_acquire)) {
+        if (auto p = pop())
+          run(p);
+        else
+          std::this_thread::yield();
+      }
+    }
+
+    void worker_loop(size_t index)
+    {
+      current_pool()         = this;
+      current_index()        = index;
+      detail::concurrent_eval = true;
+
+      while (true) {
+
+        if (auto t = pop()) {
+          run(t);
+          continue;
+        }
+
+        auto lck = std::unique_lock(m_mtx);
+        m_cond.wait(lck, [&] { return m_terminate || m_pending != 0; });
+
+        if (m_terminate)
+          break;
+      }
+    }
+
+  private:
+    std::vector<std::unique_ptr<worker_queue>> m_queues;
+    std::vector<std::thread> m_workers;
+    std::atomic<size_t> m_steal_index = 0;
+
+  private:
+    std::mutex m_mtx;
+    std::condition_variable m_cond;
+    size_t m_pending = 0;
+    bool m_terminate = false;
+  };
+
+} // namespace yave
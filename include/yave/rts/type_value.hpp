@@ -12,6 +12,7 @@
 #include <yave/support/offset_of_member.hpp>
 
 #include <array>
+#include <atomic>
 #include <cstring>
 #include <random>
 #include <chrono>
@@ -184,6 +185,10 @@ namespace yave {
 
     // 8 byte index
     uint64_t index;
+
+    /// id of type_interner which owns this object, or zero.
+    /// Not copied.
+    mutable std::atomic<uint64_t> intern_id = 0;
   };
 
   static_assert(offset_of_member(&type_value_storage::con) == 0);
@@ -8,6 +8,7 @@
 #include <yave/signal/specifier.hpp>
 #include <yave/rts/function.hpp>
 #include <yave/rts/eval.hpp>
+#include <yave/rts/bytecode.hpp>
 #include <yave/obj/frame_demand/frame_demand.hpp>
 #include <yave/obj/frame_time/frame_time.hpp>
 
@@ -75,7 +76,27 @@ namespace yave {
       template <uint64_t N>
       [[nodiscard]] auto eval_arg() const
       {
-        return eval(arg<N>());
+        auto thunk = arg<N>();
+
+        detail::check_cancel();
+
+        // call instruction of bytecode program without cloning register
+        if (auto r = get_register(arg_signal<N>())) {
+          using T = typename decltype(thunk)::element_type;
+          return detail::eval_return<T>(r->invoke(thunk));
+        }
+
+        return eval(std::move(thunk));
+      }
+
+      /// Get values of inputs by forced evaluation in parallel
+      template <uint64_t... Ns>
+      [[nodiscard]] auto eval_args() const
+      {
+        if (!task_pool::current())
+          return std::tuple {eval_arg<Ns>()...};
+
+        return eval_parallel(arg<Ns>()...);
       }
     };
   } // namespace detail
@@ -91,4 +112,10 @@ namespace yave {
   {
   };
 
+  /// Closure attributes for signal functions which only depend on values of
+  /// their signal arguments. Such functions should never call `arg_demand()`
+  /// or `arg_time()` directly.
+  inline constexpr auto pure_signal_function =
+    closure_attributes::pure | closure_attributes::forward_last_arg;
+
 } // namespace yave
\ No newline at end of file
@@ -6,21 +6,38 @@
 #pragma once
 
 #include <yave/signal/function.hpp>
+#include <yave/rts/immediate.hpp>
 
 #include <functional>
 
 namespace yave {
 
+  namespace detail {
+
+    /// make result of signal function.
+    /// scalar results are returned as immediate values when possible.
+    template <class T, class U>
+    [[nodiscard]] auto make_signal_result(U&& value)
+    {
+      if constexpr (is_immediate_type_v<T>)
+        return make_immediate<T>(std::forward<U>(value));
+      else
+        return make_object<T>(std::forward<U>(value));
+    }
+  } // namespace detail
+
   /// UnarySignalFunction
   template <class T1, class TR, class E>
   struct UnarySignalFunction
     : SignalFunction<UnarySignalFunction<T1, TR, E>, T1, TR>
   {
+    static constexpr auto _attributes = pure_signal_function;
+
     typename UnarySignalFunction::return_type code() const
     {
       auto v0 = this->template eval_arg<0>();
       E e;
-      return make_object<TR>(e(*v0));
+      return detail::make_signal_result<TR>(e(*v0));
     }
   };
 
@@ -29,12 +46,14 @@ namespace yave {
   struct BinarySignalFunction
     : SignalFunction<BinarySignalFunction<T1, T2, TR, E>, T1, T2, TR>
   {
+    static constexpr auto _attributes = pure_signal_function;
+
     typename BinarySignalFunction::return_type code() const
     {
       auto v0 = this->template eval_arg<0>();
       auto v1 = this->template eval_arg<1>();
       E e;
-      return make_object<TR>(e(*v0, *v1));
+      return detail::make_signal_result<TR>(e(*v0, *v1));
     }
   };
 
@@ -43,13 +62,15 @@ namespace yave {
   struct TernarySignalFunction
     : SignalFunction<TernarySignalFunction<T1, T2, T3, TR, E>, T1, T2, T3, TR>
   {
+    static constexpr auto _attributes = pure_signal_function;
+
     typename TernarySignalFunction::return_type code() const
     {
       auto v0 = this->template eval_arg<0>();
       auto v1 = this->template eval_arg<1>();
       auto v2 = this->template eval_arg<2>();
       E e;
-      return make_object<TR>(e(*v0, *v1, *v2));
+      return detail::make_signal_result<TR>(e(*v0, *v1, *v2));
     }
   };
 
@@ -64,6 +85,8 @@ namespace yave {
         T4,
         TR>
   {
+    static constexpr auto _attributes = pure_signal_function;
+
     typename QuaternarySignalFunction::return_type code() const
     {
       auto v0 = this->template eval_arg<0>();
@@ -71,7 +94,7 @@ namespace yave {
       auto v2 = this->template eval_arg<2>();
       auto v3 = this->template eval_arg<3>();
       E e;
-      return make_object<TR>(e(*v0, *v1, *v2, *v3));
+      return detail::make_signal_result<TR>(e(*v0, *v1, *v2, *v3));
     }
   };
 
@@ -0,0 +1,95 @@
+//
+// Copyright (c) 2019 mocabe (https://github.com/mocabe)
+// Distributed under LGPLv3 License. See LICENSE for more details.
+//
+
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <filesystem>
+#include <ostream>
+
+#define YAVE_TRACE_CONCAT_IMPL(A, B) A##B
+#define YAVE_TRACE_CONCAT(A, B) YAVE_TRACE_CONCAT_IMPL(A, B)
+
+/// Macro to record span of current scope
+#define YAVE_TRACE_SPAN(...) \
+  ::yave::trace_span YAVE_TRACE_CONCAT(yave_trace_span_, __LINE__)(__VA_ARGS__)
+
+namespace yave {
+
+  namespace detail {
+
+    /// tracing enabled?
+    inline std::atomic<bool> trace_enabled = false;
+
+    /// Record complete event to buffer of current thread.
+    void record_trace(
+      const char* name,
+      const char* category,
+      std::chrono::steady_clock::time_point begin,
+      std::chrono::steady_clock::time_point end) noexcept;
+
+  } // namespace detail
+
+  /// Start recording trace events.
+  /// Discards events recorded before.
+  void start_trace();
+
+  /// Stop recording trace events.
+  void stop_trace();
+
+  /// Is trace recording?
+  [[nodiscard]] inline bool is_trace_enabled() noexcept
+  {
+    return detail::trace_enabled.load(std::memory_order_relaxed);
+  }
+
+  /// Set name of current thread shown in trace.
+  void set_trace_thread_name(const char* name);
+
+  /// Write recorded events as Chrome trace JSON.
+  /// Output can be loaded by chrome://tracing or Perfetto UI.
+  void write_trace(std::ostream& os);
+
+  /// Write recorded events to file as Chrome trace JSON.
+  /// \returns false when failed to write file
+  [[nodiscard]] bool write_trace(const std::filesystem::path& path);
+
+  /// Scoped trace span.
+  /// Records single event from construction to destruction when tracing is
+  /// enabled. Name and category should be string literals, since only
+  /// pointers are recorded.
+  class trace_span
+  {
+  public:
+    explicit trace_span(
+      const char* name,
+      const char* category = "yave") noexcept
+      : m_name {name}
+      , m_category {category}
+      , m_enabled {is_trace_enabled()}
+    {
+      if (m_enabled)
+        m_begin = std::chrono::steady_clock::now();
+    }
+
+    ~trace_span() noexcept
+    {
+      if (m_enabled)
+        detail::record_trace(
+          m_name, m_category, m_begin, std::chrono::steady_clock::now());
+    }
+
+    trace_span(const trace_span&) = delete;
+    trace_span& operator=(const trace_span&) = delete;
+
+  private:
+    const char* m_name;
+    const char* m_category;
+    bool m_enabled;
+    std::chrono::steady_clock::time_point m_begin;
+  };
+
+} // namespace yave
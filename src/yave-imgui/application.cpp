@@ -14,6 +14,7 @@
 #include <yave/editor/editor_data.hpp>
 #include <yave/editor/compile_thread.hpp>
 #include <yave/editor/execute_thread.hpp>
+#include <yave/support/trace.hpp>
 
 #include <imgui.h>
 #include <imgui_internal.h>
@@ -71,6 +72,8 @@ namespace yave::editor::imgui {
       auto lck = data_ctx.get_data<execute_thread>();
       lck.ref().start();
     }
+    update_node_graph_snapshot(data_ctx);
+
     {
       auto lck = data_ctx.get_data<compile_thread>();
       lck.ref().start();
@@ -120,13 +123,20 @@ namespace yave::editor::imgui {
 
   void application::impl::run()
   {
+    set_trace_thread_name("ui");
+
     while (!imgui_ctx.window_context().should_close()) {
+      YAVE_TRACE_SPAN("ui frame");
       imgui_ctx.begin_frame();
       {
+        YAVE_TRACE_SPAN("view");
         view_ctx.draw();
       }
       imgui_ctx.end_frame();
-      imgui_ctx.render();
+      {
+        YAVE_TRACE_SPAN("render");
+        imgui_ctx.render();
+      }
     }
     // avoid resource destruction before finishing render tasks.
     imgui_ctx.window_context().device().waitIdle();
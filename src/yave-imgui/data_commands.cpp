@@ -68,6 +68,9 @@ namespace yave::editor::imgui {
 
   void dcmd_notify_compile::exec(data_context& ctx)
   {
+    // clone graph here, so compile thread doesn't clone it under lock
+    update_node_graph_snapshot(ctx);
+
     auto lck = ctx.get_data<compile_thread>();
     lck.ref().notify_compile();
   }
@@ -8,6 +8,13 @@
 #include <yave/lib/imgui/imgui_context.hpp>
 #include <yave/editor/editor_data.hpp>
 #include <yave/editor/data_command.hpp>
+#include <yave/support/trace.hpp>
+#include <yave/support/log.hpp>
+
+#include <algorithm>
+#include <ranges>
+
+YAVE_DECL_LOCAL_LOGGER(info_window)
 
 namespace yave::editor::imgui {
 
@@ -33,6 +40,25 @@ namespace yave::editor::imgui {
     m_height = scene.height();
     m_fps    = scene.frame_rate();
     m_format = scene.frame_format();
+
+    m_profiling = executor.profiling();
+    m_profile.clear();
+
+    // most expensive nodes first
+    auto& ng = lck.ref().node_graph();
+    for (auto&& c : executor.last_profile()) {
+      auto n = ng.node(c.node);
+      if (!n)
+        continue;
+      m_profile.push_back(
+        {.name        = ng.get_name(n).value_or(""),
+         .time        = c.time,
+         .allocations = c.allocations});
+    }
+
+    std::sort(m_profile.begin(), m_profile.end(), [](auto& a, auto& b) {
+      return a.time > b.time;
+    });
   }
 
   void info_window::draw(
@@ -72,6 +98,44 @@ namespace yave::editor::imgui {
         }));
       }
 
+      ImGui::SameLine();
+
+      static bool parallel = false;
+      if (ImGui::Checkbox("parallel", &parallel)) {
+        dctx.cmd(make_data_command([=](data_context& ctx) {
+          auto lck = ctx.get_data<editor_data>();
+          lck.ref().executor_data().set_parallel_execution(parallel);
+        }));
+      }
+
+      ImGui::SameLine();
+
+      // probes are attached by compiler
+      auto profiling = m_profiling;
+      if (ImGui::Checkbox("profile", &profiling)) {
+        dctx.cmd(make_data_command([=](data_context& ctx) {
+          auto lck = ctx.get_data<editor_data>();
+          lck.ref().executor_data().set_profiling(profiling);
+        }));
+        dctx.cmd(std::make_unique<dcmd_notify_compile>());
+      }
+
+      ImGui::SameLine();
+
+      // record trace until unchecked, then write it to file
+      auto tracing = is_trace_enabled();
+      if (ImGui::Checkbox("trace", &tracing)) {
+        if (tracing)
+          start_trace();
+        else {
+          stop_trace();
+          if (write_trace("yave-trace.json"))
+            log_info("Wrote trace to yave-trace.json");
+          else
+            log_error("Failed to write trace");
+        }
+      }
+
       if (loop) {
         auto fmin = static_cast<float>(m_arg_time_min.seconds().count());
         auto fmax = static_cast<float>(m_arg_time_max.seconds().count());
@@ -88,6 +152,18 @@ namespace yave::editor::imgui {
               time::seconds(fmin_input), time::seconds(fmax_input));
           }));
       }
+
+      if (m_profiling) {
+        ImGui::Separator();
+        for (auto&& c : m_profile | std::views::take(16)) {
+          auto ms = std::chrono::duration<double, std::milli>(c.time).count();
+          ImGui::Text(
+            "%s: %.3lfms, %llu allocs",
+            c.name.c_str(),
+            ms,
+            static_cast<unsigned long long>(c.allocations));
+        }
+      }
     }
     ImGui::End();
   }
@@ -10,6 +10,7 @@
 #include <yave/lib/image/image_view.hpp>
 #include <yave/editor/editor_data.hpp>
 #include <yave/editor/data_command.hpp>
+#include <yave/support/trace.hpp>
 
 namespace yave::editor {
 
@@ -92,6 +93,8 @@ namespace yave::editor {
     // buffer handling).
     if (updated) {
 
+      YAVE_TRACE_SPAN("texture upload");
+
       auto& img = *last_result;
 
       if (!res_tex_id) {
@@ -0,0 +1,532 @@
+//
+// Copyright (c) 2019 mocabe (https://github.com/mocabe)
+// Distributed under LGPLv3 License. See LICENSE for more details.
+//
+
+#include <yave/lib/vulkan/vulkan_context.hpp>
+#include <yave/module/std/module_loader.hpp>
+#include <yave/editor/data_context.hpp>
+#include <yave/editor/editor_data.hpp>
+#include <yave/editor/serialize.hpp>
+#include <yave/editor/frame_pipeline.hpp>
+#include <yave/compiler/compile.hpp>
+#include <yave/compiler/message.hpp>
+#include <yave/obj/frame_buffer/frame_buffer.hpp>
+#include <yave/signal/specifier.hpp>
+#include <yave/rts/task_pool.hpp>
+#include <yave/rts/to_string.hpp>
+#include <yave/support/log.hpp>
+#include <yave/support/trace.hpp>
+
+#include <png.h>
+#include <fmt/format.h>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <optional>
+#include <string>
+#include <string_view>
+
+YAVE_DECL_LOCAL_LOGGER(render);
+
+using namespace yave;
+using namespace std::chrono;
+
+namespace {
+
+  /// command line options
+  struct options
+  {
+    /// project file
+    std::filesystem::path project;
+    /// output file pattern
+    std::string output = "frame_####.png";
+    /// first frame
+    int64_t start = 0;
+    /// last frame
+    std::optional<int64_t> end;
+    /// number of frames rendered in parallel
+    size_t jobs = task_pool::default_worker_count();
+    /// trace output
+    std::optional<std::filesystem::path> trace;
+  };
+
+  void print_usage()
+  {
+    fmt::print(
+      "usage: yave-render [options] <project>\n"
+      "options:\n"
+      "  -o, --output <pattern> output files, sequence of '#' is replaced by\n"
+      "                         frame number (default: frame_####.png)\n"
+      "  -s, --start <frame>    first frame (default: 0)\n"
+      "  -e, --end <frame>      last frame (default: start)\n"
+      "  -j, --jobs <n>         number of frames rendered in parallel\n"
+      "      --trace <file>     write Chrome trace of render\n"
+      "  -h, --help             show this message\n");
+  }
+
+  auto parse_options(int argc, char** argv) -> std::optional<options>
+  {
+    auto ret = options();
+
+    for (int i = 1; i < argc; ++i) {
+
+      auto arg = std::string_view(argv[i]);
+
+      auto value = [&]() -> std::optional<std::string_view> {
+        if (i + 1 < argc)
+          return argv[++i];
+        fmt::print(stderr, "missing value for {}\n", arg);
+        return std::nullopt;
+      };
+
+      auto number = [&]() -> std::optional<int64_t> {
+        if (auto v = value()) {
+          try {
+            return std::stoll(std::string(*v));
+          } catch (...) {
+            fmt::print(stderr, "invalid number for {}: {}\n", arg, *v);
+          }
+        }
+        return std::nullopt;
+      };
+
+      if (arg == "-h" || arg == "--help") {
+        print_usage();
+        return std::nullopt;
+      }
+
+      if (arg == "-o" || arg == "--output") {
+        auto v = value();
+        if (!v)
+          return std::nullopt;
+        ret.output = *v;
+        continue;
+      }
+
+      if (arg == "-s" || arg == "--start") {
+        auto n = number();
+        if (!n)
+          return std::nullopt;
+        ret.start = *n;
+        continue;
+      }
+
+      if (arg == "-e" || arg == "--end") {
+        auto n = number();
+        if (!n)
+          return std::nullopt;
+        ret.end = *n;
+        continue;
+      }
+
+      if (arg == "-j" || arg == "--jobs") {
+        auto n = number();
+        if (!n || *n < 1)
+          return std::nullopt;
+        ret.jobs = static_cast<size_t>(*n);
+        continue;
+      }
+
+      if (arg == "--trace") {
+        auto v = value();
+        if (!v)
+          return std::nullopt;
+        ret.trace = *v;
+        continue;
+      }
+
+      if (arg.starts_with("-") || !ret.project.empty()) {
+        fmt::print(stderr, "unknown argument: {}\n", arg);
+        print_usage();
+        return std::nullopt;
+      }
+
+      ret.project = arg;
+    }
+
+    if (ret.project.empty()) {
+      print_usage();
+      return std::nullopt;
+    }
+
+    if (!ret.end)
+      ret.end = ret.start;
+
+    if (ret.start < 0 || *ret.end < ret.start) {
+      fmt::print(stderr, "invalid frame range: {}-{}\n", ret.start, *ret.end);
+      return std::nullopt;
+    }
+
+    return ret;
+  }
+
+  /// replace last sequence of '#' in pattern with zero padded frame number
+  auto output_path(const std::string& pattern, int64_t frame)
+    -> std::filesystem::path
+  {
+    auto last = pattern.find_last_of('#');
+
+    if (last == std::string::npos)
+      return fmt::format("{}{:04}", pattern, frame);
+
+    auto first = pattern.find_last_not_of('#', last);
+    first      = first == std::string::npos ? 0 : first + 1;
+
+    auto n = last - first + 1;
+
+    return pattern.substr(0, first) + fmt::format("{:0{}}", frame, n)
+           + pattern.substr(last + 1);
+  }
+
+  /// write image as PNG.
+  /// floating point images are converted to 16bit.
+  bool write_png(const image& img, const std::filesystem::path& path)
+  {
+    auto fmt = img.image_format();
+
+    auto color_type = [&] {
+      switch (fmt.color_type) {
+        case image_color_type::rgba:
+          return PNG_COLOR_TYPE_RGBA;
+        case image_color_type::rgb:
+          return PNG_COLOR_TYPE_RGB;
+        default:
+          return -1;
+      }
+    }();
+
+    if (color_type < 0) {
+      log_error("Unsupported image format");
+      return false;
+    }
+
+    auto channels = channel_size(fmt);
+    auto is_float = fmt.data_type == image_data_type::floating_point;
+    auto depth    = is_float ? 2u : byte_per_channel(fmt);
+
+    if (depth != 1 && depth != 2) {
+      log_error("Unsupported image format");
+      return false;
+    }
+
+    auto fp = std::fopen(path.string().c_str(), "wb");
+
+    if (!fp) {
+      log_error("Failed to open file: {}", path.string());
+      return false;
+    }
+
+    auto png  = png_create_write_struct(PNG_LIBPNG_VER_STRING, 0, 0, 0);
+    auto info = png ? png_create_info_struct(png) : nullptr;
+
+    // convert rows to PNG samples (big endian)
+    auto row = std::vector<png_byte>(img.width() * channels * depth);
+
+    auto ok = [&] {
+      if (!info)
+        return false;
+
+      // libpng reports errors by longjmp
+      if (setjmp(png_jmpbuf(png)))
+        return false;
+
+      png_init_io(png, fp);
+      png_set_IHDR(
+        png,
+        info,
+        img.width(),
+        img.height(),
+        depth * 8,
+        color_type,
+        PNG_INTERLACE_NONE,
+        PNG_COMPRESSION_TYPE_DEFAULT,
+        PNG_FILTER_TYPE_DEFAULT);
+      png_write_info(png, info);
+
+      auto n = img.width() * channels;
+
+      for (uint32_t y = 0; y < img.height(); ++y) {
+
+        auto src = img.data() + y * img.stride();
+
+        for (uint32_t i = 0; i < n; ++i) {
+          if (depth == 1) {
+            row[i] = src[i];
+            continue;
+          }
+
+          auto v = uint16_t();
+
+          if (is_float) {
+            auto f = reinterpret_cast<const float*>(src)[i];
+            v      = static_cast<uint16_t>(std::clamp(f, 0.f, 1.f) * 65535.f);
+          } else
+            v = reinterpret_cast<const uint16_t*>(src)[i];
+
+          row[2 * i]     = static_cast<png_byte>(v >> 8);
+          row[2 * i + 1] = static_cast<png_byte>(v & 0xff);
+        }
+        png_write_row(png, row.data());
+      }
+
+      png_write_end(png, nullptr);
+      return true;
+    }();
+
+    png_destroy_write_struct(&png, info ? &info : nullptr);
+    std::fclose(fp);
+
+    if (!ok)
+      log_error("Failed to write PNG: {}", path.string());
+
+    return ok;
+  }
+
+  /// accumulated time of render stage
+  struct stage_time
+  {
+    std::atomic<int64_t> ns = 0;
+
+    void add(steady_clock::duration d)
+    {
+      ns += duration_cast<nanoseconds>(d).count();
+    }
+
+    auto ms() const
+    {
+      return ns.load() / 1e6;
+    }
+  };
+
+  /// time of render stages
+  struct render_stats
+  {
+    stage_time compile;
+    stage_time execute;
+    stage_time readback;
+    stage_time write;
+  };
+
+  /// execute frame and load result to host memory
+  auto render_frame(
+    render_stats& stats,
+    compiler::executable&& exe,
+    yave::time t) -> std::shared_ptr<const image>
+  {
+    try {
+
+      auto bgn = steady_clock::now();
+
+      auto r = [&] {
+        YAVE_TRACE_SPAN("execute");
+        return value_cast<FrameBuffer>(exe.execute(t));
+      }();
+
+      auto mid = steady_clock::now();
+
+      auto img = [&] {
+        YAVE_TRACE_SPAN("readback");
+        auto img =
+          std::make_shared<image>(r->width(), r->height(), r->format());
+        r->read_data(0, 0, r->width(), r->height(), img->data());
+        return img;
+      }();
+
+      auto end = steady_clock::now();
+
+      stats.execute.add(mid - bgn);
+      stats.readback.add(end - mid);
+
+      return img;
+
+    } catch (const exception_result& e) {
+      log_error("Failed to execute frame: {}", e.exception()->message());
+    } catch (const std::exception& e) {
+      log_error("Failed to execute frame: {}", e.what());
+    }
+    return nullptr;
+  }
+
+  /// compile graph with the same pipeline as compile thread
+  auto compile(editor::editor_data& data)
+    -> std::optional<compiler::executable>
+  {
+    YAVE_TRACE_SPAN("compile");
+
+    auto ng   = data.node_graph_snapshot();
+    auto root = ng->node(data.root_group().id());
+
+    if (ng->output_sockets(root).empty()) {
+      log_error("Project has no output");
+      return std::nullopt;
+    }
+
+    auto os = ng->output_sockets(root)[0];
+
+    auto pipe = compiler::init_pipeline();
+
+    pipe
+      .and_then([&](auto& p) {
+        compiler::input(
+          p,
+          ng,
+          os,
+          data.node_declarations().get_map(),
+          data.node_definitions().get_map());
+      })
+      .and_then([](auto& p) { compiler::parse(p); })
+      .and_then([](auto& p) { compiler::sema(p); })
+      .and_then([](auto& p) { compiler::verify(p); })
+      .and_then([](auto& p) { compiler::optimize(p); })
+      .and_then([](auto& p) { compiler::lower(p); });
+
+    if (!pipe.success()) {
+      auto& msgs = pipe.get_data<compiler::message_map>("msg_map");
+      for (auto&& m : msgs.get_errors()) {
+        if (auto text = m.pretty_print(*ng))
+          log_error("{}", *text);
+      }
+      return std::nullopt;
+    }
+
+    auto& exe = pipe.get_data<compiler::executable>("exe");
+
+    if (!same_type(exe.type(), object_type<signal<FrameBuffer>>())) {
+      log_error("Output is not frame: {}", to_string(exe.type()));
+      return std::nullopt;
+    }
+
+    return std::move(exe);
+  }
+
+  int render(const options& opts)
+  {
+    auto vulkan_ctx = vulkan::vulkan_context({.enable_validation = false});
+    auto data_ctx   = editor::data_context();
+
+    data_ctx.add_data(editor::editor_data(data_ctx));
+
+    auto lck   = data_ctx.get_data<editor::editor_data>();
+    auto& data = lck.ref();
+
+    data.add_module_loader(
+      std::make_unique<modules::_std::module_loader>(vulkan_ctx));
+    data.load_modules({{modules::_std::module_name}});
+    data.init_modules(data.scene_config());
+
+    // deinit modules after rendering
+    struct modules_guard
+    {
+      editor::editor_data& data;
+      ~modules_guard() noexcept
+      {
+        data.deinit_modules();
+        data.unload_modules();
+      }
+    } guard {data};
+
+    if (!editor::load(data, opts.project))
+      return 1;
+
+    auto stats = render_stats();
+
+    auto bgn = steady_clock::now();
+    auto exe = compile(data);
+    stats.compile.add(steady_clock::now() - bgn);
+
+    if (!exe)
+      return 1;
+
+    auto fps = data.scene_config().frame_rate();
+    auto dt  = time::seconds(1) / fps;
+
+    auto frames = editor::frame_pipeline(
+      opts.jobs, 2 * opts.jobs, [&](compiler::executable&& e, yave::time t) {
+        return render_frame(stats, std::move(e), t);
+      });
+
+    frames.reset(*exe, 0);
+
+    log_info(
+      "Rendering frames {}-{} with {} workers",
+      opts.start,
+      *opts.end,
+      frames.workers());
+
+    auto render_bgn = steady_clock::now();
+
+    // next frame to queue
+    auto next = opts.start;
+
+    for (auto frame = opts.start; frame <= *opts.end; ++frame) {
+
+      // queue frames until pipeline is full
+      while (next <= *opts.end && frames.push(dt * next))
+        ++next;
+
+      // frames are delivered in order
+      auto f = frames.pop();
+      assert(f && f->time == dt * frame);
+
+      if (!f->image) {
+        log_error("Failed to render frame {}", frame);
+        frames.cancel();
+        frames.wait();
+        return 1;
+      }
+
+      auto write_bgn = steady_clock::now();
+      {
+        YAVE_TRACE_SPAN("write");
+        if (!write_png(*f->image, output_path(opts.output, frame))) {
+          frames.cancel();
+          frames.wait();
+          return 1;
+        }
+      }
+      stats.write.add(steady_clock::now() - write_bgn);
+    }
+
+    auto render_end = steady_clock::now();
+
+    auto n    = *opts.end - opts.start + 1;
+    auto secs = duration<double>(render_end - render_bgn).count();
+
+    fmt::print("frames:      {}\n", n);
+    fmt::print("total:       {:.3f} s\n", secs);
+    fmt::print("throughput:  {:.2f} frames/s\n", n / secs);
+    fmt::print("compile:     {:.2f} ms\n", stats.compile.ms());
+    fmt::print("execute:     {:.2f} ms/frame\n", stats.execute.ms() / n);
+    fmt::print("readback:    {:.2f} ms/frame\n", stats.readback.ms() / n);
+    fmt::print("write:       {:.2f} ms/frame\n", stats.write.ms() / n);
+
+    return 0;
+  }
+
+} // namespace
+
+int main(int argc, char** argv)
+{
+  auto opts = parse_options(argc, argv);
+
+  if (!opts)
+    return 1;
+
+  if (opts->trace)
+    start_trace();
+
+  set_trace_thread_name("render");
+
+  auto ret = render(*opts);
+
+  if (opts->trace) {
+    stop_trace();
+    if (write_trace(*opts->trace))
+      log_info("Wrote trace to {}", opts->trace->string());
+  }
+
+  return ret;
+}
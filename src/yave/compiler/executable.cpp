@@ -4,29 +4,45 @@
 //
 
 #include <yave/compiler/executable.hpp>
+#include <yave/compiler/memo_table.hpp>
+#include <yave/compiler/signal_cache.hpp>
 #include <yave/obj/frame_demand/frame_demand.hpp>
 #include <yave/rts/rts.hpp>
+#include <yave/rts/frame_arena.hpp>
+#include <yave/rts/bytecode.hpp>
 
 namespace yave::compiler {
 
   executable::executable(
     object_ptr<const Object> obj,
-    object_ptr<const Type> type)
+    object_ptr<const Type> type,
+    std::shared_ptr<memo_table> memo,
+    std::shared_ptr<const bytecode_program> code,
+    std::shared_ptr<signal_cache> cache)
     : m_obj {std::move(obj)}
     , m_type {std::move(type)}
+    , m_memo {std::move(memo)}
+    , m_code {std::move(code)}
+    , m_cache {std::move(cache)}
   {
   }
 
   executable::executable(executable&& other) noexcept
     : m_obj {std::move(other.m_obj)}
     , m_type {std::move(other.m_type)}
+    , m_memo {std::move(other.m_memo)}
+    , m_code {std::move(other.m_code)}
+    , m_cache {std::move(other.m_cache)}
   {
   }
 
   executable& executable::operator=(executable&& other) noexcept
   {
-    m_obj  = std::move(other.m_obj);
-    m_type = std::move(other.m_type);
+    m_obj   = std::move(other.m_obj);
+    m_type  = std::move(other.m_type);
+    m_memo  = std::move(other.m_memo);
+    m_code  = std::move(other.m_code);
+    m_cache = std::move(other.m_cache);
     return *this;
   }
 
@@ -40,15 +56,54 @@ namespace yave::compiler {
     return m_type;
   }
 
+  auto executable::memo() const -> const std::shared_ptr<memo_table>&
+  {
+    return m_memo;
+  }
+
+  auto executable::cache() const -> const std::shared_ptr<signal_cache>&
+  {
+    return m_cache;
+  }
+
+  auto executable::program() const -> const bytecode_program*
+  {
+    return m_code.get();
+  }
+
   auto executable::execute(const time& time) -> object_ptr<const Object>
   {
-    return eval(
-      m_obj << make_object<FrameDemand>(make_object<FrameTime>(time)));
+    // allocate temporary objects of this frame from arena. objects are
+    // confined to this thread unless evaluated in parallel.
+    auto arena =
+      frame_arena::scope(frame_arena::instance(), !detail::concurrent_eval);
+
+    auto result =
+      eval(m_obj << make_object<FrameDemand>(make_object<FrameTime>(time)));
+
+    // discard results shared within this frame
+    if (m_memo)
+      m_memo->collect();
+
+    return result;
   }
 
   auto executable::clone() const -> executable
   {
-    return {copy_apply_graph(m_obj), m_type};
+    // registers are not copied, and their instructions are shared.
+    return {copy_apply_graph(m_obj), m_type, m_memo, m_code, m_cache};
+  }
+
+  void executable::clear_cache()
+  {
+    if (m_memo)
+      m_memo->clear();
+
+    if (m_code)
+      m_code->clear();
+
+    if (m_cache)
+      m_cache->clear();
   }
 
 }
\ No newline at end of file
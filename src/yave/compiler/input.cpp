@@ -14,10 +14,25 @@ namespace yave::compiler {
     socket_handle os,
     node_declaration_map decls,
     node_definition_map defs)
+  {
+    input(
+      pipe,
+      std::make_shared<const structured_node_graph>(std::move(ng)),
+      std::move(os),
+      std::move(decls),
+      std::move(defs));
+  }
+
+  void input(
+    pipeline& pipe,
+    std::shared_ptr<const structured_node_graph> ng,
+    socket_handle os,
+    node_declaration_map decls,
+    node_definition_map defs)
   {
     assert(pipe.get_data_if<message_map>("msg_map"));
 
-    if (!ng.exists(os)) {
+    if (!ng || !ng->exists(os)) {
       auto& msg_map = pipe.get_data<message_map>("msg_map");
       msg_map.add(internal_compile_error("Invalid program input"));
       pipe.set_failed();
@@ -0,0 +1,88 @@
+//
+// Copyright (c) 2019 mocabe (https://github.com/mocabe)
+// Distributed under LGPLv3 License. See LICENSE for more details.
+//
+
+#include <yave/compiler/compile.hpp>
+#include <yave/compiler/message.hpp>
+#include <yave/compiler/executable.hpp>
+#include <yave/support/log.hpp>
+#include <yave/rts/rts.hpp>
+#include <yave/rts/bytecode.hpp>
+
+#include <map>
+
+YAVE_DECL_LOCAL_LOGGER(lower)
+
+namespace yave::compiler {
+
+  namespace {
+
+    /// Lower graph bottom-up.
+    /// Operands are lowered before instructions which use them, so program
+    /// is built in evaluation order.
+    class lower_graph
+    {
+      std::shared_ptr<bytecode_program> m_code;
+      std::map<const Object*, object_ptr<const Object>> m_map;
+
+    public:
+      lower_graph(std::shared_ptr<bytecode_program> code)
+        : m_code {std::move(code)}
+      {
+      }
+
+      auto rec(const object_ptr<const Object>& obj) -> object_ptr<const Object>
+      {
+        if (auto it = m_map.find(obj.get()); it != m_map.end())
+          return it->second;
+
+        auto ret = obj;
+
+        if (auto apply = value_cast_if<Apply>(obj)) {
+          auto& storage = _get_storage(*apply);
+          if (!storage.is_result()) {
+            auto app = rec(storage.app());
+            auto arg = rec(storage.arg());
+            if (app != storage.app() || arg != storage.arg())
+              ret = make_object<Apply>(std::move(app), std::move(arg));
+
+            if (bytecode_instruction::is_lowerable(ret))
+              ret = m_code->add(ret);
+          }
+        } else if (auto lambda = value_cast_if<Lambda>(obj)) {
+          // closed subgraphs in body are shared between instances
+          auto& storage = _get_storage(*lambda);
+          auto body     = rec(storage.body);
+          if (body != storage.body)
+            ret = make_object<Lambda>(storage.var, std::move(body));
+        }
+
+        m_map.emplace(obj.get(), ret);
+        return ret;
+      }
+    };
+  } // namespace
+
+  void lower(pipeline& pipe)
+  {
+    assert(pipe.get_data_if<message_map>("msg_map"));
+    assert(pipe.get_data_if<executable>("exe"));
+
+    auto& exe  = pipe.get_data<executable>("exe");
+    auto* dump = pipe.get_data_if<bool>("lower_dump");
+
+    auto code = std::make_shared<bytecode_program>();
+    auto obj  = lower_graph(code).rec(exe.object());
+
+    if (dump && *dump)
+      log_info("{} instructions", code->size());
+
+    // nothing to lower
+    if (code->size() == 0)
+      return;
+
+    exe = executable(
+      std::move(obj), exe.type(), exe.memo(), std::move(code), exe.cache());
+  }
+} // namespace yave::compiler
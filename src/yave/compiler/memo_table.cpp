@@ -0,0 +1,117 @@
+//
+// Copyright (c) 2019 mocabe (https://github.com/mocabe)
+// Distributed under LGPLv3 License. See LICENSE for more details.
+//
+
+#include <yave/compiler/memo_table.hpp>
+#include <yave/rts/frame_arena.hpp>
+
+namespace yave::compiler {
+
+  auto memo_table::add() -> size_t
+  {
+    auto lck = std::unique_lock(m_mtx);
+    m_results.emplace_back();
+    return m_results.size() - 1;
+  }
+
+  auto memo_table::get(size_t idx) const -> object_ptr<const Object>
+  {
+    auto lck = std::unique_lock(m_mtx);
+    assert(idx < m_results.size());
+    return m_results[idx];
+  }
+
+  void memo_table::set(size_t idx, object_ptr<const Object> obj)
+  {
+    // memo table is shared between threads
+    frame_arena::instance().share();
+
+    auto lck = std::unique_lock(m_mtx);
+    assert(idx < m_results.size());
+    m_results[idx] = std::move(obj);
+  }
+
+  auto memo_table::add_shared() -> size_t
+  {
+    auto lck = std::unique_lock(m_mtx);
+    m_shared.emplace_back();
+    return m_shared.size() - 1;
+  }
+
+  auto memo_table::get_shared(
+    size_t idx,
+    const object_ptr<const Object>& arg) const -> object_ptr<const Object>
+  {
+    auto lck = std::unique_lock(m_mtx);
+    assert(idx < m_shared.size());
+
+    // holding the argument makes its address unique
+    for (auto&& r : m_shared[idx])
+      if (r.arg == arg)
+        return r.obj;
+
+    return nullptr;
+  }
+
+  void memo_table::set_shared(
+    size_t idx,
+    object_ptr<const Object> arg,
+    object_ptr<const Object> obj)
+  {
+    // memo table is shared between threads
+    frame_arena::instance().share();
+
+    auto lck = std::unique_lock(m_mtx);
+    assert(idx < m_shared.size());
+    m_shared[idx].push_back({std::move(arg), std::move(obj)});
+  }
+
+  void memo_table::collect()
+  {
+    // destroy results outside of lock
+    auto tmp = std::vector<shared_result>();
+    {
+      auto lck = std::unique_lock(m_mtx);
+      for (auto&& rs : m_shared) {
+        auto kept = std::vector<shared_result>();
+        for (auto&& r : rs) {
+          if (r.arg.use_count() == 1)
+            tmp.push_back(std::move(r));
+          else
+            kept.push_back(std::move(r));
+        }
+        rs.swap(kept);
+      }
+    }
+  }
+
+  void memo_table::clear()
+  {
+    // destroy results outside of lock
+    auto tmp    = std::vector<object_ptr<const Object>>();
+    auto shared = std::vector<std::vector<shared_result>>();
+    {
+      auto lck = std::unique_lock(m_mtx);
+      tmp.resize(m_results.size());
+      m_results.swap(tmp);
+      shared.resize(m_shared.size());
+      m_shared.swap(shared);
+    }
+  }
+
+  auto memo_table::size() const -> size_t
+  {
+    auto lck = std::unique_lock(m_mtx);
+    return m_results.size();
+  }
+
+  auto memo_table::shared_size() const -> size_t
+  {
+    auto lck = std::unique_lock(m_mtx);
+    auto n   = size_t(0);
+    for (auto&& rs : m_shared)
+      n += rs.size();
+    return n;
+  }
+} // namespace yave::compiler
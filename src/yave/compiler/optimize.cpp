@@ -6,14 +6,675 @@
 #include <yave/compiler/compile.hpp>
 #include <yave/compiler/message.hpp>
 #include <yave/compiler/executable.hpp>
+#include <yave/compiler/memo_table.hpp>
+#include <yave/compiler/signal_cache.hpp>
+#include <yave/obj/node/argument.hpp>
+#include <yave/obj/frame_demand/frame_demand.hpp>
+#include <yave/support/log.hpp>
+#include <yave/rts/rts.hpp>
+
+#include <map>
+#include <set>
+
+YAVE_DECL_LOCAL_LOGGER(optimize)
 
 namespace yave::compiler {
 
+  namespace {
+
+    /// Rebuild graph bottom-up.
+    /// Nodes are rebuilt only when children have changed, and sharing of
+    /// nodes is preserved.
+    /// \param f called with original node and rebuilt node, returns new node.
+    template <class F>
+    auto rewrite(const object_ptr<const Object>& root, F&& f)
+      -> object_ptr<const Object>
+    {
+      std::map<const Object*, object_ptr<const Object>> map;
+
+      auto rec = [&](auto&& self, const object_ptr<const Object>& obj)
+        -> object_ptr<const Object> {
+        if (auto it = map.find(obj.get()); it != map.end())
+          return it->second;
+
+        auto ret = obj;
+
+        if (auto apply = value_cast_if<Apply>(obj)) {
+          auto& storage = _get_storage(*apply);
+          if (!storage.is_result()) {
+            auto app = self(self, storage.app());
+            auto arg = self(self, storage.arg());
+            if (app != storage.app() || arg != storage.arg())
+              ret = make_object<Apply>(std::move(app), std::move(arg));
+          }
+        } else if (auto lambda = value_cast_if<Lambda>(obj)) {
+          auto& storage = _get_storage(*lambda);
+          auto body     = self(self, storage.body);
+          if (body != storage.body)
+            ret = make_object<Lambda>(storage.var, std::move(body));
+        }
+
+        ret = f(obj, std::move(ret));
+        map.emplace(obj.get(), ret);
+        return ret;
+      };
+      return rec(rec, root);
+    }
+
+    /// Count Apply and Lambda nodes in graph.
+    auto count_nodes(const object_ptr<const Object>& root) -> size_t
+    {
+      std::set<const Object*> visited;
+      size_t count = 0;
+
+      auto rec = [&](auto&& self, const object_ptr<const Object>& obj) {
+        if (!visited.insert(obj.get()).second)
+          return;
+
+        if (auto apply = value_cast_if<Apply>(obj)) {
+          auto& storage = _get_storage(*apply);
+          ++count;
+          if (!storage.is_result()) {
+            self(self, storage.app());
+            self(self, storage.arg());
+          }
+        } else if (auto lambda = value_cast_if<Lambda>(obj)) {
+          ++count;
+          self(self, _get_storage(*lambda).body);
+        }
+      };
+      rec(rec, root);
+
+      return count;
+    }
+
+    /// Get arguments of apply spine in order of application.
+    /// \returns pair of bottom and arguments
+    auto get_spine(const object_ptr<const Object>& obj) -> std::
+      pair<object_ptr<const Object>, std::vector<object_ptr<const Object>>>
+    {
+      auto bottom = obj;
+      auto args   = std::vector<object_ptr<const Object>>();
+
+      while (auto apply = value_cast_if<Apply>(bottom)) {
+        auto& storage = _get_storage(*apply);
+        if (storage.is_result())
+          break;
+        args.push_back(storage.arg());
+        bottom = storage.app();
+      }
+      std::reverse(args.begin(), args.end());
+      return {std::move(bottom), std::move(args)};
+    }
+
+    /// Remove arguments of lambda which are never used in body.
+    class eliminate_dead_args
+    {
+      std::map<std::pair<const Object*, uint64_t>, bool> m_occurs;
+
+      /// Check if variable occurs free in term.
+      bool occurs(const object_ptr<const Object>& obj, uint64_t id)
+      {
+        auto key = std::pair(obj.get(), id);
+
+        if (auto it = m_occurs.find(key); it != m_occurs.end())
+          return it->second;
+
+        auto ret = [&] {
+          if (auto apply = value_cast_if<Apply>(obj)) {
+            auto& storage = _get_storage(*apply);
+            if (storage.is_result())
+              return false;
+            return occurs(storage.app(), id) || occurs(storage.arg(), id);
+          }
+          if (auto lambda = value_cast_if<Lambda>(obj)) {
+            auto& storage = _get_storage(*lambda);
+            if (storage.var->id() == id)
+              return false;
+            return occurs(storage.body, id);
+          }
+          if (auto var = value_cast_if<Variable>(obj))
+            return var->id() == id;
+          return false;
+        }();
+
+        m_occurs.emplace(key, ret);
+        return ret;
+      }
+
+    public:
+      auto operator()(
+        const object_ptr<const Object>&,
+        object_ptr<const Object> obj) -> object_ptr<const Object>
+      {
+        auto [bottom, args] = get_spine(obj);
+
+        if (args.empty() || !value_cast_if<Lambda>(bottom))
+          return obj;
+
+        // peel lambdas which have arguments
+        auto vars = std::vector<object_ptr<const Variable>>();
+        auto body = bottom;
+        while (auto lambda = value_cast_if<Lambda>(body)) {
+          if (vars.size() == args.size())
+            break;
+          vars.push_back(_get_storage(*lambda).var);
+          body = _get_storage(*lambda).body;
+        }
+
+        auto used = std::vector<bool>(vars.size());
+        for (size_t i = 0; i < vars.size(); ++i)
+          used[i] = occurs(body, vars[i]->id());
+
+        if (std::all_of(used.begin(), used.end(), [](bool b) { return b; }))
+          return obj;
+
+        for (size_t i = vars.size(); i-- > 0;) {
+          if (used[i])
+            body = make_object<Lambda>(vars[i], body);
+        }
+
+        for (size_t i = 0; i < args.size(); ++i) {
+          if (i >= used.size() || used[i])
+            body = make_object<Apply>(body, args[i]);
+        }
+        return body;
+      }
+    };
+
+    /// Share structurally identical nodes.
+    class eliminate_common_subexprs
+    {
+      using key_type = std::pair<const Object*, const Object*>;
+
+      std::map<key_type, object_ptr<const Object>> m_apps;
+      std::map<key_type, object_ptr<const Object>> m_lambdas;
+      std::map<uint64_t, object_ptr<const Object>> m_vars;
+
+    public:
+      auto operator()(
+        const object_ptr<const Object>&,
+        object_ptr<const Object> obj) -> object_ptr<const Object>
+      {
+        if (auto apply = value_cast_if<Apply>(obj)) {
+          auto& storage = _get_storage(*apply);
+          if (storage.is_result())
+            return obj;
+          auto key = key_type(storage.app().get(), storage.arg().get());
+          return m_apps.try_emplace(key, obj).first->second;
+        }
+
+        if (auto lambda = value_cast_if<Lambda>(obj)) {
+          auto& storage = _get_storage(*lambda);
+          auto var      = m_vars.try_emplace(storage.var->id(), storage.var);
+          auto key      = key_type(var.first->second.get(), storage.body.get());
+          return m_lambdas.try_emplace(key, obj).first->second;
+        }
+
+        if (auto var = value_cast_if<Variable>(obj))
+          return m_vars.try_emplace(var->id(), obj).first->second;
+
+        return obj;
+      }
+    };
+
+    /// Evaluate closed non-signal subterms, i.e. fully applied pure closures
+    /// which only take literals and never see frame demand.
+    class fold_constants
+    {
+      std::map<const Object*, bool> m_signal;
+
+      /// Check if type mentions frame demand.
+      static bool has_demand(const object_ptr<const Type>& tp)
+      {
+        if (auto ap = is_tap_type_if(tp))
+          return has_demand(ap->t1) || has_demand(ap->t2);
+        return is_tcon_type(tp) && same_type(tp, object_type<FrameDemand>());
+      }
+
+      /// Signals and signal functions wait for frame demand.
+      bool is_signal(const object_ptr<const Object>& obj)
+      {
+        if (auto it = m_signal.find(obj.get()); it != m_signal.end())
+          return it->second;
+
+        auto ret = has_demand(get_type(obj));
+        m_signal.emplace(obj.get(), ret);
+        return ret;
+      }
+
+      /// Node arguments are updated in-place, and lambdas and variables are
+      /// not closed.
+      bool is_literal(const object_ptr<const Object>& obj)
+      {
+        if (auto closure = value_cast_if<Closure<>>(obj))
+          return closure->has_attributes(closure_attributes::pure)
+                 && !is_signal(obj);
+
+        return !has_type<Apply>(obj) && !has_type<Lambda>(obj)
+               && !has_type<Variable>(obj) && !has_type<NodeArgument>(obj);
+      }
+
+    public:
+      auto operator()(
+        const object_ptr<const Object>&,
+        object_ptr<const Object> obj) -> object_ptr<const Object>
+      {
+        auto [bottom, args] = get_spine(obj);
+
+        if (args.empty())
+          return obj;
+
+        auto closure = value_cast_if<Closure<>>(bottom);
+
+        if (
+          !closure || closure->is_pap()
+          || !closure->has_attributes(closure_attributes::pure)
+          || closure->arity != args.size() || is_signal(bottom))
+          return obj;
+
+        for (auto&& arg : args)
+          if (!is_literal(arg))
+            return obj;
+
+        try {
+          // subtrees can be shared with previous executable through
+          // sema_cache, so do not evaluate them in-place.
+          return eval(copy_apply_graph(obj));
+        } catch (const std::exception&) {
+          // report error at runtime
+          return obj;
+        }
+      }
+    };
+
+    class Memo_X;
+    class Memo_Y;
+
+    /// Memoize result of time invariant term.
+    /// Memo f x = f x, but result of first call is shared between all frames
+    /// until table is cleared.
+    struct Memo
+      : Function<Memo, closure<Memo_X, Memo_Y>, Memo_X, Memo_Y>
+    {
+      static constexpr auto _attributes =
+        closure_attributes::pure | closure_attributes::forward_last_arg;
+
+      Memo(std::shared_ptr<memo_table> table, size_t index)
+        : m_table {std::move(table)}
+        , m_index {index}
+      {
+      }
+
+      auto code() const -> return_type
+      {
+        if (auto result = m_table->get(m_index))
+          return static_object_cast<const VarValueProxy<Memo_Y>>(result);
+
+        auto result = eval(arg<0>() << arg<1>());
+        m_table->set(m_index, result);
+        return static_object_cast<const VarValueProxy<Memo_Y>>(result);
+      }
+
+    private:
+      std::shared_ptr<memo_table> m_table;
+      size_t m_index;
+    };
+
+    class Share_X;
+    class Share_Y;
+
+    /// Share result of subterm between consumers which apply it to the same
+    /// argument object, i.e. same frame demand in a frame.
+    /// Results are kept in table for each argument until the execution
+    /// finishes, so concurrent frames don't evict results of each other.
+    struct Share
+      : Function<Share, closure<Share_X, Share_Y>, Share_X, Share_Y>
+    {
+      static constexpr auto _attributes =
+        closure_attributes::pure | closure_attributes::forward_last_arg;
+
+      Share(std::shared_ptr<memo_table> table, size_t index)
+        : m_table {std::move(table)}
+        , m_index {index}
+      {
+      }
+
+      auto code() const -> return_type
+      {
+        auto x = eval_arg<1>();
+
+        if (auto result = m_table->get_shared(m_index, x))
+          return static_object_cast<const VarValueProxy<Share_Y>>(result);
+
+        auto result = eval(arg<0>() << x);
+        m_table->set_shared(m_index, std::move(x), result);
+        return static_object_cast<const VarValueProxy<Share_Y>>(result);
+      }
+
+    private:
+      std::shared_ptr<memo_table> m_table;
+      size_t m_index;
+    };
+
+    /// Check if term is closed and built only from pure closures.
+    class purity
+    {
+      std::map<const Object*, bool> m_pure;
+
+    public:
+      bool operator()(const object_ptr<const Object>& obj)
+      {
+        if (auto it = m_pure.find(obj.get()); it != m_pure.end())
+          return it->second;
+
+        auto ret = [&] {
+          if (auto apply = value_cast_if<Apply>(obj)) {
+            auto& storage = _get_storage(*apply);
+            if (storage.is_result())
+              return true;
+            return (*this)(storage.app()) && (*this)(storage.arg());
+          }
+          if (auto closure = value_cast_if<Closure<>>(obj))
+            return closure->has_attributes(closure_attributes::pure);
+          // lambda bodies are instantiated for each argument
+          return !has_type<Lambda>(obj) && !has_type<Variable>(obj);
+        }();
+
+        m_pure.emplace(obj.get(), ret);
+        return ret;
+      }
+    };
+
+    /// Wrap shared subterms waiting for their last argument with Share, so
+    /// they are evaluated once per frame.
+    class share_subterms
+    {
+      std::shared_ptr<memo_table> m_table;
+      std::map<const Object*, size_t> m_refs;
+      purity m_pure;
+
+    public:
+      share_subterms(
+        const object_ptr<const Object>& root,
+        std::shared_ptr<memo_table> table)
+        : m_table {std::move(table)}
+      {
+        std::set<const Object*> visited;
+
+        auto rec = [&](auto&& self, const object_ptr<const Object>& obj) {
+          ++m_refs[obj.get()];
+
+          if (!visited.insert(obj.get()).second)
+            return;
+
+          if (auto apply = value_cast_if<Apply>(obj)) {
+            auto& storage = _get_storage(*apply);
+            if (!storage.is_result()) {
+              self(self, storage.app());
+              self(self, storage.arg());
+            }
+          } else if (auto lambda = value_cast_if<Lambda>(obj))
+            self(self, _get_storage(*lambda).body);
+        };
+        rec(rec, root);
+      }
+
+      auto operator()(
+        const object_ptr<const Object>& original,
+        object_ptr<const Object> obj) -> object_ptr<const Object>
+      {
+        if (m_refs[original.get()] < 2 || !has_type<Apply>(obj))
+          return obj;
+
+        auto [depth, bottom] = detail::inspect_spine(obj);
+        auto closure         = value_cast_if<Closure<>>(bottom);
+
+        if (!closure || closure->arity != depth + 1 || !m_pure(obj))
+          return obj;
+
+        return make_object<Apply>(
+          make_object<Share>(m_table, m_table->add_shared()), std::move(obj));
+      }
+    };
+
+    /// Find maximal time invariant subterms and wrap them with Memo.
+    class memoize_invariants
+    {
+      std::shared_ptr<memo_table> m_table;
+      std::map<const Object*, bool> m_invariant;
+      std::map<const Object*, object_ptr<const Object>> m_rebuilt;
+
+    public:
+      memoize_invariants(std::shared_ptr<memo_table> table)
+        : m_table {std::move(table)}
+      {
+      }
+
+      /// Check if term always evaluates to the same value when applied to
+      /// any frame demand.
+      bool is_invariant(const object_ptr<const Object>& obj)
+      {
+        if (auto it = m_invariant.find(obj.get()); it != m_invariant.end())
+          return it->second;
+
+        // conservative placeholder for cyclic graph
+        m_invariant.emplace(obj.get(), false);
+
+        auto ret = [&] {
+          if (auto apply = value_cast_if<Apply>(obj)) {
+            auto& storage = _get_storage(*apply);
+            if (storage.is_result())
+              return is_invariant(storage.get_result());
+            return is_invariant(storage.app()) && is_invariant(storage.arg());
+          }
+
+          if (auto closure = value_cast_if<Closure<>>(obj))
+            return !closure->is_pap()
+                   && closure->has_attributes(
+                     closure_attributes::pure
+                     | closure_attributes::forward_last_arg);
+
+          // variables depend on context, lambdas are not analyzed.
+          if (value_cast_if<Lambda>(obj) || value_cast_if<Variable>(obj))
+            return false;
+
+          // values
+          return true;
+        }();
+
+        m_invariant[obj.get()] = ret;
+        return ret;
+      }
+
+      /// Rebuild term
+      auto rebuild(const object_ptr<const Object>& obj)
+        -> object_ptr<const Object>
+      {
+        if (auto it = m_rebuilt.find(obj.get()); it != m_rebuilt.end())
+          return it->second;
+
+        auto ret = [&]() -> object_ptr<const Object> {
+          if (auto apply = value_cast_if<Apply>(obj)) {
+
+            auto& storage = _get_storage(*apply);
+
+            if (storage.is_result())
+              return obj;
+
+            if (is_invariant(obj)) {
+              // signal which waits only for frame demand
+              auto [depth, bottom] = detail::inspect_spine(obj);
+              if (auto c = value_cast_if<Closure<>>(bottom))
+                if (c->arity == depth + 1)
+                  return make_object<Apply>(
+                    make_object<Memo>(m_table, m_table->add()), obj);
+              // partially applied: look for memoizable arguments
+            }
+
+            auto app = rebuild(storage.app());
+            auto arg = rebuild(storage.arg());
+
+            if (app == storage.app() && arg == storage.arg())
+              return obj;
+
+            return make_object<Apply>(std::move(app), std::move(arg));
+          }
+
+          if (auto lambda = value_cast_if<Lambda>(obj)) {
+
+            auto& storage = _get_storage(*lambda);
+            auto body     = rebuild(storage.body);
+
+            if (body == storage.body)
+              return obj;
+
+            return make_object<Lambda>(storage.var, std::move(body));
+          }
+
+          return obj;
+        }();
+
+        m_rebuilt.emplace(obj.get(), ret);
+        return ret;
+      }
+    };
+
+    /// Find maximal pure subterms waiting for frame demand and wrap them with
+    /// cache point, so results are reused when the same frame time is
+    /// executed again.
+    class cache_signals
+    {
+      std::shared_ptr<signal_cache> m_cache;
+      purity m_pure;
+      std::map<const Object*, uint64_t> m_hash;
+      std::map<const Object*, object_ptr<const Object>> m_rebuilt;
+
+      /// Structural hash of term.
+      /// Leaves are identified by address, which is stable in executable.
+      auto hash(const object_ptr<const Object>& obj) -> uint64_t
+      {
+        if (auto it = m_hash.find(obj.get()); it != m_hash.end())
+          return it->second;
+
+        auto ret = [&]() -> uint64_t {
+          if (auto apply = value_cast_if<Apply>(obj)) {
+            auto& storage = _get_storage(*apply);
+            if (storage.is_result())
+              return hash(storage.get_result());
+            auto h = hash(storage.app());
+            return h
+                   ^ (hash(storage.arg()) + 0x9e3779b97f4a7c15 + (h << 6)
+                      + (h >> 2));
+          }
+          return std::hash<const void*>()(obj.get());
+        }();
+
+        m_hash.emplace(obj.get(), ret);
+        return ret;
+      }
+
+    public:
+      cache_signals(std::shared_ptr<signal_cache> cache)
+        : m_cache {std::move(cache)}
+      {
+      }
+
+      /// Rebuild term
+      auto rebuild(const object_ptr<const Object>& obj)
+        -> object_ptr<const Object>
+      {
+        if (auto it = m_rebuilt.find(obj.get()); it != m_rebuilt.end())
+          return it->second;
+
+        auto ret = [&]() -> object_ptr<const Object> {
+          if (auto apply = value_cast_if<Apply>(obj)) {
+
+            auto& storage = _get_storage(*apply);
+
+            if (storage.is_result())
+              return obj;
+
+            auto [depth, bottom] = detail::inspect_spine(obj);
+            auto closure         = value_cast_if<Closure<>>(bottom);
+
+            // time invariant terms are already memoized
+            auto memo = closure
+                        && closure->get_info_table()->code
+                             == &detail::vtbl_code_func<Memo>;
+
+            if (closure && closure->arity == depth + 1 && m_pure(obj)) {
+              if (memo)
+                return obj;
+              return make_object<Apply>(
+                make_cache_point(m_cache, hash(obj)), obj);
+            }
+
+            auto app = rebuild(storage.app());
+            auto arg = rebuild(storage.arg());
+
+            if (app == storage.app() && arg == storage.arg())
+              return obj;
+
+            return make_object<Apply>(std::move(app), std::move(arg));
+          }
+
+          if (auto lambda = value_cast_if<Lambda>(obj)) {
+
+            auto& storage = _get_storage(*lambda);
+            auto body     = rebuild(storage.body);
+
+            if (body == storage.body)
+              return obj;
+
+            return make_object<Lambda>(storage.var, std::move(body));
+          }
+
+          return obj;
+        }();
+
+        m_rebuilt.emplace(obj.get(), ret);
+        return ret;
+      }
+    };
+  } // namespace
+
   void optimize(pipeline& pipe)
   {
     assert(pipe.get_data_if<message_map>("msg_map"));
     assert(pipe.get_data_if<executable>("exe"));
 
-    // TODO
+    auto& exe  = pipe.get_data<executable>("exe");
+    auto* dump = pipe.get_data_if<bool>("opt_dump");
+
+    auto obj = exe.object();
+
+    auto run = [&](const char* name, auto&& pass) {
+      auto before = dump && *dump ? count_nodes(obj) : 0;
+      obj         = pass(obj);
+      if (dump && *dump)
+        log_info("{}: {} -> {} nodes", name, before, count_nodes(obj));
+    };
+
+    run("dead args", [](auto& o) { return rewrite(o, eliminate_dead_args()); });
+    run("cse", [](auto& o) { return rewrite(o, eliminate_common_subexprs()); });
+    run("fold", [](auto& o) { return rewrite(o, fold_constants()); });
+    // memoize time invariant subgraphs across frames
+    auto table = std::make_shared<memo_table>();
+
+    run("share", [&](auto& o) { return rewrite(o, share_subterms(o, table)); });
+    run("memo", [&](auto& o) { return memoize_invariants(table).rebuild(o); });
+
+    // cache results of time variant subgraphs by frame time
+    auto cache = std::shared_ptr<signal_cache>();
+
+    if (auto p = pipe.get_data_if<std::shared_ptr<signal_cache>>("signal_cache"))
+      cache = *p;
+
+    if (cache)
+      run("cache", [&](auto& o) { return cache_signals(cache).rebuild(o); });
+
+    exe = executable(
+      std::move(obj), exe.type(), std::move(table), nullptr, std::move(cache));
   }
-} 
\ No newline at end of file
+} // namespace yave::compiler
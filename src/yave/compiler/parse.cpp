@@ -13,6 +13,7 @@
 #include <tl/optional.hpp>
 
 #include <map>
+#include <set>
 
 YAVE_DECL_LOCAL_LOGGER(parse)
 
@@ -25,6 +26,8 @@ namespace yave::compiler {
 
     using monad = tl::optional<int>;
 
+    using graph_ptr = std::shared_ptr<const structured_node_graph>;
+
     [[nodiscard]] auto pass() -> monad
     {
       return {1};
@@ -35,6 +38,45 @@ namespace yave::compiler {
       return tl::nullopt;
     }
 
+    /// Find reachable macro node
+    bool has_macro(
+      const structured_node_graph& ng,
+      const socket_handle& out_socket)
+    {
+      std::set<socket_handle> visited;
+
+      auto rec_n = [&](
+                     auto&& self,
+                     const node_handle& n,
+                     const socket_handle& s) -> bool {
+        if (!visited.insert(s).second)
+          return false;
+
+        if (ng.is_macro(n))
+          return true;
+
+        for (auto&& c : ng.input_connections(n)) {
+          auto info = ng.get_info(c);
+          if (self(info->src_node(), info->src_socket()))
+            return true;
+        }
+
+        if (ng.is_group(n)) {
+          auto go = ng.get_group_output(n);
+          auto is = ng.input_sockets(go)[*ng.get_index(s)];
+
+          for (auto&& c : ng.connections(is)) {
+            auto info = ng.get_info(c);
+            if (self(info->src_node(), info->src_socket()))
+              return true;
+          }
+        }
+        return false;
+      };
+
+      return fix_lambda(rec_n)(ng.node(out_socket), out_socket);
+    }
+
     auto macro_expand(
       structured_node_graph& ng,
       const socket_handle& out_socket,
@@ -43,6 +85,9 @@ namespace yave::compiler {
     {
       int n_expanded = 0;
 
+      // visited output sockets in current pass
+      std::set<socket_handle> visited;
+
       auto rec_m = [&](
                      auto&& self,
                      const node_handle& n,
@@ -105,6 +150,10 @@ namespace yave::compiler {
 
       auto rec_n =
         [&](auto&& self, const node_handle& n, const socket_handle& s) -> void {
+        // output shared by multiple consumers
+        if (!visited.insert(s).second)
+          return;
+
         if (ng.is_group(n))
           return rec_g(self, n, s);
 
@@ -139,6 +188,7 @@ namespace yave::compiler {
         }
 
         auto count = n_expanded;
+        visited.clear();
 
         try {
           rec(out_node, out_socket);
@@ -158,7 +208,7 @@ namespace yave::compiler {
     }
 
     auto check(
-      structured_node_graph& ng,
+      const structured_node_graph& ng,
       const socket_handle& out_socket,
       message_map& msgs) -> monad
     {
@@ -340,6 +390,10 @@ namespace yave::compiler {
                      const node_handle& n,
                      const socket_handle& os,
                      const structured_node_graph& ng) -> void {
+        // output shared by multiple consumers
+        if (marked(n, os))
+          return;
+
         if (ng.is_group(n))
           return rec_g(self, n, os, ng);
 
@@ -369,18 +423,30 @@ namespace yave::compiler {
   void parse(pipeline& pipe)
   {
     assert(pipe.get_data_if<message_map>("msg_map"));
-    assert(pipe.get_data_if<structured_node_graph>("ng"));
+    assert(pipe.get_data_if<graph_ptr>("ng"));
     assert(pipe.get_data_if<socket_handle>("os"));
     assert(pipe.get_data_if<node_declaration_map>("decls"));
 
     auto& msg_map = pipe.get_data<message_map>("msg_map");
-    auto& ng      = pipe.get_data<structured_node_graph>("ng");
+    auto& ng      = pipe.get_data<graph_ptr>("ng");
     auto& os      = pipe.get_data<socket_handle>("os");
     auto& decls   = pipe.get_data<node_declaration_map>("decls");
 
+    // input graph can be shared, so expand macros in a copy
+    auto expand = [&]() -> monad {
+      if (!has_macro(*ng, os))
+        return pass();
+
+      auto copy = std::make_shared<structured_node_graph>(ng->clone());
+      os        = copy->socket(os.id());
+      ng        = copy;
+
+      return macro_expand(*copy, os, decls, msg_map);
+    };
+
     pass() //
-      .and_then([&](auto) { return macro_expand(ng, os, decls, msg_map); })
-      .and_then([&](auto) { return check(ng, os, msg_map); })
+      .and_then([&](auto) { return expand(); })
+      .and_then([&](auto) { return check(*ng, os, msg_map); })
       .or_else([&] { pipe.set_failed(); });
   }
 }
\ No newline at end of file
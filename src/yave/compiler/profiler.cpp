@@ -0,0 +1,158 @@
+//
+// Copyright (c) 2019 mocabe (https://github.com/mocabe)
+// Distributed under LGPLv3 License. See LICENSE for more details.
+//
+
+#include <yave/compiler/profiler.hpp>
+#include <yave/rts/rts.hpp>
+
+namespace yave::compiler {
+
+  auto node_profiler::add(const node_handle& node) -> size_t
+  {
+    auto lck = std::unique_lock(m_mtx);
+
+    auto [it, inserted] = m_index.try_emplace(node.id(), m_costs.size());
+
+    if (inserted)
+      m_costs.push_back({.node = node.id()});
+
+    return it->second;
+  }
+
+  void node_profiler::record(
+    size_t idx,
+    std::chrono::nanoseconds time,
+    uint64_t allocs)
+  {
+    auto lck = std::unique_lock(m_mtx);
+    assert(idx < m_costs.size());
+    auto& cost = m_costs[idx];
+    cost.calls += 1;
+    cost.time += time;
+    cost.allocations += allocs;
+  }
+
+  auto node_profiler::results() const -> std::vector<node_cost>
+  {
+    auto lck = std::unique_lock(m_mtx);
+    return {m_costs.begin(), m_costs.end()};
+  }
+
+  auto node_profiler::take() -> std::vector<node_cost>
+  {
+    auto lck = std::unique_lock(m_mtx);
+    auto ret = std::vector<node_cost>(m_costs.begin(), m_costs.end());
+    for (auto&& c : m_costs)
+      c = {.node = c.node};
+    return ret;
+  }
+
+  void node_profiler::reset()
+  {
+    auto lck = std::unique_lock(m_mtx);
+    for (auto&& c : m_costs)
+      c = {.node = c.node};
+  }
+
+  auto node_profiler::size() const -> size_t
+  {
+    auto lck = std::unique_lock(m_mtx);
+    return m_costs.size();
+  }
+
+  namespace {
+
+    /// Probe currently evaluated on this thread.
+    struct probe_frame
+    {
+      probe_frame* parent = nullptr;
+      /// cost of nested probes
+      std::chrono::nanoseconds child_time = {};
+      uint64_t child_allocs               = 0;
+    };
+
+    thread_local probe_frame* current_probe = nullptr;
+
+    /// Measures cost of probe until end of scope.
+    class probe_scope
+    {
+      node_profiler& m_profiler;
+      size_t m_index;
+      probe_frame m_frame;
+      uint64_t m_allocs;
+      std::chrono::steady_clock::time_point m_begin;
+
+    public:
+      probe_scope(node_profiler& profiler, size_t index)
+        : m_profiler {profiler}
+        , m_index {index}
+        , m_frame {current_probe}
+        , m_allocs {detail::object_allocations}
+        , m_begin {std::chrono::steady_clock::now()}
+      {
+        current_probe = &m_frame;
+      }
+
+      ~probe_scope() noexcept
+      {
+        auto time   = std::chrono::steady_clock::now() - m_begin;
+        auto allocs = detail::object_allocations - m_allocs;
+
+        current_probe = m_frame.parent;
+
+        if (auto p = m_frame.parent) {
+          p->child_time += time;
+          p->child_allocs += allocs;
+        }
+
+        // nested probes evaluated on other threads of task pool are not
+        // subtracted, so time spent waiting for them is included.
+        m_profiler.record(
+          m_index, time - m_frame.child_time, allocs - m_frame.child_allocs);
+      }
+
+      probe_scope(const probe_scope&) = delete;
+      probe_scope& operator=(const probe_scope&) = delete;
+    };
+
+    class Probe_X;
+    class Probe_Y;
+
+    /// Probe f x = f x, but records cost of evaluation to profiler.
+    /// Does not affect analysis of optimizer: purity and time invariance of
+    /// probed term only depend on f.
+    struct Probe
+      : Function<Probe, closure<Probe_X, Probe_Y>, Probe_X, Probe_Y>
+    {
+      static constexpr auto _attributes =
+        closure_attributes::pure | closure_attributes::forward_last_arg;
+
+      Probe(std::shared_ptr<node_profiler> profiler, size_t index)
+        : m_profiler {std::move(profiler)}
+        , m_index {index}
+      {
+      }
+
+      auto code() const -> return_type
+      {
+        auto scope = probe_scope(*m_profiler, m_index);
+        return static_object_cast<const VarValueProxy<Probe_Y>>(
+          eval(arg<0>() << arg<1>()));
+      }
+
+    private:
+      std::shared_ptr<node_profiler> m_profiler;
+      size_t m_index;
+    };
+  } // namespace
+
+  auto make_probe(
+    const std::shared_ptr<node_profiler>& profiler,
+    const node_handle& node) -> object_ptr<const Object>
+  {
+    assert(profiler);
+    return make_object<Probe>(profiler, profiler->add(node));
+  }
+
+} // namespace yave::compiler
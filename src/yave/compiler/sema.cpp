@@ -7,8 +7,10 @@
 #include <yave/compiler/message.hpp>
 #include <yave/compiler/executable.hpp>
 #include <yave/compiler/location.hpp>
+#include <yave/compiler/sema_cache.hpp>
 #include <yave/compiler/typecheck.hpp>
 #include <yave/compiler/argument_holder.hpp>
+#include <yave/compiler/profiler.hpp>
 #include <yave/node/core/socket_instance_manager.hpp>
 #include <yave/node/core/node_definition.hpp>
 #include <yave/node/core/node_declaration.hpp>
@@ -22,6 +24,8 @@
 #include <yave/node/core/node_definition_store.hpp>
 
 #include <functional>
+#include <map>
+#include <set>
 
 #include <range/v3/algorithm.hpp>
 #include <range/v3/view.hpp>
@@ -37,6 +41,9 @@ namespace yave::compiler {
 
     using namespace std::literals::string_literals;
 
+    using graph_ptr = std::shared_ptr<const structured_node_graph>;
+    using graph_ref = std::reference_wrapper<const structured_node_graph>;
+
     using arg_holder_map_t =
       std::map<socket_handle, object_ptr<NodeArgumentHolder>>;
 
@@ -56,12 +63,105 @@ namespace yave::compiler {
       return nullptr;
     }
 
+    /// state of incremental compilation
+    struct incremental_state
+    {
+      /// results of previous compilation (optional)
+      sema_cache* cache = nullptr;
+      /// structural hash of visited output sockets
+      std::map<socket_handle, size_t> hashes;
+      /// subtrees to reuse and record
+      typing_cache typing;
+      /// list of (socket, hash, subtree) generated in this compilation
+      std::vector<std::tuple<uid, size_t, object_ptr<const Object>>> pending;
+      /// entries reused in this compilation
+      std::map<uid, sema_cache::entry> reused;
+    };
+
+    void hash_combine(size_t& seed, size_t v)
+    {
+      seed ^= v + 0x9e3779b97f4a7c15 + (seed << 6) + (seed >> 2);
+    }
+
+    /// Calculate structural hash of subgraph which generates output socket.
+    /// Hash covers everything gen() reads from the graph, so subtree of
+    /// matching hash can be reused.
+    auto structural_hash(
+      const structured_node_graph& ng,
+      const socket_handle& os,
+      const node_definition_map& defs,
+      const arg_holder_map_t& arg_map,
+      std::map<socket_handle, size_t>& hashes) -> size_t
+    {
+      auto hash_id = [](const auto& h) {
+        return std::hash<uint64_t>()(h.id().data);
+      };
+
+      // inputs of function or group
+      auto hash_inputs = [&](auto&& rec, const auto& n, size_t& h) {
+        for (auto&& s : ng.input_sockets(n)) {
+
+          if (get_arg_holder(arg_map, s)) {
+            // value of argument is updated without recompile
+            auto prop = get_arg_property(s, ng);
+            hash_combine(h, std::hash<const void*>()(prop.get()));
+            continue;
+          }
+
+          auto cs = ng.connections(s);
+
+          if (cs.empty()) {
+            hash_combine(h, 0);
+            continue;
+          }
+
+          auto ci = ng.get_info(cs[0]);
+          hash_combine(h, rec(ci->src_node(), ci->src_socket()));
+        }
+      };
+
+      auto rec_n = [&](auto&& self, const auto& n, const auto& os) -> size_t {
+        if (auto it = hashes.find(os); it != hashes.end())
+          return it->second;
+
+        auto h = hash_id(n);
+        hash_combine(h, *ng.get_index(os));
+
+        if (ng.is_group(n)) {
+          hash_inputs(self, n, h);
+
+          auto go = ng.get_group_output(n);
+          auto s  = ng.input_sockets(go)[*ng.get_index(os)];
+          for (auto&& c : ng.connections(s)) {
+            auto ci = ng.get_info(c);
+            hash_combine(h, self(ci->src_node(), ci->src_socket()));
+          }
+        }
+
+        if (ng.is_function(n)) {
+          auto defcall = ng.get_definition(n);
+          hash_combine(h, hash_id(defcall));
+
+          for (auto&& d :
+               defs.get_binds(*ng.get_path(defcall), *ng.get_index(os)))
+            hash_combine(h, std::hash<const void*>()(d->instance().get()));
+
+          hash_inputs(self, n, h);
+        }
+
+        hashes.emplace(os, h);
+        return h;
+      };
+
+      return fix_lambda(rec_n)(ng.node(os), os);
+    }
+
     auto desugar(
-      structured_node_graph&& ng,
+      const structured_node_graph& ng,
       const socket_handle& os,
       const node_declaration_map& decls,
       arg_holder_map_t& arg_map,
-      message_map& /*msgs*/) -> tl::optional<structured_node_graph>
+      message_map& /*msgs*/) -> tl::optional<graph_ref>
     {
       auto root   = ng.node(os);
       auto rootos = os;
@@ -124,8 +224,15 @@ namespace yave::compiler {
         }
       };
 
+      // visited output sockets
+      std::set<socket_handle> visited;
+
       // general
       auto rec_n = [&](auto&& self, const auto& n, const auto& os) {
+        // output shared by multiple consumers
+        if (!visited.insert(os).second)
+          return;
+
         if (ng.is_group(n))
           return rec_g(self, n, os);
 
@@ -141,14 +248,16 @@ namespace yave::compiler {
       auto rec = fix_lambda(rec_n);
       rec(root, rootos);
 
-      return std::move(ng);
+      return std::cref(ng);
     }
 
     auto gen(
-      structured_node_graph&& ng,
+      const structured_node_graph& ng,
       const socket_handle& os,
       const node_definition_map& defs,
       arg_holder_map_t& arg_map,
+      incremental_state& inc,
+      const std::shared_ptr<node_profiler>& profiler,
       message_map& msgs)
       -> tl::optional<
         std::tuple<object_ptr<const Object>, class_env, location_map>>
@@ -265,25 +374,93 @@ namespace yave::compiler {
           loc.add_location(body, os);
         }
 
+        // record cost of node output
+        if (profiler) {
+          body = make_probe(profiler, f) << body;
+          loc.add_location(body, os);
+        }
+
         return body;
       };
 
+      // subtrees which depend on inputs of enclosing group
+      std::set<const Object*> open;
+      // number of references to open subtrees
+      size_t n_open = 0;
+
       // group input
       auto rec_i = [&](const auto& os, const auto& in) {
         auto idx = *ng.get_index(os);
         auto ret = in[idx];
         loc.add_location(ret, os);
+
+        if (open.contains(ret.get()) || has_type<Variable>(ret))
+          ++n_open;
+
+        return ret;
+      };
+
+      // function or group
+      auto rec_c = [&](
+                     auto&& self,
+                     const auto& n,
+                     const auto& os,
+                     const auto& in) -> object_ptr<const Object> {
+        if (!inc.cache)
+          return ng.is_group(n) ? rec_g(self, n, os, in)
+                                : rec_f(self, n, os, in);
+
+        auto hash = structural_hash(ng, os, defs, arg_map, inc.hashes);
+
+        // reuse subtree of previous compilation
+        if (auto e = inc.cache->find(os.id(), hash)) {
+          loc.add_location(e->obj, os);
+          inc.typing.known.emplace(e->obj.get(), e->type);
+          inc.reused.emplace(os.id(), *e);
+          return e->obj;
+        }
+
+        auto cnt = n_open;
+        auto ret = ng.is_group(n) ? rec_g(self, n, os, in)
+                                  : rec_f(self, n, os, in);
+
+        if (n_open != cnt) {
+          open.insert(ret.get());
+          return ret;
+        }
+
+        // closed subtree can be cached
+        if (has_type<Apply>(ret)) {
+          inc.typing.record.try_emplace(ret.get());
+          inc.pending.emplace_back(os.id(), hash, ret);
+        }
         return ret;
       };
 
+      // generated subtrees.
+      // map of ((output socket, inputs of enclosing group), subtree)
+      std::map<
+        std::pair<socket_handle, std::vector<object_ptr<const Object>>>,
+        object_ptr<const Object>>
+        generated;
+
       // general
       auto rec_n =
         [&](auto&& self, const auto& n, const auto& os, const auto& in) {
-          if (ng.is_group(n))
-            return rec_g(self, n, os, in);
-
-          if (ng.is_function(n))
-            return rec_f(self, n, os, in);
+          if (ng.is_group(n) || ng.is_function(n)) {
+
+            // share subtree between consumers of same output
+            auto key = std::make_pair(os, in);
+            if (auto it = generated.find(key); it != generated.end()) {
+              if (open.contains(it->second.get()))
+                ++n_open;
+              return it->second;
+            }
+
+            auto ret = rec_c(self, n, os, in);
+            generated.emplace(std::move(key), ret);
+            return ret;
+          }
 
           if (ng.is_group_input(n))
             return rec_i(os, in);
@@ -313,13 +490,19 @@ namespace yave::compiler {
 
     auto type(
       std::tuple<object_ptr<const Object>, class_env, location_map>&& p,
+      incremental_state& inc,
+      typecheck_backend backend,
+      typed_ir& ir,
       message_map& msgs) -> tl::optional<executable>
     {
       try {
 
         auto [app, env, loc] = std::move(p);
         auto [ty, app2] =
-          type_of_overloaded(app, std::move(env), std::move(loc));
+          inc.cache ? type_of_overloaded(
+            app, std::move(env), std::move(loc), inc.typing, backend, &ir)
+                    : type_of_overloaded(
+                      app, std::move(env), std::move(loc), backend, &ir);
 
         return executable(app2, ty);
 
@@ -338,9 +521,40 @@ namespace yave::compiler {
       return tl::nullopt;
     }
 
-    auto output(executable&& exe, pipeline& pipe)
+    /// Update cache for next compilation
+    auto update_cache(executable&& exe, incremental_state& inc)
+    {
+      if (!inc.cache)
+        return tl::optional(std::move(exe));
+
+      auto entries = std::move(inc.reused);
+
+      for (auto&& [id, hash, obj] : inc.pending) {
+        auto& [resolved, type] = inc.typing.record.at(obj.get());
+        if (resolved && type)
+          entries.insert_or_assign(
+            id, sema_cache::entry {hash, resolved, type});
+      }
+
+      // keep valid entries in reused subtrees
+      for (auto&& [s, hash] : inc.hashes) {
+        if (!entries.contains(s.id()))
+          if (auto e = inc.cache->find(s.id(), hash))
+            entries.emplace(s.id(), *e);
+      }
+
+      inc.cache->reset(std::move(entries));
+
+      return tl::optional(std::move(exe));
+    }
+
+    auto output(executable&& exe, typed_ir&& ir, pipeline& pipe)
     {
       pipe.add_data("exe", std::move(exe));
+
+      if (ir.object())
+        pipe.add_data("typed_ir", std::move(ir));
+
       return tl::optional(true);
     }
 
@@ -349,25 +563,45 @@ namespace yave::compiler {
   void sema(pipeline& pipe)
   {
     assert(pipe.get_data_if<message_map>("msg_map"));
-    assert(pipe.get_data_if<structured_node_graph>("ng"));
+    assert(pipe.get_data_if<graph_ptr>("ng"));
     assert(pipe.get_data_if<socket_handle>("os"));
     assert(pipe.get_data_if<node_definition_map>("defs"));
     assert(pipe.get_data_if<node_declaration_map>("decls"));
 
     auto& msg_map = pipe.get_data<message_map>("msg_map");
-    auto& ng      = pipe.get_data<structured_node_graph>("ng");
+    auto& ng      = pipe.get_data<graph_ptr>("ng");
     auto& os      = pipe.get_data<socket_handle>("os");
     auto& defs    = pipe.get_data<node_definition_map>("defs");
     auto& decls   = pipe.get_data<node_declaration_map>("decls");
 
     auto arg_map = arg_holder_map_t();
+    auto inc     = incremental_state();
+
+    using cache_ptr = std::shared_ptr<sema_cache>;
+
+    auto profiler = std::shared_ptr<node_profiler>();
+
+    if (auto p = pipe.get_data_if<std::shared_ptr<node_profiler>>("profiler"))
+      profiler = *p;
+
+    // cached subtrees do not have probes
+    if (auto cache = pipe.get_data_if<cache_ptr>("sema_cache"))
+      if (!profiler)
+        inc.cache = cache->get();
+
+    auto backend = typecheck_backend::union_find;
+    auto ir      = typed_ir();
+
+    if (auto b = pipe.get_data_if<typecheck_backend>("typecheck_backend"))
+      backend = *b;
 
     // clang-format off
-    tl::make_optional(std::move(ng)) //
-      .and_then([&](auto arg) { return desugar(std::move(arg), os, decls, arg_map, msg_map); })
-      .and_then([&](auto arg) { return gen(std::move(arg), os, defs, arg_map, msg_map); })
-      .and_then([&](auto arg) { return type(std::move(arg), msg_map); })
-      .and_then([&](auto arg) { return output(std::move(arg), pipe); })
+    tl::make_optional(std::cref(*ng)) //
+      .and_then([&](auto arg) { return desugar(arg, os, decls, arg_map, msg_map); })
+      .and_then([&](auto arg) { return gen(arg, os, defs, arg_map, inc, profiler, msg_map); })
+      .and_then([&](auto arg) { return type(std::move(arg), inc, backend, ir, msg_map); })
+      .and_then([&](auto arg) { return update_cache(std::move(arg), inc); })
+      .and_then([&](auto arg) { return output(std::move(arg), std::move(ir), pipe); })
       .or_else([&] { pipe.set_failed(); });
     // clang-format on
 
@@ -0,0 +1,33 @@
+//
+// Copyright (c) 2019 mocabe (https://github.com/mocabe)
+// Distributed under LGPLv3 License. See LICENSE for more details.
+//
+
+#include <yave/compiler/sema_cache.hpp>
+
+namespace yave::compiler {
+
+  auto sema_cache::find(const uid& id, size_t hash) const -> const entry*
+  {
+    if (auto it = m_entries.find(id); it != m_entries.end()) {
+      if (it->second.hash == hash)
+        return &it->second;
+    }
+    return nullptr;
+  }
+
+  void sema_cache::reset(std::map<uid, entry> entries)
+  {
+    m_entries = std::move(entries);
+  }
+
+  void sema_cache::clear()
+  {
+    m_entries.clear();
+  }
+
+  auto sema_cache::size() const -> size_t
+  {
+    return m_entries.size();
+  }
+} // namespace yave::compiler
@@ -0,0 +1,200 @@
+//
+// Copyright (c) 2019 mocabe (https://github.com/mocabe)
+// Distributed under LGPLv3 License. See LICENSE for more details.
+//
+
+#include <yave/compiler/signal_cache.hpp>
+#include <yave/obj/frame_demand/frame_demand.hpp>
+#include <yave/obj/frame_buffer/frame_buffer.hpp>
+#include <yave/rts/rts.hpp>
+#include <yave/rts/frame_arena.hpp>
+
+namespace yave::compiler {
+
+  signal_cache::signal_cache(size_t budget)
+    : m_budget {budget}
+  {
+  }
+
+  auto signal_cache::key_hash::operator()(const key& k) const noexcept
+    -> size_t
+  {
+    auto h = std::hash<uint64_t>()(k.hash);
+    return h ^ (std::hash<int64_t>()(k.t) + 0x9e3779b97f4a7c15 + (h << 6)
+                + (h >> 2));
+  }
+
+  auto signal_cache::get(uint64_t hash, const time& t)
+    -> object_ptr<const Object>
+  {
+    auto lck = std::unique_lock(m_mtx);
+
+    auto it = m_index.find({hash, t.count()});
+
+    if (it == m_index.end()) {
+      ++m_misses;
+      return nullptr;
+    }
+
+    ++m_hits;
+
+    // move to front
+    m_entries.splice(m_entries.begin(), m_entries, it->second);
+    return it->second->obj;
+  }
+
+  void signal_cache::set(
+    uint64_t hash,
+    const time& t,
+    object_ptr<const Object> obj)
+  {
+    // results are shared between threads and frames
+    frame_arena::instance().share();
+
+    auto cost = cost_of(obj);
+
+    // destroy results outside of lock
+    auto evicted = std::list<entry>();
+    auto lck     = std::unique_lock(m_mtx);
+
+    if (cost > m_budget)
+      return;
+
+    auto k = key {hash, t.count()};
+
+    if (auto it = m_index.find(k); it != m_index.end()) {
+      m_usage -= it->second->cost;
+      evicted.splice(evicted.begin(), m_entries, it->second);
+      m_index.erase(it);
+    }
+
+    m_entries.push_front({k, std::move(obj), cost});
+    m_index.emplace(k, m_entries.begin());
+    m_usage += cost;
+
+    evict(evicted);
+  }
+
+  void signal_cache::evict(std::list<entry>& evicted)
+  {
+    while (m_usage > m_budget && !m_entries.empty()) {
+      auto last = std::prev(m_entries.end());
+      m_usage -= last->cost;
+      m_index.erase(last->k);
+      evicted.splice(evicted.begin(), m_entries, last);
+    }
+  }
+
+  void signal_cache::clear()
+  {
+    auto tmp = std::list<entry>();
+    {
+      auto lck = std::unique_lock(m_mtx);
+      m_entries.swap(tmp);
+      m_index.clear();
+      m_usage = 0;
+    }
+  }
+
+  auto signal_cache::budget() const -> size_t
+  {
+    auto lck = std::unique_lock(m_mtx);
+    return m_budget;
+  }
+
+  void signal_cache::set_budget(size_t bytes)
+  {
+    auto evicted = std::list<entry>();
+    {
+      auto lck = std::unique_lock(m_mtx);
+      m_budget = bytes;
+      evict(evicted);
+    }
+  }
+
+  auto signal_cache::usage() const -> size_t
+  {
+    auto lck = std::unique_lock(m_mtx);
+    return m_usage;
+  }
+
+  auto signal_cache::size() const -> size_t
+  {
+    auto lck = std::unique_lock(m_mtx);
+    return m_entries.size();
+  }
+
+  auto signal_cache::hits() const -> uint64_t
+  {
+    auto lck = std::unique_lock(m_mtx);
+    return m_hits;
+  }
+
+  auto signal_cache::misses() const -> uint64_t
+  {
+    auto lck = std::unique_lock(m_mtx);
+    return m_misses;
+  }
+
+  auto signal_cache::cost_of(const object_ptr<const Object>& obj) -> size_t
+  {
+    auto size = get_size(obj);
+
+    // pixels live in buffer pool
+    if (auto fb = value_cast_if<FrameBuffer>(obj))
+      size += fb->byte_size();
+
+    return size;
+  }
+
+  namespace {
+
+    class Cache_X;
+    class Cache_Y;
+
+    /// Cache f x = f x, but result is looked up from signal cache by time of
+    /// frame demand x.
+    struct Cache
+      : Function<Cache, closure<Cache_X, Cache_Y>, Cache_X, Cache_Y>
+    {
+      static constexpr auto _attributes =
+        closure_attributes::pure | closure_attributes::forward_last_arg;
+
+      Cache(std::shared_ptr<signal_cache> cache, uint64_t hash)
+        : m_cache {std::move(cache)}
+        , m_hash {hash}
+      {
+      }
+
+      auto code() const -> return_type
+      {
+        auto x      = eval_arg<1>();
+        auto demand = value_cast_if<FrameDemand>(object_ptr<const Object>(x));
+
+        if (!demand)
+          return static_object_cast<const VarValueProxy<Cache_Y>>(
+            eval(arg<0>() << x));
+
+        if (auto result = m_cache->get(m_hash, *demand->time))
+          return static_object_cast<const VarValueProxy<Cache_Y>>(result);
+
+        auto result = eval(arg<0>() << x);
+        m_cache->set(m_hash, *demand->time, result);
+        return static_object_cast<const VarValueProxy<Cache_Y>>(result);
+      }
+
+    private:
+      std::shared_ptr<signal_cache> m_cache;
+      uint64_t m_hash;
+    };
+  } // namespace
+
+  auto make_cache_point(
+    const std::shared_ptr<signal_cache>& cache,
+    uint64_t hash) -> object_ptr<const Object>
+  {
+    assert(cache);
+    return make_object<Cache>(cache, hash);
+  }
+
+} // namespace yave::compiler
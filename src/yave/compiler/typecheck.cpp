@@ -7,6 +7,11 @@
 #include <yave/compiler/message.hpp>
 #include <yave/rts/value_cast.hpp>
 
+#include <algorithm>
+#include <unordered_map>
+#include <unordered_set>
+#include <utility>
+
 namespace yave::compiler {
 
   auto class_env::add_overloading(
@@ -119,6 +124,9 @@ namespace yave::compiler {
       /// map of (overloaded, instance)
       std::map<object_ptr<const Object>, object_ptr<const Object>> results;
 
+      /// subtree cache (optional)
+      typing_cache* cache = nullptr;
+
       /// Create new type variable
       /// \param src located object of which location will be propagated to new
       /// type variable.
@@ -175,6 +183,31 @@ namespace yave::compiler {
       }
     };
 
+    /// Convert type error being handled into compile error message.
+    [[noreturn]] void rethrow_type_error(const location_map& locations)
+    {
+      try {
+        throw;
+      } catch (type_error::type_missmatch& e) {
+        // FIXME: get_souce_id() should be used
+        throw message(type_missmatch(
+          locations.locate(e.expected()).id(),
+          locations.locate(e.provided()).id(),
+          e.expected(),
+          e.provided()));
+      } catch (type_error::unsolvable_constraints& e) {
+        // FIXME: get_souce_id() should be used
+        throw message(unsolvable_constraints(
+          locations.locate(e.t1()).id(),
+          locations.locate(e.t2()).id(),
+          e.t1(),
+          e.t2()));
+      } catch (type_error::type_error& e) {
+        // TODO catch other type errors
+        throw message(unexpected_type_error("Internal type error"));
+      }
+    }
+
     // ------------------------------------------
     // type_of_overloaded
 
@@ -256,6 +289,15 @@ namespace yave::compiler {
       const object_ptr<const Object>& obj,
       overloading_env& env) -> object_ptr<const Type>
     {
+      // reused subtree
+      if (env.cache) {
+        if (auto it = env.cache->known.find(obj.get());
+            it != env.cache->known.end()) {
+          env.locations.add_location(it->second, env.locations.locate(obj));
+          return it->second;
+        }
+      }
+
       // Apply
       if (auto apply = value_cast_if<Apply>(obj)) {
 
@@ -284,25 +326,17 @@ namespace yave::compiler {
           if (vars(env.envA).empty())
             ty = close_assumption(env, ty);
 
+          // monomorphic type will not be changed by later substitutions
+          if (env.cache && vars(ty).empty()) {
+            if (auto it = env.cache->record.find(obj.get());
+                it != env.cache->record.end())
+              it->second.second = ty;
+          }
+
           return ty;
 
-        } catch (type_error::type_missmatch& e) {
-          // FIXME: get_souce_id() should be used
-          throw message(type_missmatch(
-            env.locations.locate(e.expected()).id(),
-            env.locations.locate(e.provided()).id(),
-            e.expected(),
-            e.provided()));
-        } catch (type_error::unsolvable_constraints& e) {
-          // FIXME: get_souce_id() should be used
-          throw message(unsolvable_constraints(
-            env.locations.locate(e.t1()).id(),
-            env.locations.locate(e.t2()).id(),
-            e.t1(),
-            e.t2()));
-        } catch (type_error::type_error& e) {
-          // TODO catch other type errors
-          throw message(unexpected_type_error("Internal type error"));
+        } catch (type_error::type_error&) {
+          rethrow_type_error(env.locations);
         }
       }
 
@@ -362,6 +396,10 @@ namespace yave::compiler {
     }
 
     auto rebuild_overloads(
+      const object_ptr<const Object>& obj,
+      const overloading_env& env) -> object_ptr<const Object>;
+
+    auto rebuild_overloads_impl(
       const object_ptr<const Object>& obj,
       const overloading_env& env) -> object_ptr<const Object>
     {
@@ -396,18 +434,935 @@ namespace yave::compiler {
 
       return obj;
     }
+
+    auto rebuild_overloads(
+      const object_ptr<const Object>& obj,
+      const overloading_env& env) -> object_ptr<const Object>
+    {
+      if (!env.cache)
+        return rebuild_overloads_impl(obj, env);
+
+      // already resolved
+      if (env.cache->known.contains(obj.get()))
+        return obj;
+
+      // record resolved subtree
+      if (auto it = env.cache->record.find(obj.get());
+          it != env.cache->record.end() && it->second.second) {
+
+        if (!it->second.first)
+          it->second.first = rebuild_overloads_impl(obj, env);
+
+        return it->second.first;
+      }
+      return rebuild_overloads_impl(obj, env);
+    }
+
+    /// Copy subtrees shared in apply graph.
+    /// overloading_env identifies nodes by address, so each use of shared
+    /// subtree should be typed as separated node.
+    auto unshare(
+      const object_ptr<const Object>& obj,
+      location_map& loc,
+      const typing_cache* cache,
+      std::unordered_set<const Object*>& visited) -> object_ptr<const Object>
+    {
+      // reused subtree
+      if (cache && cache->known.contains(obj.get()))
+        return obj;
+
+      auto first = visited.insert(obj.get()).second;
+
+      if (auto apply = value_cast_if<Apply>(obj)) {
+        auto& storage = _get_storage(*apply);
+
+        if (storage.is_result())
+          return obj;
+
+        auto app = unshare(storage.app(), loc, cache, visited);
+        auto arg = unshare(storage.arg(), loc, cache, visited);
+
+        if (first && app == storage.app() && arg == storage.arg())
+          return obj;
+
+        auto ret = make_object<Apply>(app, arg);
+        loc.add_location(ret, loc.locate(obj));
+        return ret;
+      }
+
+      if (auto lambda = value_cast_if<Lambda>(obj)) {
+        auto& storage = _get_storage(*lambda);
+
+        auto body = unshare(storage.body, loc, cache, visited);
+
+        if (first && body == storage.body)
+          return obj;
+
+        auto ret = make_object<Lambda>(storage.var, body);
+        loc.add_location(ret, loc.locate(obj));
+        return ret;
+      }
+
+      if (auto overloaded = value_cast_if<Overloaded>(obj)) {
+
+        if (first)
+          return obj;
+
+        auto ret = make_object<Overloaded>(overloaded->id);
+        loc.add_location(ret, loc.locate(obj));
+        return ret;
+      }
+
+      return obj;
+    }
+
+    // ------------------------------------------
+    // union-find backend
+
+    /// Mutable union-find substitution.
+    /// Each type variable is bound at most once. Bindings are not applied to
+    /// other bindings eagerly, but resolved when types are inspected.
+    class uf_subst
+    {
+    public:
+      /// Follow bindings of type variable at head of type.
+      auto find(const object_ptr<const Type>& t) -> object_ptr<const Type>
+      {
+        auto var = is_tvar_type_if(t);
+        if (!var)
+          return t;
+
+        auto it = m_bind.find(var->id);
+        if (it == m_bind.end())
+          return t;
+
+        // path compression
+        it->second = find(it->second);
+        return it->second;
+      }
+
+      /// Check if type variable is bound.
+      [[nodiscard]] bool is_bound(const object_ptr<const Type>& var) const
+      {
+        return m_bind.contains(is_tvar_type_if(var)->id);
+      }
+
+      /// Apply all bindings to type.
+      auto resolve(const object_ptr<const Type>& t) -> object_ptr<const Type>
+      {
+        if (auto var = is_tvar_type_if(t)) {
+          auto it = m_bind.find(var->id);
+          if (it == m_bind.end())
+            return t;
+
+          // keep resolved type to avoid rebuilding it again
+          it->second = resolve(it->second);
+          return it->second;
+        }
+
+        if (auto ap = is_tap_type_if(t)) {
+          auto t1 = resolve(ap->t1);
+          auto t2 = resolve(ap->t2);
+          if (t1 != ap->t1 || t2 != ap->t2)
+            return make_object<Type>(tap_type {std::move(t1), std::move(t2)});
+        }
+        return t;
+      }
+
+      /// Find free type variable in type.
+      /// \returns nullptr when type has no free variable.
+      auto free_var(const object_ptr<const Type>& t) -> object_ptr<const Type>
+      {
+        auto h = find(t);
+
+        if (is_tvar_type(h))
+          return h;
+
+        if (auto ap = is_tap_type_if(h)) {
+          if (auto v = free_var(ap->t1))
+            return v;
+          return free_var(ap->t2);
+        }
+        return nullptr;
+      }
+
+      /// Unify types.
+      /// \throws type_error::type_error
+      void unify(
+        const object_ptr<const Type>& t1,
+        const object_ptr<const Type>& t2)
+      {
+        auto a = find(t1);
+        auto b = find(t2);
+
+        if (a.get() == b.get())
+          return;
+
+        if (auto ap1 = is_tap_type_if(a)) {
+          if (auto ap2 = is_tap_type_if(b)) {
+            unify(ap1->t1, ap2->t1);
+            unify(ap1->t2, ap2->t2);
+            return;
+          }
+        }
+
+        if (is_tvar_type(a))
+          return bind(a, b);
+
+        if (is_tvar_type(b))
+          return bind(b, a);
+
+        if (is_tcon_type(a) && is_tcon_type(b)) {
+          if (same_type(a, b))
+            return;
+          throw type_error::type_missmatch(a, b, nullptr);
+        }
+
+        throw type_error::unsolvable_constraints(
+          resolve(a), resolve(b), nullptr);
+      }
+
+      /// Take type variables bound since last call.
+      auto take_bound() -> std::vector<object_ptr<const Type>>
+      {
+        return std::exchange(m_bound, {});
+      }
+
+    private:
+      bool occurs(uint64_t id, const object_ptr<const Type>& t)
+      {
+        auto h = find(t);
+
+        if (auto var = is_tvar_type_if(h))
+          return var->id == id;
+
+        if (auto ap = is_tap_type_if(h))
+          return occurs(id, ap->t1) || occurs(id, ap->t2);
+
+        return false;
+      }
+
+      void bind(
+        const object_ptr<const Type>& var,
+        const object_ptr<const Type>& t)
+      {
+        if (same_type(var, t))
+          return;
+
+        auto id = is_tvar_type_if(var)->id;
+
+        if (occurs(id, t))
+          throw type_error::circular_constraint(var, nullptr);
+
+        if (!same_kind(kind_of(var), kind_of(t)))
+          throw type_error::kind_missmatch(kind_of(var), kind_of(t), nullptr);
+
+        m_bind.emplace(id, t);
+        m_bound.push_back(var);
+      }
+
+    private:
+      /// map of (variable ID, bound type)
+      std::unordered_map<uint64_t, object_ptr<const Type>> m_bind;
+      /// recently bound variables
+      std::vector<object_ptr<const Type>> m_bound;
+    };
+
+    /// typing environment for overloaded extension using union-find unifier.
+    /// Implements same rules as overloading_env.
+    /// Records each visit of nodes, so shared subtrees can be typed once when
+    /// their types do not depend on use.
+    struct uf_overloading_env
+    {
+      uf_overloading_env(class_env&& env, location_map&& loc)
+        : classes {std::move(env)}
+        , locations {std::move(loc)}
+      {
+      }
+
+      /// overloading assumption
+      struct assumption
+      {
+        /// type variable of overloaded object
+        object_ptr<const Type> var;
+        /// assumed type
+        object_ptr<const Type> type;
+        /// class ID
+        object_ptr<const Type> class_id;
+        /// index of visit of overloaded object, npos when closed
+        size_t visit;
+        /// free variable found in last check
+        object_ptr<const Type> witness = nullptr;
+      };
+
+      /// entry of envA in overloading_env
+      struct binding
+      {
+        /// type variable, null when removed
+        object_ptr<const Type> var;
+        /// free variable found in last check
+        object_ptr<const Type> witness = nullptr;
+      };
+
+      /// kind of visit
+      enum class visit_kind
+      {
+        leaf,
+        overloaded,
+        known,
+        apply,
+        lambda,
+      };
+
+      /// typing of single visit of node
+      struct visit
+      {
+        /// kind of visit
+        visit_kind kind;
+        /// visited node
+        object_ptr<const Object> node;
+        /// type of node
+        object_ptr<const Type> type = nullptr;
+        /// Apply: type of function, Lambda: type of variable
+        object_ptr<const Type> t1 = nullptr;
+        /// Apply: type of argument, Lambda: type of body
+        object_ptr<const Type> t2 = nullptr;
+        /// Apply: visit of function, Lambda: visit of body
+        size_t v1 = npos;
+        /// Apply: visit of argument
+        size_t v2 = npos;
+        /// overloaded: resolved instance
+        object_ptr<const Object> inst = nullptr;
+      };
+
+      /// typed subtree
+      struct memo_entry
+      {
+        /// type of subtree
+        object_ptr<const Type> type;
+        /// visit of subtree
+        size_t visit;
+        /// lambda variables referenced from subtree, and their types
+        std::vector<std::pair<uint64_t, object_ptr<const Type>>> deps;
+      };
+
+      static constexpr size_t npos = static_cast<size_t>(-1);
+
+      /// type variables
+      uf_subst subst;
+
+      /// lambda variables in scope.
+      /// map of (variable ID, type)
+      std::unordered_map<uint64_t, object_ptr<const Type>> lambda_vars;
+
+      /// IDs of type variables in lambda_vars
+      std::unordered_set<uint64_t> lambda_types;
+
+      /// bindings which may contain free variable
+      std::vector<binding> open;
+
+      /// overloading assumptions
+      std::vector<assumption> assumptions;
+
+      /// overloaded classes.
+      /// map of (class ID, class)
+      class_env classes;
+
+      /// location map
+      location_map locations;
+
+      /// subtree cache (optional)
+      typing_cache* cache = nullptr;
+
+      /// visits in visiting order
+      std::vector<visit> visits;
+
+      /// last visit
+      size_t last = npos;
+
+      /// typed subtrees which can be shared between uses
+      std::unordered_map<const Object*, memo_entry> memo;
+
+      /// IDs of lambda variables referenced from current subtree
+      std::vector<uint64_t> refs;
+
+      /// Create new type variable
+      auto genvar(const object_ptr<const Object>& src)
+      {
+        auto var = yave::genvar();
+        locations.add_location(var, locations.locate(src));
+        return var;
+      }
+
+      /// Create fresh polymorphic type
+      auto genpoly(const object_ptr<const Type>& tp)
+      {
+        auto vs = vars(tp);
+        auto t  = tp;
+
+        for (auto v : vs) {
+
+          if (subst.is_bound(v))
+            continue;
+
+          auto a = type_arrow {v, this->genvar(v)};
+          t      = apply_type_arrow(a, t);
+        }
+        return t;
+      }
+
+      /// Get type of object
+      auto get_type(const object_ptr<const Object>& obj)
+      {
+        auto ty = copy_type(yave::get_type(obj));
+        locations.add_location(ty, locations.locate(obj));
+        return ty;
+      }
+
+      /// Add visit and set it to last visit.
+      auto add_visit(visit_kind kind, const object_ptr<const Object>& node)
+      {
+        last = visits.size();
+        visits.push_back({kind, node});
+        return last;
+      }
+
+      /// Instantiate class
+      auto instantiate_class(const object_ptr<const Overloaded>& src)
+        -> object_ptr<const Type>
+      {
+        auto overload = classes.find_overloading(src->id_var);
+
+        if (!overload)
+          throw message(unexpected_type_error(
+            "Could not instantiate overloading: Invalid class ID"));
+
+        auto var = this->genvar(src);
+        auto tp  = this->genpoly(overload->type);
+        auto v   = add_visit(visit_kind::overloaded, src);
+
+        assumptions.push_back({var, tp, src->id_var, v});
+
+        return tp;
+      }
+
+      /// Check if type has free variable.
+      /// \param witness free variable found in last check
+      bool has_free_var(
+        const object_ptr<const Type>& t,
+        object_ptr<const Type>& witness)
+      {
+        if (witness && !subst.is_bound(witness))
+          return true;
+
+        witness = subst.free_var(t);
+        return static_cast<bool>(witness);
+      }
+
+      /// Record variables bound by last unification.
+      /// \param result result type variable which is not recorded
+      void add_bindings(const object_ptr<const Type>& result)
+      {
+        auto id = is_tvar_type_if(result)->id;
+
+        for (auto&& v : subst.take_bound()) {
+          auto vid = is_tvar_type_if(v)->id;
+          if (vid != id && !lambda_types.contains(vid))
+            open.push_back({v});
+        }
+      }
+
+      /// Check if no binding has free variable.
+      /// Closed bindings are never opened again, since variables are bound only
+      /// once.
+      bool closed()
+      {
+        while (!open.empty()) {
+          auto& b = open.back();
+          if (b.var && has_free_var(b.var, b.witness))
+            return false;
+          open.pop_back();
+        }
+        return true;
+      }
+
+      /// Find typed subtree which can be reused in current scope.
+      auto find_memo(const object_ptr<const Object>& obj) -> const memo_entry*
+      {
+        auto it = memo.find(obj.get());
+
+        if (it == memo.end())
+          return nullptr;
+
+        for (auto&& [id, t] : it->second.deps) {
+          auto var = lambda_vars.find(id);
+          if (var == lambda_vars.end() || var->second != t)
+            return nullptr;
+        }
+
+        for (auto&& [id, t] : it->second.deps)
+          refs.push_back(id);
+
+        last = it->second.visit;
+        return &it->second;
+      }
+
+      /// Memoize typing of subtree when it does not depend on use.
+      /// Type variables which are not bound to variables of enclosing lambdas
+      /// can be instantiated differently on each use.
+      /// \param b start of references from subtree in refs
+      void memoize(
+        const object_ptr<const Object>& obj,
+        const object_ptr<const Type>& ty,
+        size_t v,
+        size_t b)
+      {
+        std::sort(refs.begin() + b, refs.end());
+        refs.erase(std::unique(refs.begin() + b, refs.end()), refs.end());
+
+        // not shared in apply graph
+        if (obj.use_count() < 2)
+          return;
+
+        auto deps = std::vector<std::pair<uint64_t, object_ptr<const Type>>>();
+        auto envs = std::unordered_set<uint64_t>();
+
+        for (auto i = b; i < refs.size(); ++i) {
+          auto t = lambda_vars.at(refs[i]);
+          deps.emplace_back(refs[i], t);
+          for (auto&& tv : vars(subst.resolve(t)))
+            envs.insert(is_tvar_type_if(tv)->id);
+        }
+
+        for (auto&& tv : vars(subst.resolve(ty)))
+          if (!envs.contains(is_tvar_type_if(tv)->id))
+            return;
+
+        memo.insert_or_assign(obj.get(), memo_entry {ty, v, std::move(deps)});
+      }
+    };
+
+    /// close assumption of overloading
+    inline auto close_assumption(
+      uf_overloading_env& env,
+      object_ptr<const Type> ty) -> object_ptr<const Type>
+    {
+      for (auto&& a : env.assumptions) {
+
+        // ignore assumptions which contains variable.
+        if (env.has_free_var(a.type, a.witness))
+          continue;
+
+        auto assump    = env.subst.resolve(a.type);
+        auto class_val = *env.classes.find_overloading(a.class_id);
+
+        // find specializable overloadings
+
+        object_ptr<const Type> result_type   = nullptr;
+        object_ptr<const Object> result_inst = nullptr;
+        bool ambiguous                       = false;
+
+        for (auto&& inst : class_val.instances) {
+          auto insty = env.genpoly(env.get_type(inst));
+
+          if (specializable(insty, assump)) {
+            if (result_type) {
+              ambiguous = true;
+              break;
+            }
+            result_type = insty;
+            result_inst = inst;
+          }
+        }
+
+        if (ambiguous)
+          continue;
+
+        // could not match overloading
+        if (!result_type)
+          // FIXME: get_souce_id() should be used
+          throw message(no_valid_overloading(env.locations.locate(a.var).id()));
+
+        // assumption has no variable, so it does not need substitution from
+        // result type.
+
+        // cache result
+        env.visits[a.visit].inst = result_inst;
+        a.visit                  = uf_overloading_env::npos;
+      }
+
+      // remove assumptions no longer required
+      std::erase_if(env.assumptions, [](auto& a) {
+        return a.visit == uf_overloading_env::npos;
+      });
+
+      return ty;
+    }
+
+    inline auto type_of_overloaded_impl(
+      const object_ptr<const Object>& obj,
+      uf_overloading_env& env) -> object_ptr<const Type>
+    {
+      using visit_kind = uf_overloading_env::visit_kind;
+
+      // reused subtree
+      if (env.cache) {
+        if (auto it = env.cache->known.find(obj.get());
+            it != env.cache->known.end()) {
+          env.locations.add_location(it->second, env.locations.locate(obj));
+          env.visits[env.add_visit(visit_kind::known, obj)].type = it->second;
+          return it->second;
+        }
+      }
+
+      // Apply
+      if (auto apply = value_cast_if<Apply>(obj)) {
+
+        auto& storage = _get_storage(*apply);
+
+        // cached
+        if (storage.is_result())
+          return type_of_overloaded_impl(storage.get_result(), env);
+
+        // shared subtree
+        if (auto m = env.find_memo(obj))
+          return m->type;
+
+        auto v = env.add_visit(visit_kind::apply, obj);
+        auto b = env.refs.size();
+
+        auto t1 = type_of_overloaded_impl(storage.app(), env);
+        auto v1 = env.last;
+        auto t2 = type_of_overloaded_impl(storage.arg(), env);
+        auto v2 = env.last;
+
+        try {
+
+          auto var = env.genvar(obj);
+          env.subst.unify(t1, make_arrow_type(t2, var));
+          auto ty = env.subst.find(var);
+
+          env.add_bindings(var);
+
+          // only close when bindings have no free variable
+          if (env.closed())
+            ty = close_assumption(env, ty);
+
+          // monomorphic type will not be changed by later substitutions
+          if (env.cache) {
+            if (auto it = env.cache->record.find(obj.get());
+                it != env.cache->record.end()) {
+              if (auto rty = env.subst.resolve(ty); vars(rty).empty())
+                it->second.second = rty;
+            }
+          }
+
+          env.visits[v] = {visit_kind::apply, obj, var, t1, t2, v1, v2};
+          env.memoize(obj, ty, v, b);
+          env.last = v;
+
+          return ty;
+
+        } catch (type_error::type_error&) {
+          rethrow_type_error(env.locations);
+        }
+      }
+
+      // Lambda
+      if (auto lambda = value_cast_if<Lambda>(obj)) {
+
+        auto& storage = _get_storage(*lambda);
+
+        // shared subtree
+        if (auto m = env.find_memo(obj))
+          return m->type;
+
+        auto v = env.add_visit(visit_kind::lambda, obj);
+        auto b = env.refs.size();
+
+        // fresh variable for each visit, since lambda can be shared
+        auto id   = storage.var->id();
+        auto var  = env.genvar(storage.var);
+        auto prev = object_ptr<const Type>();
+
+        if (auto it = env.lambda_vars.find(id); it != env.lambda_vars.end())
+          prev = it->second;
+
+        env.lambda_vars.insert_or_assign(id, var);
+        env.lambda_types.insert(is_tvar_type_if(var)->id);
+
+        auto idx = env.open.size();
+        env.open.push_back({var});
+
+        auto t1 = var;
+        auto t2 = type_of_overloaded_impl(storage.body, env);
+        auto vb = env.last;
+
+        auto ty = make_arrow_type(t1, t2);
+        env.locations.add_location(ty, env.locations.locate(obj));
+
+        if (prev)
+          env.lambda_vars.insert_or_assign(id, prev);
+        else
+          env.lambda_vars.erase(id);
+
+        env.lambda_types.erase(is_tvar_type_if(var)->id);
+
+        if (idx < env.open.size() && env.open[idx].var == var)
+          env.open[idx].var = nullptr;
+
+        // variable is bound in this subtree
+        env.refs.erase(
+          std::remove(env.refs.begin() + b, env.refs.end(), id),
+          env.refs.end());
+
+        env.visits[v] = {visit_kind::lambda, obj, ty, t1, t2, vb};
+        env.memoize(obj, ty, v, b);
+        env.last = v;
+
+        return ty;
+      }
+
+      // Variable
+      if (auto variable = value_cast_if<Variable>(obj)) {
+
+        if (auto it = env.lambda_vars.find(variable->id());
+            it != env.lambda_vars.end()) {
+          env.refs.push_back(variable->id());
+          env.add_visit(visit_kind::leaf, obj);
+          return it->second;
+        }
+
+        throw message(unexpected_type_error("Unbounded variable"));
+      }
+
+      // Overloaded
+      if (auto overloaded = value_cast_if<Overloaded>(obj))
+        return env.instantiate_class(overloaded);
+
+      // Partially applied closures
+      if (auto c = value_cast_if<Closure<>>(obj)) {
+        if (c->is_pap()) {
+          auto ty = type_of_overloaded_impl(c->vertebrae(c->arity), env);
+          env.add_visit(visit_kind::leaf, obj);
+          return ty;
+        }
+      }
+
+      env.add_visit(visit_kind::leaf, obj);
+
+      // tap
+      if (has_tap_type(obj))
+        return env.genpoly(env.get_type(obj));
+
+      // tcon
+      if (has_tcon_type(obj))
+        return env.get_type(obj);
+
+      // tvar
+      if (has_tvar_type(obj))
+        return env.get_type(obj);
+
+      unreachable();
+    }
+
+    /// Rebuild overloading resolved apply graph from visits.
+    /// Visits of same node share result when they have same typing, so
+    /// subtrees shared in source graph are also shared in result.
+    class uf_rebuilder
+    {
+      using visit_kind = uf_overloading_env::visit_kind;
+
+      static constexpr size_t npos = uf_overloading_env::npos;
+
+    public:
+      uf_rebuilder(uf_overloading_env& env, bool annotate)
+        : m_env {env}
+        , m_outs(env.visits.size())
+        , m_next(env.visits.size(), npos)
+        , m_annotate {annotate}
+      {
+      }
+
+      /// Rebuild result of visit
+      auto rebuild(size_t v) -> object_ptr<const Object>
+      {
+        if (m_outs[v])
+          return m_outs[v];
+
+        auto& vis = m_env.visits[v];
+
+        switch (vis.kind) {
+          case visit_kind::leaf:
+            return m_outs[v] = vis.node;
+
+          case visit_kind::overloaded:
+            if (!vis.inst)
+              // FIXME: get_souce_id() should be used
+              throw message(
+                no_valid_overloading(m_env.locations.locate(vis.node).id()));
+            return m_outs[v] = vis.inst;
+
+          case visit_kind::known:
+            if (m_annotate)
+              if (value_cast_if<Apply>(vis.node) || value_cast_if<Lambda>(vis.node))
+                m_types.insert_or_assign(
+                  vis.node.get(),
+                  typed_ir::node_type {m_env.subst.resolve(vis.type)});
+            return m_outs[v] = vis.node;
+
+          case visit_kind::apply:
+          case visit_kind::lambda:
+            break;
+        }
+
+        auto o1 = rebuild(vis.v1);
+        auto o2 = vis.v2 == npos ? nullptr : rebuild(vis.v2);
+
+        auto [it, first] = m_shared.try_emplace(vis.node.get(), v);
+
+        // types are only resolved when required
+        if (m_annotate || !first)
+          resolve(vis);
+
+        // visit of same node with same typing
+        for (auto w = first ? npos : it->second; w != npos; w = m_next[w]) {
+          auto& other = m_env.visits[w];
+          if (
+            m_outs[other.v1] == o1 && (!o2 || m_outs[other.v2] == o2)
+            && same_type(resolve(other).type, vis.type)
+            && same_type(other.t1, vis.t1) && same_type(other.t2, vis.t2))
+            return m_outs[v] = m_outs[w];
+        }
+
+        auto out = vis.kind == visit_kind::apply
+                     ? object_ptr<const Object>(make_object<Apply>(o1, o2))
+                     : object_ptr<const Object>(make_object<Lambda>(
+                       _get_storage(*value_cast<Lambda>(vis.node)).var, o1));
+
+        if (!first) {
+          m_next[v]  = it->second;
+          it->second = v;
+        }
+
+        if (m_annotate)
+          m_types.insert_or_assign(
+            out.get(), typed_ir::node_type {vis.type, vis.t1, vis.t2});
+
+        // record resolved subtree
+        if (auto cache = m_env.cache) {
+          if (auto it = cache->record.find(vis.node.get());
+              it != cache->record.end() && it->second.second
+              && !it->second.first)
+            it->second.first = out;
+        }
+
+        return m_outs[v] = out;
+      }
+
+      /// Get typed IR of rebuilt graph
+      auto typed_ir(const object_ptr<const Object>& obj) -> compiler::typed_ir
+      {
+        return compiler::typed_ir(obj, std::move(m_types));
+      }
+
+    private:
+      /// Resolve types of visit.
+      /// Visits are not modified after type checking.
+      auto resolve(uf_overloading_env::visit& vis) -> uf_overloading_env::visit&
+      {
+        vis.type = m_env.subst.resolve(vis.type);
+        vis.t1   = m_env.subst.resolve(vis.t1);
+        vis.t2   = m_env.subst.resolve(vis.t2);
+        return vis;
+      }
+
+    private:
+      uf_overloading_env& m_env;
+      /// results of visits
+      std::vector<object_ptr<const Object>> m_outs;
+      /// last rebuilt visit of each node
+      std::unordered_map<const Object*, size_t> m_shared;
+      /// previous rebuilt visit of same node
+      std::vector<size_t> m_next;
+      /// build typed IR
+      bool m_annotate;
+      /// types of rebuilt nodes
+      std::unordered_map<const Object*, typed_ir::node_type> m_types;
+    };
+
+    /// Type check with union-find backend.
+    auto type_of_overloaded_uf(
+      const object_ptr<const Object>& obj,
+      uf_overloading_env& env,
+      typed_ir* ir)
+      -> std::pair<object_ptr<const Type>, object_ptr<const Object>>
+    {
+      auto ty = type_of_overloaded_impl(obj, env);
+      auto v  = env.last;
+      ty      = close_assumption(env, ty);
+
+      auto rebuilder = uf_rebuilder(env, ir);
+      auto app       = rebuilder.rebuild(v);
+
+      if (ir)
+        *ir = rebuilder.typed_ir(app);
+
+      return {env.subst.resolve(ty), app};
+    }
   } // namespace
 
   auto type_of_overloaded(
     const object_ptr<const Object>& obj,
     class_env&& classes,
-    location_map&& loc)
+    location_map&& loc,
+    typecheck_backend backend,
+    typed_ir* ir)
     -> std::pair<object_ptr<const Type>, object_ptr<const Object>>
   {
+    if (backend == typecheck_backend::union_find) {
+      uf_overloading_env env(std::move(classes), std::move(loc));
+      return type_of_overloaded_uf(obj, env, ir);
+    }
+
+    if (ir)
+      *ir = typed_ir();
+
+    auto visited = std::unordered_set<const Object*>();
+    auto src     = unshare(obj, loc, nullptr, visited);
+
     overloading_env env(std::move(classes), std::move(loc));
-    auto ty = type_of_overloaded_impl(obj, env);
+    auto ty = type_of_overloaded_impl(src, env);
     ty      = close_assumption(env, ty);
-    return {ty, rebuild_overloads(obj, env)};
+    return {ty, rebuild_overloads(src, env)};
+  }
+
+  auto type_of_overloaded(
+    const object_ptr<const Object>& obj,
+    class_env&& classes,
+    location_map&& loc,
+    typing_cache& cache,
+    typecheck_backend backend,
+    typed_ir* ir)
+    -> std::pair<object_ptr<const Type>, object_ptr<const Object>>
+  {
+    if (backend == typecheck_backend::union_find) {
+      uf_overloading_env env(std::move(classes), std::move(loc));
+      env.cache = &cache;
+      return type_of_overloaded_uf(obj, env, ir);
+    }
+
+    if (ir)
+      *ir = typed_ir();
+
+    auto visited = std::unordered_set<const Object*>();
+    auto src     = unshare(obj, loc, &cache, visited);
+
+    overloading_env env(std::move(classes), std::move(loc));
+    env.cache = &cache;
+    auto ty   = type_of_overloaded_impl(src, env);
+    ty        = close_assumption(env, ty);
+    return {ty, rebuild_overloads(src, env)};
   }
 
-} // namespace yave::compiler
\ No newline at end of file
+} // namespace yave::compiler
@@ -0,0 +1,126 @@
+//
+// Copyright (c) 2019 mocabe (https://github.com/mocabe)
+// Distributed under LGPLv3 License. See LICENSE for more details.
+//
+
+#include <yave/compiler/typed_ir.hpp>
+#include <yave/rts/dynamic_typing.hpp>
+#include <yave/rts/value_cast.hpp>
+#include <yave/rts/lambda.hpp>
+
+#include <unordered_set>
+
+namespace yave::compiler {
+
+  namespace {
+
+    /// local type checker of typed_ir
+    struct typed_ir_checker
+    {
+      const typed_ir& ir;
+
+      /// lambda variables in scope.
+      /// map of (variable ID, type)
+      std::unordered_map<uint64_t, object_ptr<const Type>> vars = {};
+
+      /// checked nodes
+      std::unordered_set<const Object*> visited = {};
+
+      /// check typing of node used as type
+      bool check(
+        const object_ptr<const Object>& obj,
+        const object_ptr<const Type>& type)
+      {
+        if (auto node = ir.find(obj.get())) {
+
+          if (!same_type(node->type, type))
+            return false;
+
+          // trusted subtree, or checked
+          if (!node->t1 || !visited.insert(obj.get()).second)
+            return true;
+
+          if (auto apply = value_cast_if<Apply>(obj)) {
+            auto& storage = _get_storage(*apply);
+            return same_type(node->t1, make_arrow_type(node->t2, node->type))
+                   && check(storage.app(), node->t1)
+                   && check(storage.arg(), node->t2);
+          }
+
+          if (auto lambda = value_cast_if<Lambda>(obj)) {
+            auto& storage = _get_storage(*lambda);
+
+            if (!same_type(node->type, make_arrow_type(node->t1, node->t2)))
+              return false;
+
+            auto id   = storage.var->id();
+            auto prev = object_ptr<const Type>();
+
+            if (auto it = vars.find(id); it != vars.end())
+              prev = it->second;
+
+            vars.insert_or_assign(id, node->t1);
+            auto ok = check(storage.body, node->t2);
+
+            if (prev)
+              vars.insert_or_assign(id, prev);
+            else
+              vars.erase(id);
+
+            return ok;
+          }
+          return false;
+        }
+
+        if (auto variable = value_cast_if<Variable>(obj)) {
+          auto it = vars.find(variable->id());
+          return it != vars.end() && same_type(it->second, type);
+        }
+
+        // applications and abstractions should be annotated
+        if (value_cast_if<Apply>(obj) || value_cast_if<Lambda>(obj))
+          return false;
+
+        // type of leaf should be instance of its own type
+        return static_cast<bool>(specializable(get_type(obj), type));
+      }
+    };
+  } // namespace
+
+  typed_ir::typed_ir(
+    object_ptr<const Object> obj,
+    std::unordered_map<const Object*, node_type> types)
+    : m_obj {std::move(obj)}
+    , m_types {std::move(types)}
+  {
+  }
+
+  auto typed_ir::object() const -> const object_ptr<const Object>&
+  {
+    return m_obj;
+  }
+
+  auto typed_ir::find(const Object* node) const -> const node_type*
+  {
+    if (auto it = m_types.find(node); it != m_types.end())
+      return &it->second;
+    return nullptr;
+  }
+
+  auto typed_ir::size() const -> size_t
+  {
+    return m_types.size();
+  }
+
+  bool typed_ir::check(const object_ptr<const Type>& type) const
+  {
+    if (!m_obj)
+      return false;
+
+    try {
+      return typed_ir_checker {*this}.check(m_obj, type);
+    } catch (...) {
+      return false;
+    }
+  }
+} // namespace yave::compiler
@@ -6,6 +6,7 @@
 #include <yave/compiler/compile.hpp>
 #include <yave/compiler/message.hpp>
 #include <yave/compiler/executable.hpp>
+#include <yave/compiler/typed_ir.hpp>
 #include <yave/signal/specifier.hpp>
 #include <yave/obj/frame_buffer/frame_buffer.hpp>
 
@@ -26,6 +27,24 @@ namespace yave::compiler {
       pipe.set_failed();
     }
 
+    auto full = pipe.get_data_if<bool>("verify_full");
+
+    // check types recorded by sema
+    if (auto ir = pipe.get_data_if<typed_ir>("typed_ir")) {
+
+      auto ok = ir->object() == exe.object() && ir->check(exe.type());
+      pipe.remove_data("typed_ir");
+
+      if (!ok) {
+        msg_map.add(internal_compile_error("Typed IR check failed"));
+        pipe.set_failed();
+        return;
+      }
+
+      if (!full || !*full)
+        return;
+    }
+
     // verbose type check
     try {
       if (same_type(type_of(exe.object()), exe.type()))
@@ -11,6 +11,7 @@
 
 #include <boost/gil.hpp>
 #include <map>
+#include <mutex>
 
 YAVE_DECL_LOCAL_LOGGER(frame_buffer_manager);
 
@@ -73,6 +74,10 @@ namespace yave::data {
     // vulkan staging buffer for data transfer
     vulkan::staging_buffer staging;
 
+  public:
+    // lock of entries and command pool/queue
+    std::recursive_mutex mtx;
+
   public:
     // memory pool
     std::pmr::unsynchronized_pool_resource memory_resource;
@@ -206,9 +211,16 @@ namespace yave::data {
       destroy(empty_frame);
     }
 
+    auto lock()
+    {
+      return std::unique_lock(mtx);
+    }
+
     uid create() noexcept
     {
       try {
+        auto lck = lock();
+
         // cache empty frame
         if (empty_frame == uid())
           empty_frame = create_empty();
@@ -224,6 +236,7 @@ namespace yave::data {
     uid create_from(uid id) noexcept
     {
       try {
+        auto lck   = lock();
         auto entry = find_entry(id);
 
         if (!entry) {
@@ -252,6 +265,7 @@ namespace yave::data {
 
     void destroy(uid id) noexcept
     {
+      auto lck = lock();
       if (auto it = map.find(id); it != map.end())
         map.erase(it);
     }
@@ -259,6 +273,7 @@ namespace yave::data {
     bool exists(uid id) noexcept
     {
       try {
+        auto lck = lock();
         return find_entry(id);
       } catch (...) {
         return false;
@@ -275,6 +290,7 @@ namespace yave::data {
     {
       try {
 
+        auto lck   = lock();
         auto entry = find_entry(id);
 
         if (!entry) {
@@ -312,6 +328,7 @@ namespace yave::data {
     {
       try {
 
+        auto lck   = lock();
         auto entry = find_entry(id);
 
         if (!entry) {
@@ -351,6 +368,7 @@ namespace yave::data {
 
     auto get_texture_data(uid id) -> vulkan::texture_data&
     {
+      auto lck   = lock();
       auto entry = find_entry(id);
       make_entry_writable(entry);
       return entry->data->texture;
@@ -422,4 +440,10 @@ namespace yave::data {
   {
     return m_pimpl->get_texture_data(id);
   }
+
+  auto frame_buffer_manager::lock() const
+    -> std::unique_lock<std::recursive_mutex>
+  {
+    return m_pimpl->lock();
+  }
 } // namespace yave::data
\ No newline at end of file
@@ -7,8 +7,10 @@
 #include <yave/editor/editor_data.hpp>
 #include <yave/compiler/message.hpp>
 #include <yave/support/log.hpp>
+#include <yave/support/trace.hpp>
 
 #include <yave/compiler/compile.hpp>
+#include <yave/compiler/signal_cache.hpp>
 
 #include <thread>
 #include <mutex>
@@ -33,6 +35,11 @@ namespace yave::editor {
     std::atomic<bool> terminate_flag = false;
     std::atomic<bool> recompile_flag = false;
 
+  private:
+    /// typed subtrees of last successful compilation
+    std::shared_ptr<compiler::sema_cache> cache =
+      std::make_shared<compiler::sema_cache>();
+
   private:
     std::exception_ptr exception;
 
@@ -64,6 +71,8 @@ namespace yave::editor {
       thread =
         std::thread([&]() {
           try {
+            set_trace_thread_name("compile");
+
             while (true) {
 
               {
@@ -77,8 +86,16 @@ namespace yave::editor {
 
               if (recompile_flag) {
 
+                YAVE_TRACE_SPAN("compile");
+
                 recompile_flag = false;
 
+                // current frame is executing stale executable
+                {
+                  auto lck = data_ctx.get_data<execute_thread>();
+                  lck.ref().cancel_execute();
+                }
+
                 // initialize compiler pipeilne
                 auto init_pipeline = [&] {
                   auto lck   = data_ctx.get_data<editor_data>();
@@ -93,33 +110,57 @@ namespace yave::editor {
 
                 // prepare compiler input
                 auto init_input = [&](auto& pipeline) {
+                  YAVE_TRACE_SPAN("input");
                   auto lck   = data_ctx.get_data<editor_data>();
                   auto& data = lck.ref();
 
-                  // clone graph
-                  auto _ng   = data.node_graph().clone();
-                  auto _root = _ng.node(data.root_group().id());
+                  // snapshot of graph, shared until next modification
+                  auto _ng   = data.node_graph_snapshot();
+                  auto _root = _ng->node(data.root_group().id());
 
-                  auto _os = _ng.output_sockets(_root).empty()
+                  auto _os = _ng->output_sockets(_root).empty()
                                ? socket_handle()
-                               : _ng.output_sockets(_root)[0];
+                               : _ng->output_sockets(_root)[0];
 
                   auto _decls = data.node_declarations().get_map();
                   auto _defs  = data.node_definitions().get_map();
 
+                  // per-node profiling
+                  if (data.executor_data().profiling())
+                    pipeline.add_data(
+                      "profiler", std::make_shared<compiler::node_profiler>());
+
+                  // cache results of signals by frame time
+                  if (auto budget = data.executor_data().signal_cache_budget())
+                    pipeline.add_data(
+                      "signal_cache",
+                      std::make_shared<compiler::signal_cache>(budget));
+
                   compiler::input(
                     pipeline,
                     std::move(_ng),
                     std::move(_os),
                     std::move(_decls),
                     std::move(_defs));
+
+                  // reuse results of previous compilation
+                  pipeline.add_data("sema_cache", cache);
+                };
+
+                // record span of stage
+                auto stage = [](const char* name, auto f) {
+                  return [=](auto& p) {
+                    YAVE_TRACE_SPAN(name);
+                    f(p);
+                  };
                 };
 
                 // compiler stages
-                auto parse    = [](auto& p) { compiler::parse(p); };
-                auto sema     = [](auto& p) { compiler::sema(p); };
-                auto verify   = [](auto& p) { compiler::verify(p); };
-                auto optimize = [](auto& p) { compiler::optimize(p); };
+                auto parse    = stage("parse", compiler::parse);
+                auto sema     = stage("sema", compiler::sema);
+                auto verify   = stage("verify", compiler::verify);
+                auto optimize = stage("optimize", compiler::optimize);
+                auto lower    = stage("lower", compiler::lower);
 
                 // process compiler output
                 auto process_output = [&](compiler::pipeline& pipeline) {
@@ -135,15 +176,22 @@ namespace yave::editor {
 
                     auto& exe = pipeline.get_data<compiler::executable>("exe");
 
+                    using profiler_ptr = std::shared_ptr<compiler::node_profiler>;
+                    auto* profiler =
+                      pipeline.get_data_if<profiler_ptr>("profiler");
+
                     data.set_results(
-                      {.last_msg = std::move(msgs),
-                       .last_exe = std::move(exe)});
+                      {.last_msg      = std::move(msgs),
+                       .last_exe      = std::move(exe),
+                       .last_profiler = profiler ? *profiler : nullptr});
 
                   } else {
                     log_info("Compile Failed");
 
                     data.set_results(
-                      {.last_msg = std::move(msgs), .last_exe = {}});
+                      {.last_msg      = std::move(msgs),
+                       .last_exe      = {},
+                       .last_profiler = nullptr});
                   }
                 };
 
@@ -160,6 +208,7 @@ namespace yave::editor {
                   .and_then(sema)
                   .and_then(verify)
                   .and_then(optimize)
+                  .and_then(lower)
                   .apply(process_output)
                   .and_then(notify_execute);
               }
@@ -218,6 +267,10 @@ namespace yave::editor {
     compiler::message_map m_last_msg;
     /// result
     std::optional<compiler::executable> m_last_exe;
+    /// profiler
+    std::shared_ptr<compiler::node_profiler> m_last_profiler;
+    /// version of result
+    uint64_t m_version = 0;
 
   public:
     auto& last_message() const
@@ -230,16 +283,30 @@ namespace yave::editor {
       return m_last_exe;
     }
 
+    auto& last_profiler()
+    {
+      return m_last_profiler;
+    }
+
+    auto version() const
+    {
+      return m_version;
+    }
+
     void clear_results()
     {
-      m_last_msg = {};
-      m_last_exe = std::nullopt;
+      m_last_msg      = {};
+      m_last_exe      = std::nullopt;
+      m_last_profiler = nullptr;
+      ++m_version;
     }
 
     void set_results(compile_results results)
     {
-      m_last_msg = std::move(results.last_msg);
-      m_last_exe = std::move(results.last_exe);
+      m_last_msg      = std::move(results.last_msg);
+      m_last_exe      = std::move(results.last_exe);
+      m_last_profiler = std::move(results.last_profiler);
+      ++m_version;
     }
   };
 
@@ -264,6 +331,17 @@ namespace yave::editor {
     return m_pimpl->last_executable();
   }
 
+  auto compile_thread_data::last_profiler() const
+    -> const std::shared_ptr<compiler::node_profiler>&
+  {
+    return m_pimpl->last_profiler();
+  }
+
+  auto compile_thread_data::version() const -> uint64_t
+  {
+    return m_pimpl->version();
+  }
+
   void compile_thread_data::set_results(compile_results results)
   {
     m_pimpl->set_results(std::move(results));
@@ -197,6 +197,8 @@ namespace yave::editor {
     // execute single command
     void exec_one()
     {
+      YAVE_TRACE_SPAN("data command");
+
       cmd_t top;
       {
         auto lck = lock_queue();
@@ -290,6 +292,8 @@ namespace yave::editor {
 
       thread = std::thread([&] {
         try {
+          set_trace_thread_name("data");
+
           while (!terminate_flag) {
 
             wait_cmd();
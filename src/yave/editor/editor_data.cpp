@@ -4,6 +4,7 @@
 //
 
 #include <yave/editor/editor_data.hpp>
+#include <yave/editor/data_context.hpp>
 
 #include <yave/node/core/serialize.hpp>
 #include <sstream>
@@ -36,6 +37,10 @@ namespace yave::editor {
     node_definition_store node_defs;
     /// node graph
     structured_node_graph node_graph;
+    /// last snapshot of node graph
+    std::shared_ptr<const structured_node_graph> node_graph_snapshot;
+    /// version of node graph when snapshot was taken
+    uint64_t node_graph_snapshot_version = 0;
     /// node group
     node_handle root_group;
 
@@ -297,6 +302,57 @@ namespace yave::editor {
     return m_pimpl->node_graph;
   }
 
+  auto editor_data::node_graph_snapshot()
+    -> std::shared_ptr<const structured_node_graph>
+  {
+    auto& ng       = m_pimpl->node_graph;
+    auto& snapshot = m_pimpl->node_graph_snapshot;
+    auto& version  = m_pimpl->node_graph_snapshot_version;
+
+    if (!snapshot || version != ng.version()) {
+      snapshot = std::make_shared<const structured_node_graph>(ng.clone());
+      version  = ng.version();
+    }
+    return snapshot;
+  }
+
+  bool editor_data::node_graph_snapshot_updated() const
+  {
+    return m_pimpl->node_graph_snapshot
+           && m_pimpl->node_graph_snapshot_version
+                == m_pimpl->node_graph.version();
+  }
+
+  void editor_data::set_node_graph_snapshot(
+    std::shared_ptr<const structured_node_graph> snapshot,
+    uint64_t version)
+  {
+    m_pimpl->node_graph_snapshot         = std::move(snapshot);
+    m_pimpl->node_graph_snapshot_version = version;
+  }
+
+  void update_node_graph_snapshot(data_context& dctx)
+  {
+    YAVE_TRACE_SPAN("snapshot");
+
+    auto ng = [&]() -> const structured_node_graph* {
+      auto lck = dctx.get_data<editor_data>();
+      if (lck.ref().node_graph_snapshot_updated())
+        return nullptr;
+      return &lck.ref().node_graph();
+    }();
+
+    if (!ng)
+      return;
+
+    // other threads only read graph, so it can be cloned without lock.
+    auto version  = ng->version();
+    auto snapshot = std::make_shared<const structured_node_graph>(ng->clone());
+
+    auto lck = dctx.get_data<editor_data>();
+    lck.ref().set_node_graph_snapshot(std::move(snapshot), version);
+  }
+
   auto editor_data::root_group() const -> const node_handle&
   {
     return m_pimpl->root_group;
@@ -5,12 +5,17 @@
 
 #include <yave/editor/execute_thread.hpp>
 #include <yave/editor/editor_data.hpp>
+#include <yave/editor/frame_pipeline.hpp>
+#include <yave/compiler/signal_cache.hpp>
 #include <yave/obj/frame_demand/frame_demand.hpp>
 #include <yave/signal/specifier.hpp>
 #include <yave/rts/to_string.hpp>
+#include <yave/rts/task_pool.hpp>
+#include <yave/rts/cancel_token.hpp>
 #include <yave/lib/image/image.hpp>
 
 #include <yave/support/log.hpp>
+#include <yave/support/trace.hpp>
 
 #include <thread>
 #include <mutex>
@@ -41,6 +46,44 @@ namespace yave::editor {
   private:
     std::exception_ptr exception;
 
+  private:
+    /// cancellation of current frame, guarded by mtx
+    cancel_token token;
+
+    /// request executed by current frame
+    struct frame_request
+    {
+      yave::time arg_time;
+      uint64_t compile_version;
+      uint64_t update_version;
+    };
+
+    /// current frame, guarded by mtx. nullopt until request is decided and
+    /// after frame is finished.
+    std::optional<frame_request> current_frame;
+
+    /// number of frames abandoned in a row by edits, guarded by mtx
+    size_t abandoned_edits = 0;
+
+    /// frames abandoned by edits in a row before next frame is allowed to
+    /// finish with stale graph, so preview keeps updating while editing.
+    static constexpr size_t max_abandoned_edits = 3;
+
+  private:
+    /// pool for parallel evaluation, created on demand
+    std::unique_ptr<task_pool> pool;
+    /// renderer of frames ahead of playhead, created on demand
+    std::unique_ptr<frame_pipeline> frames;
+
+  private:
+    /// last seen version of compiled executable
+    uint64_t compile_version = 0;
+    /// version of frames in preview cache
+    uint64_t frame_version = 0;
+
+    /// max number of frames to render ahead of playhead
+    static constexpr size_t max_frames_ahead = 1024;
+
     void check_failure()
     {
       if (!thread.joinable()) {
@@ -68,14 +111,21 @@ namespace yave::editor {
     {
       try {
 
-        auto r = value_cast<FrameBuffer>(exe.execute(t));
+        auto r = [&] {
+          YAVE_TRACE_SPAN("execute");
+          return value_cast<FrameBuffer>(exe.execute(t));
+        }();
+
         // load result to host memory
+        YAVE_TRACE_SPAN("readback");
         auto img =
           std::make_shared<image>(r->width(), r->height(), r->format());
         r->read_data(0, 0, r->width(), r->height(), img->data());
 
         return img;
 
+      } catch (const result_error::cancelled&) {
+        // abandoned by new execution
       } catch (const exception_result& e) {
 
         // exception object
@@ -83,6 +133,11 @@ namespace yave::editor {
         auto msg  = eo->message();
         auto erro = eo->error();
 
+        // abandoned by new execution
+        if (auto err = value_cast_if<ResultError>(erro))
+          if (err->error_type == result_error_type::cancelled)
+            return nullptr;
+
         log_error("Failed to execute frame output: {}", msg);
 
         // print additional info
@@ -112,12 +167,59 @@ namespace yave::editor {
       return nullptr;
     }
 
+    /// get number of frames which fit in preview cache, including current one
+    static auto cache_frames(const execute_thread_data& executor) -> size_t
+    {
+      auto& cache = executor.frame_cache();
+      auto last   = executor.last_result_image();
+
+      if (!last || last->byte_size() == 0)
+        return 0;
+
+      return std::min(cache.budget() / last->byte_size(), max_frames_ahead);
+    }
+
+    /// get uncached frames after t, which fit in preview cache
+    static auto frames_ahead(
+      const execute_thread_data& executor,
+      uint64_t version,
+      yave::time t,
+      yave::time dt) -> std::vector<yave::time>
+    {
+      auto& cache = executor.frame_cache();
+      auto n      = cache_frames(executor);
+
+      auto ret = std::vector<yave::time>();
+      auto cur = t;
+
+      for (size_t i = 1; i < n; ++i) {
+
+        cur += dt;
+
+        if (executor.loop_execution() && cur > executor.loop_range_max())
+          cur = executor.loop_range_min();
+
+        // covered whole loop range
+        if (cur == t)
+          break;
+
+        if (!cache.contains(version, cur))
+          ret.push_back(cur);
+      }
+      return ret;
+    }
+
     void start()
     {
       check_failure();
 
       thread = std::thread([&] {
         try {
+          set_trace_thread_name("execute");
+
+          // results of frames are shared with frames ahead
+          detail::concurrent_eval = true;
+
           while (true) {
 
             {
@@ -130,14 +232,41 @@ namespace yave::editor {
 
             if (execute_flag) {
 
+              YAVE_TRACE_SPAN("frame");
+
               execute_flag = false;
 
+              // cancelled by new execution request
+              auto tok = [&] {
+                std::unique_lock lck {mtx};
+                token         = cancel_token();
+                current_frame = std::nullopt;
+                return token;
+              }();
+
               auto run_bgn = steady_clock::now();
 
+              // version of argument updates applied to executable
+              auto update_version = uint64_t();
+
               // time argument
               auto arg_time = yave::time();
               // end of continuous exec time window
               auto end_limit = steady_clock::time_point();
+              // parallel evaluation
+              auto parallel = false;
+              // per-node profiler of executable
+              auto profiler = std::shared_ptr<compiler::node_profiler>();
+              // version of frames in preview cache
+              auto version = uint64_t();
+              // frame of arg time in preview cache
+              auto cached = std::shared_ptr<const image>();
+              // uncached frames to render ahead of playhead
+              auto ahead = std::vector<yave::time>();
+              // number of frames to render in parallel
+              auto look_ahead = size_t();
+              // updates are waiting for frames ahead
+              auto deferred = false;
 
               auto exe = [&]() -> std::optional<compiler::executable> {
                 auto lck       = dctx.get_data<editor_data>();
@@ -146,11 +275,22 @@ namespace yave::editor {
                 auto& executor = lck.ref().executor_data();
                 auto& scene    = lck.ref().scene_config();
 
+                // frames ahead share arguments with executable, so they
+                // should be stopped before applying updates
+                if (
+                  frames && updater.has_updates()
+                  && (frames->busy() || frames->size() != 0)) {
+                  deferred = true;
+                  return std::nullopt;
+                }
+
                 // process pending updates
-                updater.apply_updates();
+                auto updated   = updater.apply_updates();
+                update_version = updater.version();
 
                 // get next arg time
                 arg_time = executor.arg_time();
+                parallel = executor.parallel_execution();
 
                 // handle continuous/loop execution
                 if (executor.continuous_execution()) {
@@ -182,30 +322,160 @@ namespace yave::editor {
                 // get compiled result
                 if (auto&& r = compiler.last_executable()) {
                   executor.set_arg_time(arg_time);
-                  return r->clone();
+                  profiler = compiler.last_profiler();
+
+                  // executable or its arguments changed
+                  if (updated || compiler.version() != compile_version) {
+                    compile_version = compiler.version();
+                    ++frame_version;
+                  }
+
+                  version = frame_version;
+                  cached  = executor.frame_cache().get(version, arg_time);
+
+                  // per-node costs should not include frames ahead
+                  if (executor.continuous_execution() && !profiler)
+                    look_ahead = frame_pipeline::worker_count(
+                      executor.look_ahead(), cache_frames(executor));
+
+                  if (look_ahead)
+                    ahead = frames_ahead(
+                      executor,
+                      version,
+                      arg_time,
+                      time::seconds(1) / scene.frame_rate());
+
+                  auto ret = r->clone();
+                  // memoized results depend on argument values
+                  if (updated)
+                    ret.clear_cache();
+                  if (auto& cache = ret.cache())
+                    cache->set_budget(executor.signal_cache_budget());
+                  return ret;
                 }
 
                 return std::nullopt;
               }();
 
+              // stop frames ahead and retry
+              if (deferred) {
+                frames->cancel();
+                frames->wait();
+                execute_flag = true;
+                continue;
+              }
+
               // no compile result
               if (!exe) {
                 continue;
               }
 
+              {
+                std::unique_lock lck {mtx};
+                current_frame = {arg_time, compile_version, update_version};
+              }
+
               assert(
                 same_type(exe->type(), object_type<signal<FrameBuffer>>()));
 
               // execute app tree.
-              auto img = exec_frame_output(std::move(*exe), arg_time);
+              auto exec = [&](yave::time t) {
+                auto cancel = cancel_token::scope(tok);
+
+                if (!parallel)
+                  return exec_frame_output(exe->clone(), t);
+
+                if (!pool)
+                  pool = std::make_unique<task_pool>();
+
+                auto scope = task_pool::scope(*pool);
+                return exec_frame_output(exe->clone(), t);
+              };
+
+              // update renderer of frames ahead
+              if (!look_ahead) {
+                frames = nullptr;
+              } else {
+                if (!frames || frames->workers() != look_ahead)
+                  frames = std::make_unique<frame_pipeline>(
+                    look_ahead, 2 * look_ahead, &exec_frame_output);
+
+                if (frames->version() != version)
+                  frames->reset(*exe, version);
+
+                // playhead moved
+                frames->cancel_if([&](auto t) {
+                  return t != arg_time
+                         && std::find(ahead.begin(), ahead.end(), t)
+                              == ahead.end();
+                });
+              }
+
+              // rendered frames to store in preview cache
+              auto rendered = std::vector<frame_pipeline::frame>();
+
+              // serve frame from preview cache or frames ahead
+              auto img = cached;
+
+              if (!img && frames && frames->contains(arg_time)) {
+                // frames are delivered in order
+                while (auto f = frames->pop()) {
+                  rendered.push_back(*f);
+                  if (f->time == arg_time) {
+                    img = f->image;
+                    break;
+                  }
+                }
+              }
+
+              if (!img)
+                img = exec(arg_time);
 
               auto run_end = steady_clock::now();
               auto compute_time =
                 duration_cast<milliseconds>(run_end - run_bgn);
 
+              // costs of this frame
+              auto profile = profiler ? profiler->take()
+                                      : std::vector<compiler::node_cost>();
+
+              if (!cached)
+                rendered.push_back({arg_time, version, img});
+
+              if (frames) {
+                while (auto f = frames->try_pop())
+                  rendered.push_back(std::move(*f));
+
+                // queue frames ahead, until pipeline is full
+                for (auto&& t : ahead) {
+                  if (frames->full())
+                    break;
+                  frames->push(t);
+                }
+              }
+
+              {
+                auto lck    = dctx.get_data<editor_data>();
+                auto& cache = lck.ref().executor_data().frame_cache();
+                for (auto&& f : rendered) {
+                  if (f.image)
+                    cache.set(f.version, f.time, f.image);
+                }
+              }
+
+              // frame abandoned by cancellation
+              auto abandoned = !img && tok.is_cancelled();
+
+              {
+                std::unique_lock lck {mtx};
+                current_frame = std::nullopt;
+                if (!abandoned)
+                  abandoned_edits = 0;
+              }
+
               // continuous: limit frame rate.
               // TODO: use more accurate timer, or busy loop
-              if (run_end < end_limit) {
+              if (!abandoned && run_end < end_limit) {
                 std::this_thread::sleep_for(end_limit - run_end);
                 run_end = end_limit;
               }
@@ -215,12 +485,14 @@ namespace yave::editor {
                 auto& executor = lck.ref().executor_data();
                 auto& scene    = lck.ref().scene_config();
 
-                executor.set_result(
-                  {.arg_time     = arg_time,
-                   .image        = img,
-                   .compute_time = compute_time,
-                   .begin_time   = run_bgn,
-                   .end_time     = run_end});
+                if (!abandoned)
+                  executor.set_result(
+                    {.arg_time     = arg_time,
+                     .image        = img,
+                     .compute_time = compute_time,
+                     .begin_time   = run_bgn,
+                     .end_time     = run_end,
+                     .profile      = std::move(profile)});
 
                 if (executor.continuous_execution()) {
                   execute_flag = true;
@@ -228,6 +500,7 @@ namespace yave::editor {
               }
             }
           }
+          frames = nullptr;
           log_info("Stopped executor thread");
         } catch (...) {
           log_error("Exception detected in executor thread");
@@ -244,12 +517,57 @@ namespace yave::editor {
       thread.join();
     }
 
+    /// cancel current frame by edit of graph or arguments. guarded by mtx.
+    void cancel_edited()
+    {
+      if (token.is_cancelled())
+        return;
+
+      // minimum progress: let current frame finish after too many frames
+      // were abandoned. edits are applied on next frame.
+      if (abandoned_edits == max_abandoned_edits)
+        return;
+
+      ++abandoned_edits;
+      token.cancel();
+    }
+
     void notify_execute()
     {
       check_failure();
-      execute_flag = true;
+
+      auto request = [&] {
+        auto lck = dctx.get_data<editor_data>();
+        return frame_request {
+          lck.ref().executor_data().arg_time(),
+          lck.ref().compiler_data().version(),
+          lck.ref().update_channel().version()};
+      }();
+
+      {
+        std::unique_lock lck {mtx};
+
+        if (!current_frame || current_frame->arg_time != request.arg_time)
+          token.cancel();
+        else if (
+          current_frame->compile_version != request.compile_version
+          || current_frame->update_version != request.update_version)
+          cancel_edited();
+
+        execute_flag = true;
+      }
       cond.notify_one();
     }
+
+    void cancel_execute()
+    {
+      check_failure();
+      std::unique_lock lck {mtx};
+
+      // frame which is not started yet uses latest executable
+      if (current_frame)
+        cancel_edited();
+    }
   };
 
   execute_thread::execute_thread(data_context& dctx)
@@ -276,6 +594,11 @@ namespace yave::editor {
     m_pimpl->notify_execute();
   }
 
+  void execute_thread::cancel_execute()
+  {
+    m_pimpl->cancel_execute();
+  }
+
   class execute_thread_data::impl
   {
   public:
@@ -284,12 +607,20 @@ namespace yave::editor {
     yave::time loop_range_max;
     bool continuous_execution = false;
     bool loop_execution       = false;
+    bool parallel_execution   = false;
+    bool profiling            = false;
+    size_t signal_cache_budget = compiler::signal_cache::default_budget;
+
+    size_t look_ahead = task_pool::default_worker_count();
+
+    editor::frame_cache frame_cache;
 
     std::shared_ptr<const yave::image> last_image;
     yave::time last_arg_time;
     std::chrono::milliseconds last_compute_time;
     std::chrono::steady_clock::time_point last_begin_time;
     std::chrono::steady_clock::time_point last_end_time;
+    std::vector<compiler::node_cost> last_profile;
   };
 
   execute_thread_data::execute_thread_data()
@@ -352,6 +683,56 @@ namespace yave::editor {
     m_pimpl->loop_execution = b;
   }
 
+  bool execute_thread_data::parallel_execution() const
+  {
+    return m_pimpl->parallel_execution;
+  }
+
+  void execute_thread_data::set_parallel_execution(bool b)
+  {
+    m_pimpl->parallel_execution = b;
+  }
+
+  bool execute_thread_data::profiling() const
+  {
+    return m_pimpl->profiling;
+  }
+
+  void execute_thread_data::set_profiling(bool b)
+  {
+    m_pimpl->profiling = b;
+  }
+
+  auto execute_thread_data::signal_cache_budget() const -> size_t
+  {
+    return m_pimpl->signal_cache_budget;
+  }
+
+  void execute_thread_data::set_signal_cache_budget(size_t bytes)
+  {
+    m_pimpl->signal_cache_budget = bytes;
+  }
+
+  auto execute_thread_data::look_ahead() const -> size_t
+  {
+    return m_pimpl->look_ahead;
+  }
+
+  void execute_thread_data::set_look_ahead(size_t n)
+  {
+    m_pimpl->look_ahead = n;
+  }
+
+  auto execute_thread_data::frame_cache() const -> const editor::frame_cache&
+  {
+    return m_pimpl->frame_cache;
+  }
+
+  auto execute_thread_data::frame_cache() -> editor::frame_cache&
+  {
+    return m_pimpl->frame_cache;
+  }
+
   auto execute_thread_data::last_arg_time() const -> yave::time
   {
     return m_pimpl->last_arg_time;
@@ -381,6 +762,12 @@ namespace yave::editor {
     return m_pimpl->last_image;
   }
 
+  auto execute_thread_data::last_profile() const
+    -> const std::vector<compiler::node_cost>&
+  {
+    return m_pimpl->last_profile;
+  }
+
   void execute_thread_data::set_result(result_data results)
   {
     auto& impl = *m_pimpl;
@@ -390,6 +777,7 @@ namespace yave::editor {
     impl.last_compute_time = results.compute_time;
     impl.last_begin_time   = results.begin_time;
     impl.last_end_time     = results.end_time;
+    impl.last_profile      = std::move(results.profile);
   }
 
 } // namespace yave::editor
\ No newline at end of file
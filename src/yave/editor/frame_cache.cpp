@@ -0,0 +1,114 @@
+//
+// Copyright (c) 2019 mocabe (https://github.com/mocabe)
+// Distributed under LGPLv3 License. See LICENSE for more details.
+//
+
+#include <yave/editor/frame_cache.hpp>
+
+namespace yave::editor {
+
+  frame_cache::frame_cache(size_t budget)
+    : m_budget {budget}
+  {
+  }
+
+  frame_cache::frame_cache(frame_cache&&) noexcept = default;
+  frame_cache::~frame_cache() noexcept             = default;
+  frame_cache& frame_cache::operator=(frame_cache&&) noexcept = default;
+
+  auto frame_cache::get(uint64_t version, const time& t)
+    -> std::shared_ptr<const image>
+  {
+    if (version != m_version)
+      return nullptr;
+
+    auto it = m_index.find(t.count());
+
+    if (it == m_index.end())
+      return nullptr;
+
+    // move to front
+    m_entries.splice(m_entries.begin(), m_entries, it->second);
+    return it->second->img;
+  }
+
+  bool frame_cache::contains(uint64_t version, const time& t) const
+  {
+    return version == m_version && m_index.contains(t.count());
+  }
+
+  void frame_cache::set(
+    uint64_t version,
+    const time& t,
+    std::shared_ptr<const image> img)
+  {
+    assert(img);
+
+    // frames of old executable are no longer reachable
+    if (version != m_version) {
+      clear();
+      m_version = version;
+    }
+
+    auto cost = size_t(img->byte_size());
+
+    if (cost > m_budget)
+      return;
+
+    if (auto it = m_index.find(t.count()); it != m_index.end()) {
+      m_usage -= it->second->img->byte_size();
+      m_entries.erase(it->second);
+      m_index.erase(it);
+    }
+
+    m_entries.push_front({t.count(), std::move(img)});
+    m_index.emplace(t.count(), m_entries.begin());
+    m_usage += cost;
+
+    evict();
+  }
+
+  void frame_cache::evict()
+  {
+    while (m_usage > m_budget && !m_entries.empty()) {
+      auto& last = m_entries.back();
+      m_usage -= last.img->byte_size();
+      m_index.erase(last.t);
+      m_entries.pop_back();
+    }
+  }
+
+  void frame_cache::clear()
+  {
+    m_entries.clear();
+    m_index.clear();
+    m_usage = 0;
+  }
+
+  auto frame_cache::version() const -> uint64_t
+  {
+    return m_version;
+  }
+
+  auto frame_cache::budget() const -> size_t
+  {
+    return m_budget;
+  }
+
+  void frame_cache::set_budget(size_t bytes)
+  {
+    m_budget = bytes;
+    evict();
+  }
+
+  auto frame_cache::usage() const -> size_t
+  {
+    return m_usage;
+  }
+
+  auto frame_cache::size() const -> size_t
+  {
+    return m_entries.size();
+  }
+
+} // namespace yave::editor
@@ -0,0 +1,342 @@
+//
+// Copyright (c) 2019 mocabe (https://github.com/mocabe)
+// Distributed under LGPLv3 License. See LICENSE for more details.
+//
+
+#include <yave/editor/frame_pipeline.hpp>
+#include <yave/support/log.hpp>
+#include <yave/support/trace.hpp>
+#include <yave/rts/cancel_token.hpp>
+#include <yave/rts/apply.hpp>
+
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <deque>
+#include <vector>
+#include <algorithm>
+
+YAVE_DECL_LOCAL_LOGGER(frame_pipeline);
+
+namespace yave::editor {
+
+  class frame_pipeline::impl
+  {
+    /// queued frame
+    struct job
+    {
+      yave::time t;
+      uint64_t version;
+      std::shared_ptr<const compiler::executable> exe;
+      bool running = false;
+      bool done    = false;
+      std::shared_ptr<const image> img;
+      /// cancelled when job is removed
+      cancel_token token;
+    };
+
+    const size_t m_capacity;
+    const render_function m_render;
+
+    mutable std::mutex m_mtx;
+    /// notified when new job is queued
+    std::condition_variable m_queue_cond;
+    /// notified when job is done
+    std::condition_variable m_done_cond;
+
+    /// queued jobs in delivery order
+    std::deque<std::shared_ptr<job>> m_jobs;
+    /// template of executables
+    std::shared_ptr<const compiler::executable> m_exe;
+    uint64_t m_version = 0;
+    /// number of running jobs
+    size_t m_running = 0;
+    bool m_terminate = false;
+
+    std::vector<std::thread> m_workers;
+
+    auto next_job() -> std::shared_ptr<job>
+    {
+      auto it = std::find_if(m_jobs.begin(), m_jobs.end(), [](auto& j) {
+        return !j->running;
+      });
+      return it == m_jobs.end() ? nullptr : *it;
+    }
+
+    void worker_loop()
+    {
+      set_trace_thread_name("frame worker");
+
+      // frames share memoized and cached results with other threads
+      detail::concurrent_eval = true;
+
+      while (true) {
+
+        auto lck = std::unique_lock(m_mtx);
+
+        auto j = std::shared_ptr<job>();
+        m_queue_cond.wait(
+          lck, [&] { return m_terminate || (j = next_job()) != nullptr; });
+
+        if (m_terminate)
+          break;
+
+        j->running = true;
+        ++m_running;
+        lck.unlock();
+
+        auto img = std::shared_ptr<const image>();
+        try {
+          YAVE_TRACE_SPAN("frame ahead");
+          auto scope = cancel_token::scope(j->token);
+          img        = m_render(j->exe->clone(), j->t);
+        } catch (...) {
+          if (!j->token.is_cancelled())
+            log_error("Exception detected while rendering frame");
+        }
+
+        lck.lock();
+        j->img  = std::move(img);
+        j->done = true;
+        --m_running;
+        m_done_cond.notify_all();
+      }
+    }
+
+    /// remove jobs and stop running ones
+    template <class Pred>
+    void remove_jobs(Pred&& pred)
+    {
+      std::erase_if(m_jobs, [&](auto& j) {
+        if (!pred(j))
+          return false;
+        j->token.cancel();
+        return true;
+      });
+    }
+
+    auto take_front() -> frame
+    {
+      auto j = std::move(m_jobs.front());
+      m_jobs.pop_front();
+      return {j->t, j->version, std::move(j->img)};
+    }
+
+  public:
+    impl(size_t n_workers, size_t capacity, render_function render)
+      : m_capacity {std::max<size_t>(capacity, 1)}
+      , m_render {std::move(render)}
+    {
+      n_workers = std::max<size_t>(n_workers, 1);
+      for (size_t i = 0; i < n_workers; ++i)
+        m_workers.emplace_back([this] { worker_loop(); });
+    }
+
+    ~impl() noexcept
+    {
+      {
+        auto lck = std::unique_lock(m_mtx);
+        remove_jobs([](auto&) { return true; });
+        m_terminate = true;
+      }
+      m_queue_cond.notify_all();
+      for (auto&& w : m_workers)
+        w.join();
+    }
+
+    auto workers() const
+    {
+      return m_workers.size();
+    }
+
+    auto capacity() const
+    {
+      return m_capacity;
+    }
+
+    auto size() const
+    {
+      auto lck = std::unique_lock(m_mtx);
+      return m_jobs.size();
+    }
+
+    bool full() const
+    {
+      auto lck = std::unique_lock(m_mtx);
+      return m_jobs.size() >= m_capacity;
+    }
+
+    void reset(const compiler::executable& exe, uint64_t version)
+    {
+      auto tmp = std::make_shared<const compiler::executable>(exe.clone());
+      auto lck = std::unique_lock(m_mtx);
+      remove_jobs([](auto&) { return true; });
+      m_exe     = std::move(tmp);
+      m_version = version;
+    }
+
+    auto version() const
+    {
+      auto lck = std::unique_lock(m_mtx);
+      return m_version;
+    }
+
+    bool contains(yave::time t) const
+    {
+      return std::any_of(m_jobs.begin(), m_jobs.end(), [&](auto& j) {
+        return j->t == t;
+      });
+    }
+
+    bool push(yave::time t)
+    {
+      {
+        auto lck = std::unique_lock(m_mtx);
+
+        if (!m_exe || m_jobs.size() >= m_capacity || contains(t))
+          return false;
+
+        auto j     = std::make_shared<job>();
+        j->t       = t;
+        j->version = m_version;
+        j->exe     = m_exe;
+        m_jobs.push_back(std::move(j));
+      }
+      m_queue_cond.notify_one();
+      return true;
+    }
+
+    bool contains_locked(yave::time t) const
+    {
+      auto lck = std::unique_lock(m_mtx);
+      return contains(t);
+    }
+
+    void cancel_if(const std::function<bool(yave::time)>& pred)
+    {
+      auto lck = std::unique_lock(m_mtx);
+      remove_jobs([&](auto& j) { return pred(j->t); });
+    }
+
+    bool busy() const
+    {
+      auto lck = std::unique_lock(m_mtx);
+      return m_running != 0;
+    }
+
+    void wait()
+    {
+      auto lck = std::unique_lock(m_mtx);
+      m_done_cond.wait(lck, [&] { return m_running == 0; });
+    }
+
+    auto pop() -> std::optional<frame>
+    {
+      auto lck = std::unique_lock(m_mtx);
+      m_done_cond.wait(
+        lck, [&] { return m_jobs.empty() || m_jobs.front()->done; });
+
+      if (m_jobs.empty())
+        return std::nullopt;
+
+      return take_front();
+    }
+
+    auto try_pop() -> std::optional<frame>
+    {
+      auto lck = std::unique_lock(m_mtx);
+
+      if (m_jobs.empty() || !m_jobs.front()->done)
+        return std::nullopt;
+
+      return take_front();
+    }
+  };
+
+  auto frame_pipeline::worker_count(size_t n, size_t frames) -> size_t
+  {
+    // workers can't render more frames than preview cache can hold
+    return frames > 1 ? std::min(n, frames - 1) : 0;
+  }
+
+  frame_pipeline::frame_pipeline(
+    size_t n_workers,
+    size_t capacity,
+    render_function render)
+    : m_pimpl {std::make_unique<impl>(n_workers, capacity, std::move(render))}
+  {
+  }
+
+  frame_pipeline::~frame_pipeline() noexcept = default;
+
+  auto frame_pipeline::workers() const -> size_t
+  {
+    return m_pimpl->workers();
+  }
+
+  auto frame_pipeline::capacity() const -> size_t
+  {
+    return m_pimpl->capacity();
+  }
+
+  auto frame_pipeline::size() const -> size_t
+  {
+    return m_pimpl->size();
+  }
+
+  bool frame_pipeline::full() const
+  {
+    return m_pimpl->full();
+  }
+
+  void frame_pipeline::reset(const compiler::executable& exe, uint64_t version)
+  {
+    m_pimpl->reset(exe, version);
+  }
+
+  auto frame_pipeline::version() const -> uint64_t
+  {
+    return m_pimpl->version();
+  }
+
+  bool frame_pipeline::push(yave::time t)
+  {
+    return m_pimpl->push(t);
+  }
+
+  bool frame_pipeline::contains(yave::time t) const
+  {
+    return m_pimpl->contains_locked(t);
+  }
+
+  void frame_pipeline::cancel_if(const std::function<bool(yave::time)>& pred)
+  {
+    m_pimpl->cancel_if(pred);
+  }
+
+  void frame_pipeline::cancel()
+  {
+    m_pimpl->cancel_if([](auto) { return true; });
+  }
+
+  bool frame_pipeline::busy() const
+  {
+    return m_pimpl->busy();
+  }
+
+  void frame_pipeline::wait()
+  {
+    m_pimpl->wait();
+  }
+
+  auto frame_pipeline::pop() -> std::optional<frame>
+  {
+    return m_pimpl->pop();
+  }
+
+  auto frame_pipeline::try_pop() -> std::optional<frame>
+  {
+    return m_pimpl->try_pop();
+  }
+
+} // namespace yave::editor
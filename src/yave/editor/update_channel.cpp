@@ -16,11 +16,13 @@ namespace yave::editor {
   class node_argument_update_channel::impl
   {
     std::vector<update_data> updates;
+    uint64_t version = 0;
 
   public:
     void push_update(update_data d)
     {
       assert(d.arg && d.data);
+      ++version;
       for (auto&& u : updates) {
         if (u.arg == d.arg) {
           u.data = std::move(d.data);
@@ -30,13 +32,27 @@ namespace yave::editor {
       updates.push_back(std::move(d));
     }
 
-    auto apply_updates()
+    auto apply_updates() -> bool
     {
+      if (updates.empty())
+        return false;
+
       for (auto&& u : updates) {
         assert(u.arg && u.data);
         u.arg->set_value_untyped(u.data);
       }
       updates.clear();
+      return true;
+    }
+
+    bool has_updates() const
+    {
+      return !updates.empty();
+    }
+
+    auto get_version() const -> uint64_t
+    {
+      return version;
     }
 
     auto find_value(const object_ptr<PropertyTreeNode>& p) const
@@ -95,11 +111,21 @@ namespace yave::editor {
     m_pimpl->push_update(std::move(data));
   }
 
-  void node_argument_update_channel::apply_updates()
+  bool node_argument_update_channel::apply_updates()
   {
     return m_pimpl->apply_updates();
   }
 
+  bool node_argument_update_channel::has_updates() const
+  {
+    return m_pimpl->has_updates();
+  }
+
+  auto node_argument_update_channel::version() const -> uint64_t
+  {
+    return m_pimpl->get_version();
+  }
+
   auto node_argument_update_channel::get_current_value(
     const object_ptr<PropertyTreeNode>& arg) const
     -> object_ptr<const PropertyTreeNode>
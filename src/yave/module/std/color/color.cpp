@@ -41,6 +41,8 @@ namespace yave {
 
     struct ColorCtor : SignalFunction<ColorCtor, Color, Color>
     {
+      static constexpr auto _attributes = pure_signal_function;
+
       auto code() const -> return_type
       {
         return arg<0>();
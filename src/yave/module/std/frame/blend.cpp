@@ -26,6 +26,8 @@ namespace yave {
     struct BlendFrame
       : SignalFunction<BlendFrame, FrameBuffer, FrameBuffer, FrameBuffer>
     {
+      static constexpr auto _attributes = pure_signal_function;
+
       data::frame_buffer_manager& m_fbm;
       vulkan::rgba32f_offscreen_compositor& m_compositor;
       vulkan::rgba32f_offscreen_render_pass& m_render_pass;
@@ -41,12 +43,14 @@ namespace yave {
 
       auto code() const -> return_type
       {
-        auto src = eval_arg<0>();
-        auto dst = eval_arg<1>().clone();
+        auto [src, d] = eval_args<0, 1>();
+        auto dst      = d.clone();
 
         auto w = src->width();
         auto h = src->height();
 
+        auto lck = m_fbm.lock();
+
         assert(m_fbm.exists(src->id()) && m_fbm.exists(dst->id()));
 
         m_compositor.compose_source(m_fbm.get_texture_data(dst->id()));
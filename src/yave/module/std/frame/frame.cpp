@@ -27,6 +27,8 @@ namespace yave {
     struct FrameBufferColored
       : SignalFunction<FrameBufferColored, Color, FrameBuffer>
     {
+      static constexpr auto _attributes = pure_signal_function;
+
       data::frame_buffer_manager& m_fbm;
       vulkan::rgba32f_offscreen_render_pass& m_render_pass;
 
@@ -47,6 +49,7 @@ namespace yave {
 
         // fill
         if (c != glm::fvec4(0.f)) {
+          auto lck = m_fbm.lock();
           m_render_pass.clear_texture(
             m_fbm.get_texture_data(fb->id()), std::array {c.r, c.g, c.b, c.a});
         }
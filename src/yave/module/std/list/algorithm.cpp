@@ -9,6 +9,9 @@
 #include <yave/signal/list.hpp>
 #include <yave/obj/primitive/property.hpp>
 
+#include <algorithm>
+#include <vector>
+
 namespace yave {
 
   auto node_declaration_traits<node::List::Algo::Map>::get_node_declaration()
@@ -118,20 +121,180 @@ namespace yave {
       }
     };
 
+    /// proxy type of list element
+    template <class L>
+    using list_head_t = typename decltype(
+      std::declval<const object_ptr<const L>&>()->head())::element_type;
+
+    struct StrictListMap;
+    struct ListRepeat;
+    struct ListEnumerate;
+
+    // \fd.idx
+    struct ListEnumerateH : SignalFunction<ListEnumerateH, Int>
+    {
+      int m_idx;
+
+      ListEnumerateH(int idx)
+        : m_idx {idx}
+      {
+      }
+
+      auto code() const -> return_type
+      {
+        return make_object<Int>(m_idx);
+      }
+    };
+
+    /// Evaluate signal with demand.
+    auto eval_signal(
+      const object_ptr<const Object>& sig,
+      const object_ptr<const FrameDemand>& demand) -> object_ptr<const Object>
+    {
+      auto thunk = sig << demand;
+
+      if (auto r = get_register(sig))
+        return r->invoke(thunk);
+
+      return eval(std::move(thunk));
+    }
+
+    /// Application of closure which only waits for frame demand.
+    struct list_producer
+    {
+      /// code of closure
+      decltype(closure_info_table::code) code = nullptr;
+      /// signal arguments, from first to last
+      std::vector<object_ptr<const Object>> args;
+    };
+
+    /// Get producer of list signal.
+    /// Looks through registers of bytecode program and partial applications.
+    auto get_list_producer(const object_ptr<const Object>& sig) -> list_producer
+    {
+      auto [depth, bottom] = detail::inspect_spine(sig);
+
+      if (auto r = get_register(sig)) {
+        depth  = 0;
+        bottom = r->instruction().closure();
+      }
+
+      auto closure = value_cast_if<Closure<>>(bottom);
+
+      if (!closure || closure->arity != depth + 1)
+        return {};
+
+      auto n    = closure->n_args();
+      auto args = std::vector<object_ptr<const Object>>(n - 1);
+
+      // arguments in local stack of closure
+      for (auto i = closure->arity; i < n; ++i)
+        args[n - i - 1] = closure->arg(i);
+
+      // arguments on spine, from last to first
+      auto idx  = n - 1;
+      auto* cur = &sig;
+
+      object_ptr<const Object> cached;
+
+      while (auto vert = value_cast_if<Apply>(*cur)) {
+
+        auto& storage = _get_storage(*vert);
+
+        if (storage.is_result()) {
+          cached = storage.get_result();
+          cur    = &cached;
+          continue;
+        }
+
+        args[--idx] = storage.arg();
+        cur         = &storage.app();
+      }
+      assert(idx == n - closure->arity);
+
+      return {closure->get_info_table()->code, std::move(args)};
+    }
+
+    /// Fused pipeline of list algorithms.
+    /// Adjacent Map, Enumerate and Repeat nodes are peeled from signal of
+    /// input list and their elements are streamed one by one, so intermediate
+    /// lists are never materialized.
+    class list_stream
+    {
+    public:
+      /// Build stream from signal of list.
+      list_stream(
+        object_ptr<const Object> sig,
+        object_ptr<const FrameDemand> demand);
+
+      /// Push Map stage on top of stream.
+      void map(object_ptr<const Object> fn)
+      {
+        m_stages.push_back({stage_kind::map, std::move(fn)});
+      }
+
+      /// Push Enumerate stage on top of stream.
+      void enumerate(object_ptr<const Object> fn)
+      {
+        m_stages.push_back({stage_kind::enumerate, std::move(fn)});
+      }
+
+      /// Call fn on each element in list order.
+      /// \param reverse visit elements from last to first
+      template <class F>
+      void for_each(bool reverse, F&& fn) const;
+
+    private:
+      enum class stage_kind
+      {
+        map,
+        enumerate,
+      };
+
+      struct stage
+      {
+        stage_kind kind;
+        object_ptr<const Object> fn;
+      };
+
+      /// Apply stages to element of source.
+      /// \param j index of element in source
+      /// \param n size of source
+      auto apply(object_ptr<const Object> x, size_t j, size_t n) const
+        -> object_ptr<const Object>;
+
+    private:
+      /// stages from source to sink
+      std::vector<stage> m_stages;
+      /// evaluated list
+      using list_t = decltype(
+        eval(std::declval<const object_ptr<const SList<X>>&>()->tail()));
+
+      /// source list
+      list_t m_list;
+      /// repeated element of source
+      object_ptr<const Object> m_repeat;
+      /// number of repeated elements
+      size_t m_count = 0;
+    };
+
     struct StrictListMap
       : SignalFunction<StrictListMap, SList<X>, sf<X, Y>, SList<Y>>
     {
       auto code() const -> return_type
       {
-        auto l = eval_arg<0>();
-        auto f = arg_signal<1>();
+        using head_t = list_head_t<SList<Y>>;
+
+        auto s = list_stream(arg_signal<0>(), arg_demand());
+        s.map(arg_signal<1>());
 
         auto ret = make_object<SList<Y>>();
 
-        while (!l->is_nil()) {
-          ret = make_object<SList<Y>>(f << l->head(), ret);
-          l   = eval(l->tail());
-        }
+        s.for_each(true, [&](auto&& x) {
+          ret = make_object<SList<Y>>(
+            static_object_cast<head_t>(std::move(x)),
+            ret);
+        });
         return ret;
       }
     };
@@ -160,53 +323,143 @@ namespace yave {
     {
       auto code() const -> return_type
       {
-        auto l = eval_arg<0>();
-        auto f = arg_signal<1>();
+        using head_t = list_head_t<SList<Y>>;
 
-        auto ret = make_object<SList<Y>>();
-
-        // \fd.idx
-        struct ListEnumerateH : SignalFunction<ListEnumerateH, Int>
-        {
-          int m_idx;
+        auto s = list_stream(arg_signal<0>(), arg_demand());
+        s.enumerate(arg_signal<1>());
 
-          ListEnumerateH(int idx)
-            : m_idx {idx}
-          {
-          }
-
-          auto code() const -> return_type
-          {
-            return make_object<Int>(m_idx);
-          }
-        };
+        auto ret = make_object<SList<Y>>();
 
-        auto idx = 0;
-        while (!l->is_nil()) {
+        s.for_each(true, [&](auto&& x) {
           ret = make_object<SList<Y>>(
-            eval(f << make_object<ListEnumerateH>(idx) << l->head()), ret);
-          l = eval(l->tail());
-          ++idx;
-        }
+            static_object_cast<head_t>(std::move(x)),
+            ret);
+        });
         return ret;
       }
     };
 
     struct ListFold : SignalFunction<ListFold, SList<X>, sf<Y, X, Y>, Y, Y>
     {
+      // \fd.v
+      struct ListFoldH : Function<ListFoldH, Y, FrameDemand, Y>
+      {
+        auto code() const -> return_type
+        {
+          return arg<0>();
+        }
+      };
+
       auto code() const -> return_type
       {
-        auto l = eval_arg<0>();
+        using head_t = list_head_t<SList<X>>;
+
+        auto s = list_stream(arg_signal<0>(), arg_demand());
         auto f = arg_signal<1>();
-        auto v = eval(arg_signal<2>());
+        auto d = arg_demand();
+        auto v = eval_arg<2>();
+
+        // strict fold; accumulator is evaluated at each step so evaluation
+        // does not nest for long lists.
+        s.for_each(false, [&](auto&& x) {
+          v = eval(
+            f << (make_object<ListFoldH>() << v)
+              << static_object_cast<head_t>(std::move(x)) << d);
+        });
+        return v;
+      }
+    };
+
+    list_stream::list_stream(
+      object_ptr<const Object> sig,
+      object_ptr<const FrameDemand> demand)
+    {
+      for (;;) {
+
+        auto p = get_list_producer(sig);
+
+        if (p.code == &detail::vtbl_code_func<StrictListMap>) {
+          m_stages.push_back({stage_kind::map, std::move(p.args[1])});
+          sig = std::move(p.args[0]);
+          continue;
+        }
+
+        if (p.code == &detail::vtbl_code_func<ListEnumerate>) {
+          m_stages.push_back({stage_kind::enumerate, std::move(p.args[1])});
+          sig = std::move(p.args[0]);
+          continue;
+        }
+
+        if (p.code == &detail::vtbl_code_func<ListRepeat>) {
+          auto n   = value_cast<Int>(eval_signal(p.args[1], demand));
+          m_repeat = std::move(p.args[0]);
+          m_count  = *n < 0 ? 0 : static_cast<size_t>(*n);
+          break;
+        }
+
+        m_list = static_object_cast<typename list_t::element_type>(
+          eval_signal(sig, demand));
+        break;
+      }
+
+      // stages were peeled from sink
+      std::reverse(m_stages.begin(), m_stages.end());
+    }
+
+    auto list_stream::apply(object_ptr<const Object> x, size_t j, size_t n)
+      const -> object_ptr<const Object>
+    {
+      for (size_t k = 0; k < m_stages.size(); ++k) {
 
-        while (!l->is_nil()) {
-          v = eval(f << v << l->head());
+        auto& s = m_stages[k];
+
+        if (s.kind == stage_kind::map) {
+          x = s.fn << x;
+          continue;
+        }
+
+        // each stage reverses order of its input
+        auto idx = static_cast<int>(k % 2 == 0 ? j : n - j - 1);
+        x        = eval(s.fn << make_object<ListEnumerateH>(idx) << x);
+      }
+      return x;
+    }
+
+    template <class F>
+    void list_stream::for_each(bool reverse, F&& fn) const
+    {
+      auto odd = m_stages.size() % 2 == 1;
+
+      // index of enumerate stage depends on size of source
+      auto sized = false;
+      for (size_t k = 1; k < m_stages.size(); k += 2)
+        sized |= m_stages[k].kind == stage_kind::enumerate;
+
+      // walk source list directly when possible
+      if (m_list && reverse == odd && !sized) {
+        auto l = m_list;
+        for (size_t j = 0; !l->is_nil(); ++j) {
+          fn(apply(l->head(), j, 0));
           l = eval(l->tail());
         }
-        return v << arg_demand();
+        return;
       }
-    };
+
+      auto elems = std::vector<object_ptr<const Object>>();
+
+      if (m_list) {
+        for (auto l = m_list; !l->is_nil(); l = eval(l->tail()))
+          elems.push_back(l->head());
+      }
+
+      auto n = m_list ? elems.size() : m_count;
+
+      for (size_t c = 0; c < n; ++c) {
+        auto i = reverse ? n - c - 1 : c;
+        auto j = odd ? n - i - 1 : i;
+        fn(apply(m_list ? elems[j] : m_repeat, j, n));
+      }
+    }
 
   } // namespace modules::_std::list
 
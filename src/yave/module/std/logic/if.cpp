@@ -26,6 +26,8 @@ namespace yave {
 
     struct If : SignalFunction<If, Bool, X, X, X>
     {
+      static constexpr auto _attributes = pure_signal_function;
+
       auto code() const -> return_type
       {
         if (*eval_arg<0>())
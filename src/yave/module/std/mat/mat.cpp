@@ -89,6 +89,8 @@ namespace yave {
     // Mat4 constructor
     struct Mat4Ctor : SignalFunction<Mat4Ctor, Mat4>
     {
+      static constexpr auto _attributes = pure_signal_function;
+
       return_type code() const
       {
         return make_object<Mat4>(1);
@@ -98,6 +100,8 @@ namespace yave {
     // Mat4 Rotate
     struct Mat4Rotate : SignalFunction<Mat4Rotate, Mat4, Float, Vec3, Mat4>
     {
+      static constexpr auto _attributes = pure_signal_function;
+
       auto code() const -> return_type
       {
         auto transform = eval_arg<0>();
@@ -118,6 +122,8 @@ namespace yave {
     // Mat4 RotateX
     struct Mat4RotateX : SignalFunction<Mat4RotateX, Mat4, Float, Mat4>
     {
+      static constexpr auto _attributes = pure_signal_function;
+
       auto code() const -> return_type
       {
         auto transform = eval_arg<0>();
@@ -131,6 +137,8 @@ namespace yave {
     // Mat4 RotateY
     struct Mat4RotateY : SignalFunction<Mat4RotateY, Mat4, Float, Mat4>
     {
+      static constexpr auto _attributes = pure_signal_function;
+
       auto code() const -> return_type
       {
         auto transform = eval_arg<0>();
@@ -144,6 +152,8 @@ namespace yave {
     // Mat4 RotateZ
     struct Mat4RotateZ : SignalFunction<Mat4RotateZ, Mat4, Float, Mat4>
     {
+      static constexpr auto _attributes = pure_signal_function;
+
       auto code() const -> return_type
       {
         auto transform = eval_arg<0>();
@@ -157,6 +167,8 @@ namespace yave {
     // Mat4 Transform
     struct Mat4Translate : SignalFunction<Mat4Translate, Mat4, Vec3, Mat4>
     {
+      static constexpr auto _attributes = pure_signal_function;
+
       auto code() const -> return_type
       {
         auto t = eval_arg<0>();
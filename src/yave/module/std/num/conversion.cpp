@@ -34,17 +34,21 @@ namespace yave {
 
     struct IntToFloat : SignalFunction<IntToFloat, Int, Float>
     {
+      static constexpr auto _attributes = pure_signal_function;
+
       auto code() const -> return_type
       {
-        return make_object<Float>(static_cast<double>(*eval_arg<0>()));
+        return make_immediate<Float>(static_cast<double>(*eval_arg<0>()));
       }
     };
 
     struct FloatToInt : SignalFunction<FloatToInt, Float, Int>
     {
+      static constexpr auto _attributes = pure_signal_function;
+
       auto code() const -> return_type
       {
-        return make_object<Int>(static_cast<long>(*eval_arg<0>()));
+        return make_immediate<Int>(static_cast<int64_t>(*eval_arg<0>()));
       }
     };
 
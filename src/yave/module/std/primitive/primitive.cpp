@@ -30,6 +30,8 @@ namespace yave {
     template <class T>
     struct PrimitiveCtor : SignalFunction<PrimitiveCtor<T>, T, T>
     {
+      static constexpr auto _attributes = pure_signal_function;
+
       auto code() const -> typename PrimitiveCtor::return_type
       {
         return PrimitiveCtor::template eval_arg<0>();
@@ -56,6 +56,8 @@ namespace yave {
 
     struct Uniform : SignalFunction<Uniform, Int, Float, Float, Int, Float>
     {
+      static constexpr auto _attributes = pure_signal_function;
+
       auto code() const -> return_type
       {
         auto idx  = *eval_arg<0>();
@@ -79,6 +81,8 @@ namespace yave {
 
     struct Normal : SignalFunction<Normal, Int, Float, Float, Int, Float>
     {
+      static constexpr auto _attributes = pure_signal_function;
+
       auto code() const -> return_type
       {
         auto idx    = *eval_arg<0>();
@@ -56,6 +56,8 @@ namespace yave {
 
     struct FillShape : SignalFunction<FillShape, Shape, Color, Shape>
     {
+      static constexpr auto _attributes = pure_signal_function;
+
       auto code() const -> return_type
       {
         auto shape = eval_arg<0>();
@@ -71,6 +73,8 @@ namespace yave {
 
     struct StrokeShape : SignalFunction<StrokeShape, Shape, Color, Float, Shape>
     {
+      static constexpr auto _attributes = pure_signal_function;
+
       auto code() const -> return_type
       {
         auto shape = eval_arg<0>();
@@ -87,6 +91,8 @@ namespace yave {
 
     struct DrawShape : SignalFunction<DrawShape, Shape, FrameBuffer>
     {
+      static constexpr auto _attributes = pure_signal_function;
+
       data::frame_buffer_manager& m_fbm;
       vulkan::rgba32f_offscreen_compositor& m_compositor;
 
@@ -109,6 +115,8 @@ namespace yave {
         auto img =
           draw_shape_bgra8(yave::shape(*shape), fb->width(), fb->height());
 
+        auto lck = m_fbm.lock();
+
         auto tex = m_compositor.render_pass().create_texture(
           {fb->width(), fb->height()}, vk::Format::eB8G8R8A8Unorm);
 
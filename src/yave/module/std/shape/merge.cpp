@@ -25,11 +25,12 @@ namespace yave {
 
     struct MergeShape : SignalFunction<MergeShape, Shape, Shape, Shape>
     {
+      static constexpr auto _attributes = pure_signal_function;
+
       auto code() const -> return_type
       {
-        auto s1 = eval_arg<0>();
-        auto s2 = eval_arg<1>();
-        auto s  = s2.clone();
+        auto [s1, s2] = eval_args<0, 1>();
+        auto s        = s2.clone();
         s->merge(*s1);
         return s;
       }
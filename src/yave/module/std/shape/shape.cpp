@@ -53,6 +53,8 @@ namespace yave {
 
     struct Rect : SignalFunction<Rect, Vec2, Vec2, Shape>
     {
+      static constexpr auto _attributes = pure_signal_function;
+
       auto code() const -> return_type
       {
         auto pos  = eval_arg<0>();
@@ -63,6 +65,8 @@ namespace yave {
 
     struct Circle : SignalFunction<Circle, Vec2, Float, Shape>
     {
+      static constexpr auto _attributes = pure_signal_function;
+
       auto code() const -> return_type
       {
         auto pos = eval_arg<0>();
@@ -73,6 +77,8 @@ namespace yave {
 
     struct Shape : SignalFunction<Shape, yave::Shape>
     {
+      static constexpr auto _attributes = pure_signal_function;
+
       auto code() const -> return_type
       {
         return make_object<yave::Shape>(yave::shape());
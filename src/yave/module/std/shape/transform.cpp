@@ -51,6 +51,8 @@ namespace yave {
 
     struct Translate : SignalFunction<Translate, Shape, Vec2, Shape>
     {
+      static constexpr auto _attributes = pure_signal_function;
+
       auto code() const -> return_type
       {
         auto s = eval_arg<0>();
@@ -65,6 +67,8 @@ namespace yave {
 
     struct Rotate : SignalFunction<Rotate, Shape, Float, Vec2, Shape>
     {
+      static constexpr auto _attributes = pure_signal_function;
+
       auto code() const -> return_type
       {
         auto s = eval_arg<0>();
@@ -80,6 +84,8 @@ namespace yave {
 
     struct Scale : SignalFunction<Scale, Shape, Float, Vec2, Shape>
     {
+      static constexpr auto _attributes = pure_signal_function;
+
       auto code() const -> return_type
       {
         auto s = eval_arg<0>();
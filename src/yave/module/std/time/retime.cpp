@@ -51,6 +51,8 @@ namespace yave {
 
     struct ReTime : SignalFunction<ReTime, X, FrameTime, X>
     {
+      static constexpr auto _attributes = closure_attributes::pure;
+
       auto code() const -> return_type
       {
         return arg_signal<0>() << make_object<FrameDemand>(eval_arg<1>());
@@ -59,6 +61,8 @@ namespace yave {
 
     struct DelayTime : SignalFunction<DelayTime, X, FrameTime, X>
     {
+      static constexpr auto _attributes = closure_attributes::pure;
+
       auto code() const -> return_type
       {
         // t - delay
@@ -70,6 +74,8 @@ namespace yave {
 
     struct ScaleTime : SignalFunction<ScaleTime, X, Float, X>
     {
+      static constexpr auto _attributes = closure_attributes::pure;
+
       auto code() const -> return_type
       {
         // t * scale
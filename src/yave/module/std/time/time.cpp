@@ -50,6 +50,8 @@ namespace yave {
 
     struct TimeConstructor : SignalFunction<TimeConstructor, FrameTime>
     {
+      static constexpr auto _attributes = closure_attributes::pure;
+
       auto code() const -> return_type
       {
         return arg_time();
@@ -58,6 +60,8 @@ namespace yave {
 
     struct ToSeconds : SignalFunction<ToSeconds, FrameTime, Float>
     {
+      static constexpr auto _attributes = pure_signal_function;
+
       auto code() const -> return_type
       {
         return make_object<Float>(eval_arg<0>()->seconds().count());
@@ -66,6 +70,8 @@ namespace yave {
 
     struct FromSeconds : SignalFunction<FromSeconds, Float, FrameTime>
     {
+      static constexpr auto _attributes = pure_signal_function;
+
       auto code() const -> return_type
       {
         return make_object<FrameTime>(yave::time::seconds(*eval_arg<0>()));
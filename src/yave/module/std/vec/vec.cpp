@@ -55,6 +55,8 @@ namespace yave {
 
     struct Vec2Constructor : SignalFunction<Vec2Constructor, Float, Float, Vec2>
     {
+      static constexpr auto _attributes = pure_signal_function;
+
       return_type code() const
       {
         return make_object<Vec2>(*eval_arg<0>(), *eval_arg<1>());
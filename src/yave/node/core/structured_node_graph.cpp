@@ -21,6 +21,7 @@
 #include <string_view>
 #include <algorithm>
 #include <regex>
+#include <atomic>
 
 YAVE_DECL_LOCAL_LOGGER(structured_node_graph)
 
@@ -2437,6 +2438,15 @@ namespace yave {
   {
     impl m_impl;
 
+    /// version stamp
+    uint64_t m_version = new_version();
+
+    static auto new_version() -> uint64_t
+    {
+      static std::atomic<uint64_t> counter = 0;
+      return ++counter;
+    }
+
   public:
     impl_wrap() = default;
 
@@ -2445,6 +2455,17 @@ namespace yave {
     {
     }
 
+  public:
+    auto version() const
+    {
+      return m_version;
+    }
+
+    void touch()
+    {
+      m_version = new_version();
+    }
+
   public:
     template <class Handle>
     bool exists(const Handle& h) const
@@ -3086,6 +3107,7 @@ namespace yave {
     const node_handle& node,
     const std::string& name)
   {
+    m_pimpl->touch();
     m_pimpl->set_name(node, name);
   }
 
@@ -3093,6 +3115,7 @@ namespace yave {
     const socket_handle& socket,
     const std::string& name)
   {
+    m_pimpl->touch();
     m_pimpl->set_name(socket, name);
   }
 
@@ -3127,6 +3150,7 @@ namespace yave {
     const std::string& name,
     object_ptr<PropertyTreeNode> data)
   {
+    m_pimpl->touch();
     m_pimpl->set_property(h, name, std::move(data));
   }
 
@@ -3135,6 +3159,7 @@ namespace yave {
     const std::string& name,
     object_ptr<PropertyTreeNode> data)
   {
+    m_pimpl->touch();
     m_pimpl->set_property(h, name, std::move(data));
   }
 
@@ -3142,6 +3167,7 @@ namespace yave {
     const node_handle& h,
     const std::string& name)
   {
+    m_pimpl->touch();
     m_pimpl->remove_property(h, name);
   }
 
@@ -3149,6 +3175,7 @@ namespace yave {
     const socket_handle& h,
     const std::string& name)
   {
+    m_pimpl->touch();
     m_pimpl->remove_property(h, name);
   }
 
@@ -3164,6 +3191,7 @@ namespace yave {
     const std::string& name,
     object_ptr<PropertyTreeNode> data)
   {
+    m_pimpl->touch();
     m_pimpl->set_shared_property(h, name, std::move(data));
   }
 
@@ -3171,6 +3199,7 @@ namespace yave {
     const node_handle& h,
     const std::string& name)
   {
+    m_pimpl->touch();
     m_pimpl->remove_shared_property(h, name);
   }
 
@@ -3186,11 +3215,13 @@ namespace yave {
 
   void structured_node_graph::set_source_id(const node_handle& h, uid id)
   {
+    m_pimpl->touch();
     m_pimpl->set_source_id(h, id);
   }
 
   void structured_node_graph::set_source_id(const socket_handle& h, uid id)
   {
+    m_pimpl->touch();
     m_pimpl->set_source_id(h, id);
   }
 
@@ -3352,6 +3383,7 @@ namespace yave {
     const std::string& socket,
     size_t index) -> socket_handle
   {
+    m_pimpl->touch();
     return m_pimpl->add_input_socket(group, socket, index);
   }
 
@@ -3360,21 +3392,25 @@ namespace yave {
     const std::string& socket,
     size_t index) -> socket_handle
   {
+    m_pimpl->touch();
     return m_pimpl->add_output_socket(group, socket, index);
   }
 
   void structured_node_graph::remove_socket(const socket_handle& socket)
   {
+    m_pimpl->touch();
     return m_pimpl->remove_socket(socket);
   }
 
   void structured_node_graph::bring_front(const node_handle& node)
   {
+    m_pimpl->touch();
     m_pimpl->bring_front(node);
   }
 
   void structured_node_graph::bring_back(const node_handle& node)
   {
+    m_pimpl->touch();
     m_pimpl->bring_back(node);
   }
 
@@ -3384,6 +3420,7 @@ namespace yave {
     const std::vector<std::string>& oss,
     const uid& id) -> node_handle
   {
+    m_pimpl->touch();
     return m_pimpl->create_function(path, iss, oss, id);
   }
 
@@ -3393,6 +3430,7 @@ namespace yave {
     const std::vector<std::string>& oss,
     const uid& id) -> node_handle
   {
+    m_pimpl->touch();
     return m_pimpl->create_macro(path, iss, oss, id);
   }
 
@@ -3402,6 +3440,7 @@ namespace yave {
     const std::vector<std::string>& oss,
     const uid& id) -> node_handle
   {
+    m_pimpl->touch();
     return m_pimpl->create_group(path, iss, oss, id);
   }
 
@@ -3410,6 +3449,7 @@ namespace yave {
     const std::vector<node_handle>& nodes,
     const uid& id) -> node_handle
   {
+    m_pimpl->touch();
     return m_pimpl->create_group(parent_group, nodes, id);
   }
 
@@ -3418,6 +3458,7 @@ namespace yave {
     const node_handle& src,
     const uid& id) -> node_handle
   {
+    m_pimpl->touch();
     return m_pimpl->create_copy(parent_group, src, id);
   }
 
@@ -3426,11 +3467,13 @@ namespace yave {
     const node_handle& src,
     const uid& id) -> node_handle
   {
+    m_pimpl->touch();
     return m_pimpl->create_clone(parent_group, src, id);
   }
 
   void structured_node_graph::destroy(const node_handle& node)
   {
+    m_pimpl->touch();
     m_pimpl->destroy(node);
   }
 
@@ -3439,14 +3482,21 @@ namespace yave {
     const socket_handle& dst_socket,
     const uid& id) -> connection_handle
   {
+    m_pimpl->touch();
     return m_pimpl->connect(src_socket, dst_socket, id);
   }
 
   void structured_node_graph::disconnect(const connection_handle& c)
   {
+    m_pimpl->touch();
     return m_pimpl->disconnect(c);
   }
 
+  auto structured_node_graph::version() const -> uint64_t
+  {
+    return m_pimpl->version();
+  }
+
   auto structured_node_graph::clone() const -> structured_node_graph
   {
     return m_pimpl->clone();
@@ -3454,6 +3504,7 @@ namespace yave {
 
   void structured_node_graph::clear()
   {
+    m_pimpl->touch();
     m_pimpl->clear();
   }
 
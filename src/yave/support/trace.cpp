@@ -0,0 +1,199 @@
+//
+// Copyright (c) 2019 mocabe (https://github.com/mocabe)
+// Distributed under LGPLv3 License. See LICENSE for more details.
+//
+
+#include <yave/support/trace.hpp>
+
+#include <fstream>
+#include <iomanip>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace yave {
+
+  namespace {
+
+    using clock = std::chrono::steady_clock;
+
+    /// Max number of events per thread. Events after this are discarded.
+    constexpr size_t max_thread_events = 1 << 20;
+
+    struct trace_event
+    {
+      const char* name;
+      const char* category;
+      clock::time_point begin;
+      clock::time_point end;
+    };
+
+    /// Events of single thread.
+    /// Only owner thread adds events, so lock is almost never contended.
+    struct thread_buffer
+    {
+      std::mutex mtx;
+      uint64_t tid = 0;
+      std::string name;
+      std::vector<trace_event> events;
+    };
+
+    struct trace_registry
+    {
+      std::mutex mtx;
+      uint64_t next_tid = 1;
+      clock::time_point start = clock::now();
+      /// buffers of all threads, including exited threads.
+      std::vector<std::shared_ptr<thread_buffer>> buffers;
+    };
+
+    auto registry() -> trace_registry&
+    {
+      // never destroyed, threads can record events on exit
+      static auto* r = new trace_registry();
+      return *r;
+    }
+
+    auto current_buffer() -> thread_buffer&
+    {
+      thread_local auto buf = [] {
+        auto& r   = registry();
+        auto lck  = std::unique_lock(r.mtx);
+        auto b    = std::make_shared<thread_buffer>();
+        b->tid    = r.next_tid++;
+        r.buffers.push_back(b);
+        return b;
+      }();
+      return *buf;
+    }
+
+    void write_json_string(std::ostream& os, const char* str)
+    {
+      os << '"';
+      for (auto p = str; *p; ++p) {
+        auto c = *p;
+        if (c == '"' || c == '\\')
+          os << '\\' << c;
+        else if (static_cast<unsigned char>(c) < 0x20)
+          os << "\\u" << std::hex << std::setw(4) << std::setfill('0')
+             << static_cast<int>(c) << std::dec << std::setfill(' ');
+        else
+          os << c;
+      }
+      os << '"';
+    }
+  } // namespace
+
+  namespace detail {
+
+    void record_trace(
+      const char* name,
+      const char* category,
+      clock::time_point begin,
+      clock::time_point end) noexcept
+    {
+      auto& buf = current_buffer();
+      auto lck  = std::unique_lock(buf.mtx);
+
+      if (buf.events.size() >= max_thread_events)
+        return;
+
+      try {
+        buf.events.push_back({name, category, begin, end});
+      } catch (...) {
+        // drop event
+      }
+    }
+  } // namespace detail
+
+  void start_trace()
+  {
+    auto& r  = registry();
+    auto lck = std::unique_lock(r.mtx);
+
+    for (auto&& b : r.buffers) {
+      auto block = std::unique_lock(b->mtx);
+      b->events.clear();
+    }
+
+    r.start = clock::now();
+    detail::trace_enabled.store(true, std::memory_order_relaxed);
+  }
+
+  void stop_trace()
+  {
+    detail::trace_enabled.store(false, std::memory_order_relaxed);
+  }
+
+  void set_trace_thread_name(const char* name)
+  {
+    auto& buf = current_buffer();
+    auto lck  = std::unique_lock(buf.mtx);
+    buf.name  = name;
+  }
+
+  void write_trace(std::ostream& os)
+  {
+    auto& r  = registry();
+    auto lck = std::unique_lock(r.mtx);
+
+    // microseconds from start of trace
+    auto ts = [&](clock::time_point t) {
+      return std::chrono::duration<double, std::micro>(t - r.start).count();
+    };
+
+    os << std::fixed << std::setprecision(3);
+    os << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[";
+
+    auto first = true;
+    auto sep   = [&] {
+      if (!first)
+        os << ",";
+      first = false;
+      os << "\n";
+    };
+
+    for (auto&& b : r.buffers) {
+
+      auto block = std::unique_lock(b->mtx);
+
+      if (!b->name.empty()) {
+        sep();
+        os << R"({"name":"thread_name","ph":"M","pid":1,"tid":)" << b->tid
+           << R"(,"args":{"name":)";
+        write_json_string(os, b->name.c_str());
+        os << "}}";
+      }
+
+      for (auto&& e : b->events) {
+        // events which started before start_trace()
+        if (e.begin < r.start)
+          continue;
+
+        sep();
+        os << R"({"name":)";
+        write_json_string(os, e.name);
+        os << R"(,"cat":)";
+        write_json_string(os, e.category);
+        os << R"(,"ph":"X","pid":1,"tid":)" << b->tid << R"(,"ts":)"
+           << ts(e.begin) << R"(,"dur":)"
+           << std::chrono::duration<double, std::micro>(e.end - e.begin).count()
+           << "}";
+      }
+    }
+    os << "\n]}\n";
+  }
+
+  bool write_trace(const std::filesystem::path& path)
+  {
+    auto ofs = std::ofstream(path);
+
+    if (!ofs)
+      return false;
+
+    write_trace(ofs);
+    return static_cast<bool>(ofs);
+  }
+
+} // namespace yave
@@ -0,0 +1,93 @@
+//
+// Copyright (c) 2019 mocabe (https://github.com/mocabe)
+// Distributed under LGPLv3 License. See LICENSE for more details.
+//
+
+#include <yave/editor/frame_cache.hpp>
+#include <catch2/catch.hpp>
+
+using namespace yave;
+using namespace yave::editor;
+
+TEST_CASE("frame_cache")
+{
+  auto frame = [] {
+    return std::make_shared<const image>(4, 4, image_format::rgba8);
+  };
+
+  auto size = frame()->byte_size();
+  REQUIRE(size == 64);
+
+  frame_cache cache(size * 3);
+
+  SECTION("get/set")
+  {
+    REQUIRE(!cache.get(1, time::seconds(0)));
+
+    auto f = frame();
+    cache.set(1, time::seconds(0), f);
+    REQUIRE(cache.version() == 1);
+    REQUIRE(cache.size() == 1);
+    REQUIRE(cache.usage() == size);
+    REQUIRE(cache.contains(1, time::seconds(0)));
+    REQUIRE(cache.get(1, time::seconds(0)) == f);
+
+    // keyed by both version and time
+    REQUIRE(!cache.get(2, time::seconds(0)));
+    REQUIRE(!cache.get(1, time::seconds(1)));
+
+    // replace
+    auto g = frame();
+    cache.set(1, time::seconds(0), g);
+    REQUIRE(cache.size() == 1);
+    REQUIRE(cache.usage() == size);
+    REQUIRE(cache.get(1, time::seconds(0)) == g);
+
+    cache.clear();
+    REQUIRE(cache.size() == 0);
+    REQUIRE(cache.usage() == 0);
+  }
+
+  SECTION("version")
+  {
+    cache.set(1, time::seconds(0), frame());
+    cache.set(1, time::seconds(1), frame());
+
+    // frames of old version are discarded
+    cache.set(2, time::seconds(2), frame());
+    REQUIRE(cache.version() == 2);
+    REQUIRE(cache.size() == 1);
+    REQUIRE(!cache.contains(1, time::seconds(0)));
+    REQUIRE(!cache.contains(2, time::seconds(0)));
+    REQUIRE(cache.contains(2, time::seconds(2)));
+  }
+
+  SECTION("lru")
+  {
+    for (auto i = 0; i < 3; ++i)
+      cache.set(0, time::seconds(i), frame());
+
+    // touch first frame
+    REQUIRE(cache.get(0, time::seconds(0)));
+
+    cache.set(0, time::seconds(3), frame());
+
+    REQUIRE(cache.size() == 3);
+    REQUIRE(cache.usage() == 3 * size);
+    REQUIRE(cache.contains(0, time::seconds(0)));
+    REQUIRE(!cache.contains(0, time::seconds(1)));
+    REQUIRE(cache.contains(0, time::seconds(2)));
+    REQUIRE(cache.contains(0, time::seconds(3)));
+
+    // shrink
+    cache.set_budget(size);
+    REQUIRE(cache.size() == 1);
+    REQUIRE(cache.contains(0, time::seconds(3)));
+
+    // larger than budget
+    cache.set_budget(size - 1);
+    REQUIRE(cache.size() == 0);
+    cache.set(0, time::seconds(4), frame());
+    REQUIRE(cache.size() == 0);
+  }
+}
@@ -0,0 +1,227 @@
+//
+// Copyright (c) 2019 mocabe (https://github.com/mocabe)
+// Distributed under LGPLv3 License. See LICENSE for more details.
+//
+
+#include <yave/editor/frame_pipeline.hpp>
+#include <yave/compiler/compile.hpp>
+#include <yave/obj/primitive/primitive.hpp>
+#include <yave/signal/function.hpp>
+#include <yave/rts/list.hpp>
+#include <yave/rts/cancel_token.hpp>
+#include <catch2/catch.hpp>
+
+#include <atomic>
+#include <thread>
+
+using namespace yave;
+using namespace yave::editor;
+
+namespace {
+
+  constexpr int list_size = 200;
+
+  /// lazy list [n, list_size)
+  struct From : Function<From, Int, List<Int>>
+  {
+    static constexpr auto _attributes = closure_attributes::pure;
+
+    return_type code() const
+    {
+      auto n = eval_arg<0>();
+      if (*n == list_size)
+        return make_list<Int>();
+      return make_object<List<Int>>(
+        n, make_object<From>() << make_object<Int>(*n + 1));
+    }
+  };
+
+  struct Lift : Function<Lift, List<Int>, FrameDemand, List<Int>>
+  {
+    static constexpr auto _attributes = pure_signal_function;
+
+    return_type code() const
+    {
+      return eval_arg<0>();
+    }
+  };
+
+  /// forces list in every frame
+  struct Sum : SignalFunction<Sum, List<Int>, Int>
+  {
+    return_type code() const
+    {
+      auto sum = 0;
+      for (auto l = eval_arg<0>(); !l->is_nil(); l = eval(l->tail()))
+        sum += *eval(l->head());
+      return make_object<Int>(sum);
+    }
+  };
+} // namespace
+
+TEST_CASE("frame_pipeline")
+{
+  auto exe = compiler::executable(make_object<Int>(), object_type<Int>());
+
+  std::atomic<int> running = 0;
+  std::atomic<int> peak    = 0;
+  std::atomic<int> calls   = 0;
+
+  // frame of t has width of t in seconds.
+  // earlier frames take longer to render.
+  auto render = [&](compiler::executable&&, yave::time t) {
+    auto n = ++running;
+    auto p = peak.load();
+    while (n > p && !peak.compare_exchange_weak(p, n))
+      ;
+    ++calls;
+    auto w = static_cast<uint32_t>(t.seconds().count());
+    std::this_thread::sleep_for(std::chrono::milliseconds(40 - 5 * w));
+    --running;
+    return std::make_shared<const image>(w, 1, image_format::rgba8);
+  };
+
+  frame_pipeline pipeline(4, 4, render);
+
+  REQUIRE(pipeline.workers() == 4);
+  REQUIRE(pipeline.capacity() == 4);
+
+  SECTION("no executable")
+  {
+    REQUIRE(!pipeline.push(time::seconds(1)));
+    REQUIRE(!pipeline.pop());
+  }
+
+  SECTION("in order")
+  {
+    pipeline.reset(exe, 1);
+    REQUIRE(pipeline.version() == 1);
+
+    for (auto i = 1; i <= 4; ++i)
+      REQUIRE(pipeline.push(time::seconds(i)));
+
+    // back pressure
+    REQUIRE(pipeline.full());
+    REQUIRE(!pipeline.push(time::seconds(5)));
+    REQUIRE(pipeline.contains(time::seconds(2)));
+
+    for (auto i = 1; i <= 4; ++i) {
+      auto f = pipeline.pop();
+      REQUIRE(f);
+      REQUIRE(f->time == time::seconds(i));
+      REQUIRE(f->version == 1);
+      REQUIRE(f->image->width() == static_cast<uint32_t>(i));
+    }
+
+    REQUIRE(!pipeline.pop());
+    REQUIRE(!pipeline.try_pop());
+    REQUIRE(peak > 1);
+  }
+
+  SECTION("duplicate")
+  {
+    pipeline.reset(exe, 1);
+    REQUIRE(pipeline.push(time::seconds(1)));
+    REQUIRE(!pipeline.push(time::seconds(1)));
+    REQUIRE(pipeline.size() == 1);
+  }
+
+  SECTION("cancel")
+  {
+    pipeline.reset(exe, 1);
+
+    for (auto i = 1; i <= 4; ++i)
+      REQUIRE(pipeline.push(time::seconds(i)));
+
+    pipeline.cancel_if([](auto t) { return t < time::seconds(3); });
+    REQUIRE(pipeline.size() == 2);
+    REQUIRE(pipeline.pop()->time == time::seconds(3));
+
+    // new executable
+    pipeline.reset(exe, 2);
+    REQUIRE(pipeline.size() == 0);
+    REQUIRE(pipeline.push(time::seconds(1)));
+    auto f = pipeline.pop();
+    REQUIRE(f->time == time::seconds(1));
+    REQUIRE(f->version == 2);
+
+    pipeline.cancel();
+    pipeline.wait();
+    REQUIRE(!pipeline.busy());
+    REQUIRE(calls <= 5);
+  }
+}
+
+TEST_CASE("frame_pipeline worker count")
+{
+  REQUIRE(frame_pipeline::worker_count(4, 100) == 4);
+  REQUIRE(frame_pipeline::worker_count(0, 100) == 0);
+
+  // limited by frames which fit in preview cache
+  REQUIRE(frame_pipeline::worker_count(4, 3) == 2);
+  REQUIRE(frame_pipeline::worker_count(4, 1) == 0);
+  REQUIRE(frame_pipeline::worker_count(4, 0) == 0);
+}
+
+TEST_CASE("frame_pipeline cancel running")
+{
+  auto exe = compiler::executable(make_object<Int>(), object_type<Int>());
+
+  std::atomic<int> started = 0;
+
+  // never finishes unless cancelled
+  auto render = [&](compiler::executable&&, yave::time) {
+    ++started;
+    while (true) {
+      detail::check_cancel();
+      std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    return std::shared_ptr<const image>();
+  };
+
+  frame_pipeline pipeline(2, 2, render);
+
+  pipeline.reset(exe, 1);
+  REQUIRE(pipeline.push(time::seconds(1)));
+  REQUIRE(pipeline.push(time::seconds(2)));
+
+  while (started != 2)
+    std::this_thread::yield();
+
+  REQUIRE(pipeline.busy());
+  pipeline.cancel();
+  pipeline.wait();
+  REQUIRE(!pipeline.busy());
+  REQUIRE(pipeline.size() == 0);
+}
+
+TEST_CASE("frame_pipeline memoized list")
+{
+  // frames force thunks of the same memoized list concurrently
+  auto render = [&](compiler::executable&& exe, yave::time t) {
+    auto w = static_cast<uint32_t>(*value_cast<Int>(exe.execute(t)));
+    return std::make_shared<const image>(w, 1, image_format::rgba8);
+  };
+
+  frame_pipeline pipeline(4, 8, render);
+
+  for (auto v = 1; v <= 50; ++v) {
+
+    auto from = make_object<From>() << make_object<Int>(0);
+    auto obj  = make_object<Sum>() << (make_object<Lift>() << from);
+
+    auto pipe = compiler::init_pipeline();
+    pipe.add_data("exe", compiler::executable(obj, object_type<signal<Int>>()));
+    compiler::optimize(pipe);
+
+    pipeline.reset(pipe.get_data<compiler::executable>("exe"), v);
+
+    for (auto i = 0; i < 8; ++i)
+      REQUIRE(pipeline.push(time::seconds(i)));
+
+    while (auto f = pipeline.pop()) {
+      REQUIRE(f->image);
+      REQUIRE(f->image->width() == list_size * (list_size - 1) / 2);
+    }
+  }
+}
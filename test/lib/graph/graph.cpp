@@ -238,4 +238,60 @@ TEST_CASE("Graph id", "[lib][graph]")
   REQUIRE(g.socket(g.id(s)) == s);
   REQUIRE(g.socket(g.id(d)) == d);
   REQUIRE(g.edge(g.id(e)) == e);
-}
\ No newline at end of file
+}
+TEST_CASE("Graph container", "[lib][graph]")
+{
+  graph<int, int, int> g;
+
+  std::vector<graph<int, int, int>::node_descriptor_type> ns;
+
+  // allocate multiple blocks
+  for (int i = 0; i < 1000; ++i)
+    ns.push_back(g.add_node(i));
+
+  SECTION("stable descriptor")
+  {
+    REQUIRE(g.n_nodes() == 1000);
+    for (int i = 0; i < 1000; ++i) {
+      REQUIRE(g.exists(ns[i]));
+      REQUIRE(g[ns[i]] == i);
+      REQUIRE(g.node(g.id(ns[i])) == ns[i]);
+    }
+  }
+
+  SECTION("remove")
+  {
+    for (int i = 0; i < 1000; i += 2)
+      g.remove_node(ns[i]);
+
+    REQUIRE(g.n_nodes() == 500);
+    REQUIRE(g.nodes().size() == 500);
+
+    for (int i = 0; i < 1000; ++i) {
+      REQUIRE(g.exists(ns[i]) == (i % 2 == 1));
+      if (i % 2 == 1)
+        REQUIRE(g[ns[i]] == i);
+    }
+
+    for (auto&& n : g.nodes())
+      REQUIRE(g[n] % 2 == 1);
+
+    // reuse slots
+    for (int i = 0; i < 500; ++i)
+      (void)g.add_node(i);
+
+    REQUIRE(g.n_nodes() == 1000);
+  }
+
+  SECTION("move")
+  {
+    auto g2 = std::move(g);
+    REQUIRE(g2.n_nodes() == 1000);
+    REQUIRE(g.n_nodes() == 0);
+    for (int i = 0; i < 1000; ++i)
+      REQUIRE(g2[ns[i]] == i);
+
+    g2 = g.clone();
+    REQUIRE(g2.empty());
+  }
+}
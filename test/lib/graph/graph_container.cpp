@@ -0,0 +1,135 @@
+//
+// Copyright (c) 2019 mocabe (https://github.com/mocabe)
+// Distributed under LGPLv3 License. See LICENSE for more details.
+//
+
+#define CATCH_CONFIG_ENABLE_BENCHMARKING
+#include <catch2/catch.hpp>
+
+#include <yave/lib/graph/graph.hpp>
+
+#include <map>
+
+using namespace yave::graph;
+
+namespace {
+
+  /// Previous std::map based container for comparison.
+  template <template <class> class ValueType, class Graph>
+  struct map_container
+  {
+    using value_type      = ValueType<Graph>;
+    using descriptor_type = const value_type*;
+    using id_type         = typename Graph::id_type;
+
+    bool exists(const descriptor_type& descriptor) const noexcept
+    {
+      return dsc_map.find(descriptor) != dsc_map.end();
+    }
+
+    auto find_descriptor(const id_type& id) const noexcept -> descriptor_type
+    {
+      auto iter = id_map.find(id);
+      return iter != id_map.end() ? &iter->second : nullptr;
+    }
+
+    void destroy(const descriptor_type& descriptor, const id_type& id) noexcept
+    {
+      id_map.erase(id);
+      dsc_map.erase(descriptor);
+    }
+
+    template <class... Args>
+    auto create(const id_type& id, Args&&... args) -> descriptor_type
+    {
+      auto [iter, succ] =
+        id_map.emplace(id, value_type(id, std::forward<Args>(args)...));
+
+      if (!succ)
+        return nullptr;
+
+      dsc_map.emplace(&iter->second, id);
+      return &iter->second;
+    }
+
+    auto descriptors() const
+    {
+      std::vector<descriptor_type> ret;
+      ret.reserve(dsc_map.size());
+      for (auto&& pair : dsc_map)
+        ret.push_back(pair.first);
+      return ret;
+    }
+
+    std::map<descriptor_type, id_type> dsc_map;
+    std::map<id_type, value_type> id_map;
+  };
+
+  using graph_type = graph<int, int, int>;
+
+  template <class Container>
+  void run_benchmark(size_t n)
+  {
+    auto gen = graph_id_generator();
+
+    std::vector<typename graph_type::id_type> ids;
+    for (size_t i = 0; i < n; ++i)
+      ids.push_back(gen.generate());
+
+    Container c;
+
+    std::vector<typename Container::descriptor_type> dscs;
+    for (auto&& id : ids)
+      dscs.push_back(c.create(id, 0));
+
+    BENCHMARK("create/destroy")
+    {
+      Container tmp;
+      for (auto&& id : ids)
+        (void)tmp.create(id, 0);
+      for (auto&& d : tmp.descriptors())
+        tmp.destroy(d, d->id());
+      return tmp.descriptors().size();
+    };
+
+    BENCHMARK("exists")
+    {
+      size_t cnt = 0;
+      for (auto&& d : dscs)
+        cnt += c.exists(d);
+      return cnt;
+    };
+
+    BENCHMARK("find_descriptor")
+    {
+      size_t cnt = 0;
+      for (auto&& id : ids)
+        cnt += c.find_descriptor(id) != nullptr;
+      return cnt;
+    };
+
+    BENCHMARK("iterate")
+    {
+      int sum = 0;
+      for (auto&& d : c.descriptors())
+        sum += d->property();
+      return sum;
+    };
+  }
+} // namespace
+
+TEST_CASE("graph_container benchmark", "[.][benchmark][lib][graph]")
+{
+  for (size_t n : {10000, 100000}) {
+
+    DYNAMIC_SECTION("slot container " << n)
+    {
+      run_benchmark<graph_container<node, graph_type>>(n);
+    }
+
+    DYNAMIC_SECTION("map container " << n)
+    {
+      run_benchmark<map_container<node, graph_type>>(n);
+    }
+  }
+}
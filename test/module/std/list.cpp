@@ -0,0 +1,247 @@
+//
+// Copyright (c) 2019 mocabe (https://github.com/mocabe)
+// Distributed under LGPLv3 License. See LICENSE for more details.
+//
+
+#define CATCH_CONFIG_ENABLE_BENCHMARKING
+#include <yave/module/std/list/algorithm.hpp>
+#include <yave/node/core/node_definition.hpp>
+#include <yave/signal/function.hpp>
+#include <yave/signal/list.hpp>
+#include <yave/obj/primitive/primitive.hpp>
+#include <catch2/catch.hpp>
+
+#include <functional>
+
+using namespace yave;
+
+namespace {
+
+  struct Lift : Function<Lift, Int, FrameDemand, Int>
+  {
+    return_type code() const
+    {
+      return eval_arg<0>();
+    }
+  };
+
+  // [0, n)
+  struct Range : SignalFunction<Range, Int, SList<Int>>
+  {
+    return_type code() const
+    {
+      auto n   = *eval_arg<0>();
+      auto ret = make_object<SList<Int>>();
+      for (auto i = n; i-- > 0;)
+        ret = make_object<SList<Int>>(
+          make_object<Lift>() << make_object<Int>(i), ret);
+      return ret;
+    }
+  };
+
+  // opaque list function to block fusion
+  struct Barrier : SignalFunction<Barrier, SList<Int>, SList<Int>>
+  {
+    return_type code() const
+    {
+      return eval_arg<0>();
+    }
+  };
+
+  struct Twice : SignalFunction<Twice, Int, Int>
+  {
+    return_type code() const
+    {
+      return make_object<Int>(*eval_arg<0>() * 2);
+    }
+  };
+
+  struct Add : SignalFunction<Add, Int, Int, Int>
+  {
+    return_type code() const
+    {
+      return make_object<Int>(*eval_arg<0>() + *eval_arg<1>());
+    }
+  };
+
+  // idx * 1000 + x
+  struct Index : SignalFunction<Index, Int, Int, Int>
+  {
+    return_type code() const
+    {
+      return make_object<Int>(*eval_arg<0>() * 1000 + *eval_arg<1>());
+    }
+  };
+
+  template <class Node>
+  auto instance() -> object_ptr<const Object>
+  {
+    return get_node_definitions<Node, modules::_std::tag>()[0].instance();
+  }
+
+  auto lit(int i) -> object_ptr<const Object>
+  {
+    return make_object<Lift>() << make_object<Int>(i);
+  }
+
+  auto demand()
+  {
+    return make_object<FrameDemand>(make_object<FrameTime>());
+  }
+
+  auto to_vector(const object_ptr<const Object>& sig)
+  {
+    auto d   = demand();
+    auto ret = std::vector<int64_t>();
+    auto l   = static_object_cast<const SList<Int>>(eval(sig << d));
+    while (!l->is_nil()) {
+      ret.push_back(*value_cast<Int>(eval(l->head() << d)));
+      l = static_object_cast<const SList<Int>>(eval(l->tail()));
+    }
+    return ret;
+  }
+
+  auto to_int(const object_ptr<const Object>& sig)
+  {
+    return *value_cast<Int>(eval(sig << demand()));
+  }
+} // namespace
+
+TEST_CASE("List.Algo fusion")
+{
+  auto map     = instance<node::List::Algo::Map>();
+  auto repeat  = instance<node::List::Algo::Repeat>();
+  auto enumer  = instance<node::List::Algo::Enumerate>();
+  auto fold    = instance<node::List::Algo::Fold>();
+  auto range   = make_object<Range>();
+  auto barrier = make_object<Barrier>();
+  auto twice   = make_object<Twice>();
+  auto add     = make_object<Add>();
+  auto index   = make_object<Index>();
+
+  using fn = std::function<object_ptr<const Object>(object_ptr<const Object>)>;
+
+  auto m = [&](auto l) -> object_ptr<const Object> { return map << l << twice; };
+  auto e = [&](auto l) -> object_ptr<const Object> {
+    return enumer << l << index;
+  };
+  auto b = [&](auto l) -> object_ptr<const Object> { return barrier << l; };
+
+  // compare fused pipeline with pipeline which materializes each stage
+  auto check = [&](object_ptr<const Object> src, std::vector<fn> stages) {
+    auto fused = src;
+    auto ref   = src;
+    for (auto&& s : stages) {
+      fused = s(fused);
+      ref   = b(s(ref));
+    }
+    REQUIRE(to_vector(fused) == to_vector(ref));
+    REQUIRE(
+      to_int(fold << fused << add << lit(0))
+      == to_int(fold << ref << add << lit(0)));
+  };
+
+  auto src = range << lit(5);
+  auto rep = repeat << lit(3) << lit(4);
+
+  SECTION("map")
+  {
+    check(src, {m});
+    check(src, {m, m});
+    check(src, {m, m, m});
+    check(rep, {m, m});
+  }
+
+  SECTION("enumerate")
+  {
+    check(src, {e});
+    check(src, {e, e});
+    check(src, {m, e});
+    check(src, {e, m});
+    check(src, {e, m, e});
+    check(src, {m, e, e, m});
+    check(rep, {e});
+    check(rep, {m, e});
+    check(rep, {e, m, e});
+  }
+
+  SECTION("order")
+  {
+    // each stage reverses order of list
+    REQUIRE(to_vector(m(src)) == std::vector<int64_t> {8, 6, 4, 2, 0});
+    REQUIRE(to_vector(m(m(src))) == std::vector<int64_t> {0, 4, 8, 12, 16});
+    REQUIRE(
+      to_vector(e(src)) == std::vector<int64_t> {4004, 3003, 2002, 1001, 0});
+  }
+
+  SECTION("fold")
+  {
+    REQUIRE(to_int(fold << m(m(rep)) << add << lit(1)) == 49);
+    REQUIRE(to_int(fold << (repeat << lit(1) << lit(0)) << add << lit(1)) == 1);
+    REQUIRE(to_int(fold << (repeat << lit(1) << lit(-1)) << add << lit(1)) == 1);
+  }
+
+  SECTION("allocations")
+  {
+    auto count = [](auto&& sig) {
+      auto n = detail::object_allocations;
+      (void)to_int(sig);
+      return detail::object_allocations - n;
+    };
+
+    auto l     = repeat << lit(1) << lit(100);
+    auto fused = fold << m(m(l)) << add << lit(0);
+    auto ref   = fold << b(m(b(m(l)))) << add << lit(0);
+
+    // cons cells of intermediate lists are not built
+    REQUIRE(count(fused) + 2 * 100 <= count(ref));
+  }
+
+  SECTION("long")
+  {
+    // strict fold does not nest evaluation
+    auto n = 1000000;
+    REQUIRE(to_int(fold << m(repeat << lit(1) << lit(n)) << add << lit(0)) == 2 * n);
+  }
+}
+
+TEST_CASE("List.Algo fusion benchmark", "[.][benchmark]")
+{
+  auto map     = instance<node::List::Algo::Map>();
+  auto repeat  = instance<node::List::Algo::Repeat>();
+  auto fold    = instance<node::List::Algo::Fold>();
+  auto barrier = make_object<Barrier>();
+  auto twice   = make_object<Twice>();
+  auto add     = make_object<Add>();
+
+  // Repeat -> Map -> Map -> Fold
+  auto pipeline = [&](int n, bool fused) {
+    object_ptr<const Object> l = repeat << lit(1) << lit(n);
+    for (auto i = 0; i < 2; ++i) {
+      l = map << l << twice;
+      if (!fused)
+        l = barrier << l;
+    }
+    return fold << l << add << lit(0);
+  };
+
+  auto fused10k = pipeline(10000, true);
+  auto ref10k   = pipeline(10000, false);
+  auto fused1m  = pipeline(1000000, true);
+
+  BENCHMARK("fused 10k")
+  {
+    return to_int(fused10k);
+  };
+
+  BENCHMARK("materialized 10k")
+  {
+    return to_int(ref10k);
+  };
+
+  // materialized list of 1M elements overflows stack on destruction
+  BENCHMARK("fused 1M")
+  {
+    return to_int(fused1m);
+  };
+}
@@ -5,6 +5,7 @@
 
 #include <yave/compiler/compile.hpp>
 #include <yave/compiler/message.hpp>
+#include <yave/compiler/executable.hpp>
 #include <yave/support/log.hpp>
 #include <yave/signal/function.hpp>
 #include <yave/module/std/num/num.hpp>
@@ -13,6 +14,8 @@
 #include <yave/module/std/logic/if.hpp>
 #include <catch2/catch.hpp>
 
+#include <set>
+
 using namespace yave;
 
 // backend tag
@@ -159,6 +162,13 @@ TEST_CASE("node_compiler V2")
       .and_then([](auto& p) { compiler::parse(p); })
       .and_then([](auto& p) { compiler::sema(p); });
 
+    if (pipe.success()) {
+      auto& exe = pipe.get_data<compiler::executable>("exe");
+      auto ir   = pipe.get_data_if<compiler::typed_ir>("typed_ir");
+      REQUIRE(ir);
+      REQUIRE(ir->check(exe.type()));
+    }
+
     return pipe.success();
   };
 
@@ -411,6 +421,177 @@ TEST_CASE("node_compiler V2")
     REQUIRE(test_compile());
   }
 
+  SECTION("snapshot")
+  {
+    auto i = ng.create_copy(root, int_func);
+    REQUIRE(ng.connect(ng.output_sockets(i)[0], os));
+
+    auto snapshot = std::make_shared<const structured_node_graph>(ng.clone());
+    auto version  = snapshot->version();
+
+    for (int n = 0; n < 2; ++n) {
+      auto pipe = compiler::init_pipeline();
+
+      pipe
+        .and_then([&](auto& p) {
+          compiler::input(
+            p,
+            snapshot,
+            snapshot->socket(out.id()),
+            decls.get_map(),
+            defs.get_map());
+        })
+        .and_then([](auto& p) { compiler::parse(p); })
+        .and_then([](auto& p) { compiler::sema(p); });
+
+      REQUIRE(pipe.success());
+    }
+
+    // not modified
+    REQUIRE(snapshot->version() == version);
+  }
+
+  SECTION("incremental")
+  {
+    auto cache = std::make_shared<compiler::sema_cache>();
+
+    auto compile = [&]() -> object_ptr<const Object> {
+      auto _ng = ng.clone();
+      auto _os = _ng.socket(out.id());
+
+      auto pipe = compiler::init_pipeline();
+
+      pipe
+        .and_then([&](auto& p) {
+          compiler::input(
+            p, std::move(_ng), _os, decls.get_map(), defs.get_map());
+          p.add_data("sema_cache", cache);
+        })
+        .and_then([](auto& p) { compiler::parse(p); })
+        .and_then([](auto& p) { compiler::sema(p); });
+
+      if (!pipe.success())
+        return nullptr;
+
+      auto& exe = pipe.get_data<compiler::executable>("exe");
+      auto ir   = pipe.get_data_if<compiler::typed_ir>("typed_ir");
+      REQUIRE(ir);
+      REQUIRE(ir->check(exe.type()));
+
+      return exe.object();
+    };
+
+    auto add1 = ng.create_copy(root, add_func);
+    auto add2 = ng.create_copy(root, add_func);
+    auto i    = ng.create_copy(root, int_func);
+    auto j    = ng.create_copy(root, int_func);
+    auto d    = ng.create_copy(root, float_func);
+
+    REQUIRE(ng.connect(ng.output_sockets(add1)[0], os));
+    REQUIRE(ng.connect(ng.output_sockets(add2)[0], ng.input_sockets(add1)[0]));
+    REQUIRE(ng.connect(ng.output_sockets(i)[0], ng.input_sockets(add1)[1]));
+    REQUIRE(ng.connect(ng.output_sockets(i)[0], ng.input_sockets(add2)[0]));
+    REQUIRE(ng.connect(ng.output_sockets(i)[0], ng.input_sockets(add2)[1]));
+
+    auto reconnect = [&](auto&& src, auto&& dst) {
+      for (auto&& c : ng.connections(dst))
+        ng.disconnect(c);
+      return ng.connect(src, dst);
+    };
+
+    // add1 = add2 + i
+    auto get_lhs = [](const object_ptr<const Object>& obj) {
+      auto app = value_cast<const Apply>(obj);
+      auto lhs = value_cast<const Apply>(_get_storage(*app).app());
+      return _get_storage(*lhs).arg();
+    };
+
+    auto app1 = compile();
+    REQUIRE(app1);
+    REQUIRE(cache->size() != 0);
+
+    // unchanged
+    auto app2 = compile();
+    REQUIRE(app2 == app1);
+
+    // change input of add1
+    REQUIRE(reconnect(ng.output_sockets(j)[0], ng.input_sockets(add1)[1]));
+    auto app3 = compile();
+    REQUIRE(app3);
+    REQUIRE(app3 != app1);
+    REQUIRE(get_lhs(app3) == get_lhs(app1));
+    REQUIRE(same_type(type_of(app3), type_of(app1)));
+
+    // reused subtree is still type checked
+    REQUIRE(reconnect(ng.output_sockets(d)[0], ng.input_sockets(add1)[1]));
+    REQUIRE(!compile());
+
+    // failure does not invalidate cache
+    REQUIRE(reconnect(ng.output_sockets(j)[0], ng.input_sockets(add1)[1]));
+    REQUIRE(compile() == app3);
+  }
+
+  SECTION("diamond chain")
+  {
+    // n_{k+1} = n_k + n_k
+    constexpr size_t depth = 32;
+
+    auto i = ng.create_copy(root, int_func);
+    REQUIRE(i);
+
+    auto prev = ng.output_sockets(i)[0];
+    for (size_t k = 0; k < depth; ++k) {
+      auto add = ng.create_copy(root, add_func);
+      REQUIRE(add);
+      REQUIRE(ng.connect(prev, ng.input_sockets(add)[0]));
+      REQUIRE(ng.connect(prev, ng.input_sockets(add)[1]));
+      prev = ng.output_sockets(add)[0];
+    }
+    REQUIRE(ng.connect(prev, os));
+
+    auto _ng = ng.clone();
+    auto _os = _ng.socket(out.id());
+
+    auto pipe = compiler::init_pipeline();
+
+    pipe
+      .and_then([&](auto& p) {
+        compiler::input(
+          p, std::move(_ng), _os, decls.get_map(), defs.get_map());
+      })
+      .and_then([](auto& p) { compiler::parse(p); })
+      .and_then([](auto& p) { compiler::sema(p); });
+
+    REQUIRE(pipe.success());
+
+    auto& exe = pipe.get_data<compiler::executable>("exe");
+    auto ir   = pipe.get_data_if<compiler::typed_ir>("typed_ir");
+    REQUIRE(ir);
+    REQUIRE(ir->check(exe.type()));
+
+    // count unique apply nodes
+    auto visited = std::set<const Object*>();
+    auto stack   = std::vector<object_ptr<const Object>> {exe.object()};
+    auto n_apply = size_t(0);
+
+    while (!stack.empty()) {
+      auto obj = stack.back();
+      stack.pop_back();
+
+      if (!visited.insert(obj.get()).second)
+        continue;
+
+      if (auto app = value_cast_if<Apply>(obj)) {
+        stack.push_back(_get_storage(*app).app());
+        stack.push_back(_get_storage(*app).arg());
+        ++n_apply;
+      }
+    }
+
+    // each add node is single shared `(+) x y`
+    REQUIRE(n_apply <= 2 * depth + 2);
+  }
+
   SECTION("f = [x y -> x + y]")
   {
     auto f = ng.create_group(root, {});
@@ -0,0 +1,319 @@
+//
+// Copyright (c) 2019 mocabe (https://github.com/mocabe)
+// Distributed under LGPLv3 License. See LICENSE for more details.
+//
+
+#define CATCH_CONFIG_ENABLE_BENCHMARKING
+#include <yave/compiler/compile.hpp>
+#include <yave/compiler/message.hpp>
+#include <yave/compiler/executable.hpp>
+#include <yave/signal/function.hpp>
+#include <yave/obj/primitive/primitive.hpp>
+#include <yave/rts/bytecode.hpp>
+#include <yave/module/std/num/num.hpp>
+#include <yave/module/std/math/ops.hpp>
+#include <yave/module/std/math/trigonometric.hpp>
+#include <yave/module/std/time/time.hpp>
+#include <catch2/catch.hpp>
+
+using namespace yave;
+
+namespace {
+
+  int twice_count = 0;
+  int hold_count  = 0;
+
+  struct Lift : Function<Lift, Int, FrameDemand, Int>
+  {
+    static constexpr auto _attributes = pure_signal_function;
+
+    return_type code() const
+    {
+      return eval_arg<0>();
+    }
+  };
+
+  struct Twice : SignalFunction<Twice, Int, Int>
+  {
+    static constexpr auto _attributes = pure_signal_function;
+
+    return_type code() const
+    {
+      ++twice_count;
+      return make_object<Int>(*eval_arg<0>() * 2);
+    }
+  };
+
+  struct Add : SignalFunction<Add, Int, Int, Int>
+  {
+    static constexpr auto _attributes = pure_signal_function;
+
+    return_type code() const
+    {
+      return make_object<Int>(*eval_arg<0>() + *eval_arg<1>());
+    }
+  };
+
+  struct Seconds : SignalFunction<Seconds, Int>
+  {
+    static constexpr auto _attributes = closure_attributes::pure;
+
+    return_type code() const
+    {
+      return make_object<Int>(static_cast<int>(arg_time()->seconds().count()));
+    }
+  };
+
+  struct Hold : SignalFunction<Hold, Int, Int>
+  {
+    return_type code() const
+    {
+      ++hold_count;
+      return eval_arg<0>();
+    }
+  };
+
+  struct Fail : SignalFunction<Fail, Int, Int>
+  {
+    static constexpr auto _attributes = pure_signal_function;
+
+    return_type code() const
+    {
+      throw std::runtime_error("fail");
+    }
+  };
+
+  auto lower_exe(object_ptr<const Object> obj)
+  {
+    auto pipe = compiler::init_pipeline();
+    pipe.add_data("exe", compiler::executable(obj, object_type<signal<Int>>()));
+    compiler::lower(pipe);
+    return std::move(pipe.get_data<compiler::executable>("exe"));
+  }
+
+  auto run(const compiler::executable& exe, int sec)
+  {
+    return *value_cast<Int>(exe.clone().execute(time::seconds(sec)));
+  }
+} // namespace
+
+TEST_CASE("lower")
+{
+  twice_count = 0;
+  hold_count  = 0;
+
+  auto lift = make_object<Lift>() << make_object<Int>(21);
+
+  SECTION("instructions")
+  {
+    auto obj = make_object<Add>()
+               << (make_object<Twice>() << lift)
+               << (make_object<Twice>() << make_object<Seconds>());
+
+    auto exe = lower_exe(obj);
+
+    REQUIRE(exe.program());
+    REQUIRE(exe.program()->size() == 4);
+    REQUIRE(get_register(exe.object()));
+
+    for (auto t = 0; t < 3; ++t)
+      REQUIRE(run(exe, t) == 42 + 2 * t);
+  }
+
+  SECTION("registers")
+  {
+    // shared subterm is evaluated once per frame
+    auto s   = make_object<Twice>() << make_object<Seconds>();
+    auto obj = make_object<Add>() << s << s;
+
+    auto ref = compiler::executable(obj, object_type<signal<Int>>());
+    REQUIRE(run(ref, 1) == 4);
+    REQUIRE(twice_count == 2);
+
+    twice_count = 0;
+
+    auto exe = lower_exe(obj);
+    REQUIRE(exe.program()->size() == 2);
+    REQUIRE(run(exe, 1) == 4);
+    REQUIRE(run(exe, 2) == 8);
+    REQUIRE(twice_count == 2);
+  }
+
+  SECTION("impure")
+  {
+    auto h   = make_object<Hold>() << lift;
+    auto obj = make_object<Add>() << h << h;
+    auto exe = lower_exe(obj);
+
+    REQUIRE(run(exe, 0) == 42);
+    REQUIRE(hold_count == 2);
+  }
+
+  SECTION("fallback")
+  {
+    // lambda body is instantiated by graph reduction
+    auto x   = make_object<Variable>();
+    auto s   = make_object<Twice>() << make_object<Seconds>();
+    auto lam = make_object<Lambda>(x, make_object<Add>() << x << s);
+    auto exe = lower_exe(lam << lift);
+
+    REQUIRE(exe.program()->size() == 2);
+    REQUIRE(!get_register(exe.object()));
+
+    for (auto t = 0; t < 3; ++t)
+      REQUIRE(run(exe, t) == 21 + 2 * t);
+  }
+
+  SECTION("exception")
+  {
+    auto obj = make_object<Add>() << lift << (make_object<Fail>() << lift);
+    auto exe = lower_exe(obj);
+
+    REQUIRE(exe.program()->size() == 3);
+    REQUIRE_THROWS(run(exe, 0));
+    // instruction is still usable
+    REQUIRE_THROWS(run(exe, 1));
+  }
+
+  SECTION("nothing")
+  {
+    auto exe = lower_exe(make_object<Seconds>());
+    REQUIRE(!exe.program());
+    REQUIRE(run(exe, 3) == 3);
+  }
+}
+
+TEST_CASE("lower benchmark", "[.][benchmark]")
+{
+  structured_node_graph ng;
+  node_declaration_store decls;
+  node_definition_store defs;
+
+  auto time_decl  = get_node_declaration<node::Time::Time>();
+  auto secs_decl  = get_node_declaration<node::Time::Seconds>();
+  auto sin_decl   = get_node_declaration<node::Math::Sin>();
+  auto add_decl   = get_node_declaration<node::Ops::Add>();
+  auto float_decl = get_node_declaration<node::Num::Float>();
+
+  decls.add(time_decl);
+  decls.add(secs_decl);
+  decls.add(sin_decl);
+  decls.add(add_decl);
+  decls.add(float_decl);
+
+  using std_tag  = modules::_std::tag;
+  using math_tag = modules::_std::math::tag;
+
+  REQUIRE(defs.add(get_node_definitions<node::Time::Time, std_tag>()));
+  REQUIRE(defs.add(get_node_definitions<node::Time::Seconds, std_tag>()));
+  REQUIRE(defs.add(get_node_definitions<node::Math::Sin, std_tag>()));
+  REQUIRE(defs.add(get_node_definitions<node::Ops::Add, math_tag>()));
+  REQUIRE(defs.add(get_node_definitions<node::Num::Float, std_tag>()));
+
+  auto func = [&](auto& decl) {
+    return create_declaration(ng, std::make_shared<node_declaration>(decl));
+  };
+
+  auto time_func = func(time_decl);
+  auto secs_func = func(secs_decl);
+  auto sin_func  = func(sin_decl);
+  auto add_func  = func(add_decl);
+
+  auto root = ng.create_group({nullptr}, {});
+  auto out  = ng.add_output_socket(root, "out");
+  auto os   = ng.input_sockets(ng.get_group_output(root))[0];
+
+  auto node = [&](auto f, std::vector<socket_handle> inputs) {
+    auto n = ng.create_copy(root, f);
+    for (size_t i = 0; i < inputs.size(); ++i)
+      REQUIRE(ng.connect(inputs[i], ng.input_sockets(n)[i]));
+    return ng.output_sockets(n)[0];
+  };
+
+  auto secs = node(secs_func, {node(time_func, {})});
+
+  auto compile = [&](bool lower) {
+    auto pipe = compiler::init_pipeline();
+
+    pipe
+      .and_then([&](auto& p) {
+        auto _ng = ng.clone();
+        auto _os = _ng.socket(out.id());
+        compiler::input(
+          p, std::move(_ng), _os, decls.get_map(), defs.get_map());
+      })
+      .and_then([](auto& p) { compiler::parse(p); })
+      .and_then([](auto& p) { compiler::sema(p); })
+      .and_then([](auto& p) { compiler::optimize(p); })
+      .and_then([&](auto& p) {
+        if (lower)
+          compiler::lower(p);
+      });
+
+    REQUIRE(pipe.success());
+    return std::move(pipe.get_data<compiler::executable>("exe"));
+  };
+
+  // render frames like execute thread
+  auto run = [](auto& meter, const compiler::executable& exe) {
+    auto frame = 0;
+    meter.measure([&] {
+      auto t = time::seconds(1) / 60 * frame++;
+      return exe.clone().execute(t);
+    });
+  };
+
+  auto bench = [&](const char* name) {
+    auto graph   = compile(false);
+    auto lowered = compile(true);
+
+    REQUIRE(lowered.program());
+
+    // same results on both paths
+    auto t = time::seconds(1);
+    REQUIRE(
+      *value_cast<Float>(graph.clone().execute(t))
+      == *value_cast<Float>(lowered.clone().execute(t)));
+
+    BENCHMARK_ADVANCED(std::string(name) + " graph reduction")
+    (Catch::Benchmark::Chronometer meter)
+    {
+      run(meter, graph);
+    };
+
+    BENCHMARK_ADVANCED(std::string(name) + " bytecode")
+    (Catch::Benchmark::Chronometer meter)
+    {
+      run(meter, lowered);
+    };
+  };
+
+  SECTION("wave chain")
+  {
+    // x_{k+1} = sin(x_k) + x_k
+    auto x = secs;
+    for (auto k = 0; k < 64; ++k)
+      x = node(add_func, {node(sin_func, {x}), x});
+
+    REQUIRE(ng.connect(x, os));
+    bench("wave chain");
+  }
+
+  SECTION("wave tree")
+  {
+    // sum of 256 independent waves
+    auto xs = std::vector<socket_handle>();
+    for (auto k = 0; k < 256; ++k)
+      xs.push_back(node(sin_func, {node(add_func, {secs, secs})}));
+
+    while (xs.size() > 1) {
+      auto ys = std::vector<socket_handle>();
+      for (size_t i = 0; i < xs.size(); i += 2)
+        ys.push_back(node(add_func, {xs[i], xs[i + 1]}));
+      xs = std::move(ys);
+    }
+
+    REQUIRE(ng.connect(xs[0], os));
+    bench("wave tree");
+  }
+}
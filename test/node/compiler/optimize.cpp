@@ -0,0 +1,277 @@
+//
+// Copyright (c) 2019 mocabe (https://github.com/mocabe)
+// Distributed under LGPLv3 License. See LICENSE for more details.
+//
+
+#include <yave/compiler/compile.hpp>
+#include <yave/compiler/executable.hpp>
+#include <yave/compiler/memo_table.hpp>
+#include <yave/signal/function.hpp>
+#include <yave/obj/primitive/primitive.hpp>
+#include <catch2/catch.hpp>
+
+using namespace yave;
+
+namespace {
+
+  int twice_count = 0;
+  int time_count  = 0;
+  int mul_count   = 0;
+
+  struct Lift : Function<Lift, Int, FrameDemand, Int>
+  {
+    static constexpr auto _attributes = pure_signal_function;
+
+    return_type code() const
+    {
+      return eval_arg<0>();
+    }
+  };
+
+  struct Twice : SignalFunction<Twice, Int, Int>
+  {
+    static constexpr auto _attributes = pure_signal_function;
+
+    return_type code() const
+    {
+      ++twice_count;
+      return make_object<Int>(*eval_arg<0>() * 2);
+    }
+  };
+
+  struct Add : SignalFunction<Add, Int, Int, Int>
+  {
+    static constexpr auto _attributes = pure_signal_function;
+
+    return_type code() const
+    {
+      return make_object<Int>(*eval_arg<0>() + *eval_arg<1>());
+    }
+  };
+
+  struct Seconds : SignalFunction<Seconds, Int>
+  {
+    static constexpr auto _attributes = closure_attributes::pure;
+
+    return_type code() const
+    {
+      ++time_count;
+      return make_object<Int>(static_cast<int>(arg_time()->seconds().count()));
+    }
+  };
+
+  struct Mul : Function<Mul, Int, Int, Int>
+  {
+    static constexpr auto _attributes = closure_attributes::pure;
+
+    return_type code() const
+    {
+      ++mul_count;
+      return make_object<Int>(*eval_arg<0>() * *eval_arg<1>());
+    }
+  };
+
+  struct Fail : Function<Fail, Int, Int>
+  {
+    static constexpr auto _attributes = closure_attributes::pure;
+
+    return_type code() const
+    {
+      throw std::runtime_error("fail");
+    }
+  };
+
+  struct Hold : Function<Hold, Int, FrameDemand, Int>
+  {
+    return_type code() const
+    {
+      return eval_arg<0>();
+    }
+  };
+
+  auto optimize_exe(object_ptr<const Object> obj)
+  {
+    auto pipe = compiler::init_pipeline();
+    pipe.add_data(
+      "exe", compiler::executable(obj, object_type<signal<Int>>()));
+    pipe.add_data("opt_dump", true);
+    compiler::optimize(pipe);
+    return std::move(pipe.get_data<compiler::executable>("exe"));
+  }
+
+  auto run(const compiler::executable& exe, int sec)
+  {
+    return *value_cast<Int>(exe.clone().execute(time::seconds(sec)));
+  }
+} // namespace
+
+TEST_CASE("optimize memo")
+{
+  twice_count = 0;
+  time_count  = 0;
+
+  SECTION("invariant")
+  {
+    auto lift = make_object<Lift>() << make_object<Int>(21);
+    auto exe  = optimize_exe(make_object<Twice>() << lift);
+
+    REQUIRE(run(exe, 0) == 42);
+    REQUIRE(run(exe, 1) == 42);
+    REQUIRE(run(exe, 2) == 42);
+    REQUIRE(twice_count == 1);
+
+    auto tmp = exe.clone();
+    tmp.clear_cache();
+
+    REQUIRE(run(exe, 3) == 42);
+    REQUIRE(twice_count == 2);
+  }
+
+  SECTION("variant")
+  {
+    auto lift = make_object<Lift>() << make_object<Int>(21);
+    auto exe  = optimize_exe(
+      make_object<Add>()
+      << (make_object<Twice>() << (make_object<Twice>() << lift))
+      << (make_object<Twice>() << make_object<Seconds>()));
+
+    REQUIRE(run(exe, 0) == 84);
+    REQUIRE(run(exe, 1) == 86);
+    REQUIRE(run(exe, 2) == 88);
+    REQUIRE(twice_count == 2 + 3);
+    REQUIRE(time_count == 3);
+  }
+}
+
+TEST_CASE("optimize cse")
+{
+  twice_count = 0;
+  time_count  = 0;
+
+  // definitions share closure instances
+  auto twice = make_object<Twice>();
+  auto secs  = make_object<Seconds>();
+
+  auto s1  = twice << secs;
+  auto s2  = twice << secs;
+  auto exe = optimize_exe(make_object<Add>() << s1 << s2);
+
+  REQUIRE(run(exe, 1) == 4);
+  REQUIRE(twice_count == 1);
+  REQUIRE(time_count == 1);
+
+  // shared results are discarded after each frame
+  REQUIRE(exe.memo()->shared_size() == 0);
+
+  REQUIRE(run(exe, 2) == 8);
+  REQUIRE(twice_count == 2);
+  REQUIRE(time_count == 2);
+}
+
+TEST_CASE("optimize constant folding")
+{
+  mul_count = 0;
+
+  auto mul = make_object<Mul>() << make_object<Int>(6) << make_object<Int>(7);
+  auto exe = optimize_exe(make_object<Hold>() << mul);
+
+  REQUIRE(mul_count == 1);
+  REQUIRE(run(exe, 0) == 42);
+  REQUIRE(run(exe, 1) == 42);
+  REQUIRE(mul_count == 1);
+
+  // errors are reported at runtime
+  auto fail = make_object<Fail>() << make_object<Int>(42);
+  auto err  = optimize_exe(make_object<Hold>() << fail);
+  REQUIRE_THROWS(run(err, 0));
+}
+
+TEST_CASE("optimize constant folding in pipeline")
+{
+  mul_count  = 0;
+  time_count = 0;
+
+  structured_node_graph ng;
+  node_declaration_store decls;
+  node_definition_store defs;
+
+  auto answer_decl = function_node_declaration(
+    "test.Answer", "", node_declaration_visibility::_public, {}, {"out"});
+  auto secs_decl = function_node_declaration(
+    "test.Seconds", "", node_declaration_visibility::_public, {}, {"out"});
+  auto add_decl = function_node_declaration(
+    "test.Add", "", node_declaration_visibility::_public, {"x", "y"}, {"out"});
+
+  decls.add(answer_decl);
+  decls.add(secs_decl);
+  decls.add(add_decl);
+
+  // closed non-signal subterm in signal graph
+  auto answer =
+    make_object<Lift>()
+    << (make_object<Mul>() << make_object<Int>(6) << make_object<Int>(7));
+
+  REQUIRE(defs.add({node_definition("test.Answer", 0, answer)}));
+  REQUIRE(defs.add(
+    {node_definition("test.Seconds", 0, make_object<Seconds>())}));
+  REQUIRE(defs.add({node_definition("test.Add", 0, make_object<Add>())}));
+
+  auto func = [&](auto& decl) {
+    return create_declaration(ng, std::make_shared<node_declaration>(decl));
+  };
+
+  auto root = ng.create_group({nullptr}, {});
+  auto out  = ng.add_output_socket(root, "out");
+  auto os   = ng.input_sockets(ng.get_group_output(root))[0];
+
+  auto a = ng.create_copy(root, func(answer_decl));
+  auto s = ng.create_copy(root, func(secs_decl));
+  auto n = ng.create_copy(root, func(add_decl));
+
+  REQUIRE(ng.connect(ng.output_sockets(a)[0], ng.input_sockets(n)[0]));
+  REQUIRE(ng.connect(ng.output_sockets(s)[0], ng.input_sockets(n)[1]));
+  REQUIRE(ng.connect(ng.output_sockets(n)[0], os));
+
+  auto pipe = compiler::init_pipeline();
+  pipe.add_data("opt_dump", true);
+
+  pipe
+    .and_then([&](auto& p) {
+      auto _ng = ng.clone();
+      auto _os = _ng.socket(out.id());
+      compiler::input(
+        p, std::move(_ng), _os, decls.get_map(), defs.get_map());
+    })
+    .and_then([](auto& p) { compiler::parse(p); })
+    .and_then([](auto& p) { compiler::sema(p); })
+    .and_then([](auto& p) { compiler::optimize(p); });
+
+  REQUIRE(pipe.success());
+
+  auto exe = std::move(pipe.get_data<compiler::executable>("exe"));
+
+  // folded at compile time, signals are left untouched
+  REQUIRE(mul_count == 1);
+  REQUIRE(time_count == 0);
+
+  REQUIRE(run(exe, 0) == 42);
+  REQUIRE(run(exe, 1) == 43);
+  REQUIRE(mul_count == 1);
+  REQUIRE(time_count == 2);
+}
+
+TEST_CASE("optimize dead args")
+{
+  twice_count = 0;
+  time_count  = 0;
+
+  auto lift = make_object<Lift>() << make_object<Int>(21);
+  auto var  = make_object<Variable>();
+  auto lam  = make_object<Lambda>(var, make_object<Twice>() << lift);
+  auto exe  = optimize_exe(lam << make_object<Seconds>());
+
+  REQUIRE(run(exe, 0) == 42);
+  REQUIRE(run(exe, 1) == 42);
+  REQUIRE(twice_count == 1);
+  REQUIRE(time_count == 0);
+}
@@ -0,0 +1,159 @@
+//
+// Copyright (c) 2019 mocabe (https://github.com/mocabe)
+// Distributed under LGPLv3 License. See LICENSE for more details.
+//
+
+#include <yave/compiler/compile.hpp>
+#include <yave/compiler/message.hpp>
+#include <yave/compiler/executable.hpp>
+#include <yave/compiler/profiler.hpp>
+#include <yave/module/std/num/num.hpp>
+#include <yave/module/std/math/ops.hpp>
+#include <yave/module/std/math/trigonometric.hpp>
+#include <yave/module/std/time/time.hpp>
+#include <catch2/catch.hpp>
+
+using namespace yave;
+
+TEST_CASE("node_profiler")
+{
+  structured_node_graph ng;
+  node_declaration_store decls;
+  node_definition_store defs;
+
+  auto time_decl  = get_node_declaration<node::Time::Time>();
+  auto secs_decl  = get_node_declaration<node::Time::Seconds>();
+  auto sin_decl   = get_node_declaration<node::Math::Sin>();
+  auto add_decl   = get_node_declaration<node::Ops::Add>();
+  auto float_decl = get_node_declaration<node::Num::Float>();
+
+  decls.add(time_decl);
+  decls.add(secs_decl);
+  decls.add(sin_decl);
+  decls.add(add_decl);
+  decls.add(float_decl);
+
+  using std_tag  = modules::_std::tag;
+  using math_tag = modules::_std::math::tag;
+
+  REQUIRE(defs.add(get_node_definitions<node::Time::Time, std_tag>()));
+  REQUIRE(defs.add(get_node_definitions<node::Time::Seconds, std_tag>()));
+  REQUIRE(defs.add(get_node_definitions<node::Math::Sin, std_tag>()));
+  REQUIRE(defs.add(get_node_definitions<node::Ops::Add, math_tag>()));
+  REQUIRE(defs.add(get_node_definitions<node::Num::Float, std_tag>()));
+
+  auto func = [&](auto& decl) {
+    return create_declaration(ng, std::make_shared<node_declaration>(decl));
+  };
+
+  auto root = ng.create_group({nullptr}, {});
+  auto out  = ng.add_output_socket(root, "out");
+  auto os   = ng.input_sockets(ng.get_group_output(root))[0];
+
+  // sin(t) + sin(t)
+  auto t   = ng.create_copy(root, func(time_decl));
+  auto sec = ng.create_copy(root, func(secs_decl));
+  auto sin = ng.create_copy(root, func(sin_decl));
+  auto add = ng.create_copy(root, func(add_decl));
+
+  REQUIRE(ng.connect(ng.output_sockets(t)[0], ng.input_sockets(sec)[0]));
+  REQUIRE(ng.connect(ng.output_sockets(sec)[0], ng.input_sockets(sin)[0]));
+  REQUIRE(ng.connect(ng.output_sockets(sin)[0], ng.input_sockets(add)[0]));
+  REQUIRE(ng.connect(ng.output_sockets(sin)[0], ng.input_sockets(add)[1]));
+  REQUIRE(ng.connect(ng.output_sockets(add)[0], os));
+
+  auto compile = [&](std::shared_ptr<compiler::node_profiler> profiler) {
+    auto pipe = compiler::init_pipeline();
+
+    if (profiler)
+      pipe.add_data("profiler", profiler);
+
+    pipe
+      .and_then([&](auto& p) {
+        auto _ng = ng.clone();
+        auto _os = _ng.socket(out.id());
+        compiler::input(
+          p, std::move(_ng), _os, decls.get_map(), defs.get_map());
+      })
+      .and_then([](auto& p) { compiler::parse(p); })
+      .and_then([](auto& p) { compiler::sema(p); })
+      .and_then([](auto& p) { compiler::optimize(p); })
+      .and_then([](auto& p) { compiler::lower(p); });
+
+    REQUIRE(pipe.success());
+    return std::move(pipe.get_data<compiler::executable>("exe"));
+  };
+
+  auto run = [](const compiler::executable& exe, double sec) {
+    auto r = exe.clone().execute(time::seconds(sec));
+    return *value_cast<Float>(r);
+  };
+
+  auto find = [](const auto& costs, const node_handle& n) {
+    auto it = std::find_if(costs.begin(), costs.end(), [&](auto& c) {
+      return c.node == n.id();
+    });
+    REQUIRE(it != costs.end());
+    return *it;
+  };
+
+  auto profiler = std::make_shared<compiler::node_profiler>();
+  auto exe      = compile(profiler);
+  auto ref      = compile(nullptr);
+
+  // one entry for each function node
+  REQUIRE(profiler->size() == 4);
+
+  SECTION("results")
+  {
+    for (auto sec : {0.0, 0.5, 1.0})
+      REQUIRE(run(exe, sec) == run(ref, sec));
+  }
+
+  SECTION("costs")
+  {
+    REQUIRE(run(exe, 1.0) == Approx(2 * std::sin(1.0)));
+
+    auto costs = profiler->take();
+    REQUIRE(costs.size() == 4);
+
+    // shared output is evaluated once per frame
+    REQUIRE(find(costs, sin).calls == 1);
+    REQUIRE(find(costs, add).calls == 1);
+    REQUIRE(find(costs, add).allocations >= 1);
+
+    // reset by take()
+    for (auto&& c : profiler->results()) {
+      REQUIRE(c.calls == 0);
+      REQUIRE(c.time.count() == 0);
+      REQUIRE(c.allocations == 0);
+    }
+
+    for (auto i = 0; i < 3; ++i)
+      (void)run(exe, i);
+
+    REQUIRE(find(profiler->results(), sin).calls == 3);
+  }
+
+  SECTION("exclusive")
+  {
+    (void)run(exe, 1.0);
+
+    auto costs = profiler->results();
+
+    // costs of nested nodes are not counted twice
+    auto total = std::chrono::nanoseconds();
+    for (auto&& c : costs)
+      total += c.time;
+
+    auto bgn = std::chrono::steady_clock::now();
+    (void)run(exe, 2.0);
+    auto end = std::chrono::steady_clock::now();
+
+    auto frame = std::chrono::nanoseconds();
+    for (auto&& c : profiler->results())
+      frame += c.time;
+
+    REQUIRE(frame - total <= end - bgn);
+  }
+}
@@ -0,0 +1,227 @@
+//
+// Copyright (c) 2019 mocabe (https://github.com/mocabe)
+// Distributed under LGPLv3 License. See LICENSE for more details.
+//
+
+#include <yave/compiler/compile.hpp>
+#include <yave/compiler/message.hpp>
+#include <yave/compiler/executable.hpp>
+#include <yave/compiler/profiler.hpp>
+#include <yave/compiler/signal_cache.hpp>
+#include <yave/module/std/num/num.hpp>
+#include <yave/module/std/math/ops.hpp>
+#include <yave/module/std/math/trigonometric.hpp>
+#include <yave/module/std/time/time.hpp>
+#include <catch2/catch.hpp>
+
+using namespace yave;
+
+TEST_CASE("signal_cache")
+{
+  compiler::signal_cache cache(1024);
+
+  auto cost = compiler::signal_cache::cost_of(make_object<Int>());
+  REQUIRE(cost > 0);
+
+  SECTION("get/set")
+  {
+    REQUIRE(!cache.get(1, time::seconds(0)));
+    REQUIRE(cache.misses() == 1);
+
+    cache.set(1, time::seconds(0), make_object<Int>(42));
+    REQUIRE(cache.size() == 1);
+    REQUIRE(cache.usage() == cost);
+
+    auto r = cache.get(1, time::seconds(0));
+    REQUIRE(r);
+    REQUIRE(*value_cast<Int>(r) == 42);
+    REQUIRE(cache.hits() == 1);
+
+    // keyed by both hash and time
+    REQUIRE(!cache.get(2, time::seconds(0)));
+    REQUIRE(!cache.get(1, time::seconds(1)));
+
+    // replace
+    cache.set(1, time::seconds(0), make_object<Int>(24));
+    REQUIRE(cache.size() == 1);
+    REQUIRE(*value_cast<Int>(cache.get(1, time::seconds(0))) == 24);
+
+    cache.clear();
+    REQUIRE(cache.size() == 0);
+    REQUIRE(cache.usage() == 0);
+    REQUIRE(!cache.get(1, time::seconds(0)));
+  }
+
+  SECTION("lru")
+  {
+    cache.set_budget(cost * 3);
+
+    for (auto i = 0; i < 3; ++i)
+      cache.set(0, time::seconds(i), make_object<Int>(i));
+
+    // touch first frame
+    REQUIRE(cache.get(0, time::seconds(0)));
+
+    cache.set(0, time::seconds(3), make_object<Int>(3));
+
+    REQUIRE(cache.size() == 3);
+    REQUIRE(cache.usage() <= cache.budget());
+    REQUIRE(cache.get(0, time::seconds(0)));
+    REQUIRE(!cache.get(0, time::seconds(1)));
+    REQUIRE(cache.get(0, time::seconds(2)));
+    REQUIRE(cache.get(0, time::seconds(3)));
+
+    // shrink
+    cache.set_budget(cost);
+    REQUIRE(cache.size() == 1);
+    REQUIRE(cache.get(0, time::seconds(3)));
+
+    // larger than budget
+    cache.set_budget(0);
+    cache.set(0, time::seconds(4), make_object<Int>(4));
+    REQUIRE(cache.size() == 0);
+  }
+}
+
+TEST_CASE("signal_cache compile")
+{
+  structured_node_graph ng;
+  node_declaration_store decls;
+  node_definition_store defs;
+
+  auto time_decl  = get_node_declaration<node::Time::Time>();
+  auto secs_decl  = get_node_declaration<node::Time::Seconds>();
+  auto sin_decl   = get_node_declaration<node::Math::Sin>();
+  auto add_decl   = get_node_declaration<node::Ops::Add>();
+  auto float_decl = get_node_declaration<node::Num::Float>();
+
+  decls.add(time_decl);
+  decls.add(secs_decl);
+  decls.add(sin_decl);
+  decls.add(add_decl);
+  decls.add(float_decl);
+
+  using std_tag  = modules::_std::tag;
+  using math_tag = modules::_std::math::tag;
+
+  REQUIRE(defs.add(get_node_definitions<node::Time::Time, std_tag>()));
+  REQUIRE(defs.add(get_node_definitions<node::Time::Seconds, std_tag>()));
+  REQUIRE(defs.add(get_node_definitions<node::Math::Sin, std_tag>()));
+  REQUIRE(defs.add(get_node_definitions<node::Ops::Add, math_tag>()));
+  REQUIRE(defs.add(get_node_definitions<node::Num::Float, std_tag>()));
+
+  auto func = [&](auto& decl) {
+    return create_declaration(ng, std::make_shared<node_declaration>(decl));
+  };
+
+  auto root = ng.create_group({nullptr}, {});
+  auto out  = ng.add_output_socket(root, "out");
+  auto os   = ng.input_sockets(ng.get_group_output(root))[0];
+
+  // sin(t) + sin(t)
+  auto t   = ng.create_copy(root, func(time_decl));
+  auto sec = ng.create_copy(root, func(secs_decl));
+  auto sin = ng.create_copy(root, func(sin_decl));
+  auto add = ng.create_copy(root, func(add_decl));
+
+  REQUIRE(ng.connect(ng.output_sockets(t)[0], ng.input_sockets(sec)[0]));
+  REQUIRE(ng.connect(ng.output_sockets(sec)[0], ng.input_sockets(sin)[0]));
+  REQUIRE(ng.connect(ng.output_sockets(sin)[0], ng.input_sockets(add)[0]));
+  REQUIRE(ng.connect(ng.output_sockets(sin)[0], ng.input_sockets(add)[1]));
+  REQUIRE(ng.connect(ng.output_sockets(add)[0], os));
+
+  auto compile = [&](
+                   std::shared_ptr<compiler::node_profiler> profiler,
+                   std::shared_ptr<compiler::signal_cache> cache) {
+    auto pipe = compiler::init_pipeline();
+
+    pipe.add_data("profiler", profiler);
+
+    if (cache)
+      pipe.add_data("signal_cache", cache);
+
+    pipe
+      .and_then([&](auto& p) {
+        auto _ng = ng.clone();
+        auto _os = _ng.socket(out.id());
+        compiler::input(
+          p, std::move(_ng), _os, decls.get_map(), defs.get_map());
+      })
+      .and_then([](auto& p) { compiler::parse(p); })
+      .and_then([](auto& p) { compiler::sema(p); })
+      .and_then([](auto& p) { compiler::optimize(p); })
+      .and_then([](auto& p) { compiler::lower(p); });
+
+    REQUIRE(pipe.success());
+    return std::move(pipe.get_data<compiler::executable>("exe"));
+  };
+
+  auto run = [](const compiler::executable& exe, double sec) {
+    auto r = exe.clone().execute(time::seconds(sec));
+    return *value_cast<Float>(r);
+  };
+
+  auto calls = [&](const auto& profiler) {
+    auto costs = profiler->results();
+    auto it    = std::find_if(costs.begin(), costs.end(), [&](auto& c) {
+      return c.node == sin.id();
+    });
+    REQUIRE(it != costs.end());
+    return it->calls;
+  };
+
+  auto profiler = std::make_shared<compiler::node_profiler>();
+  auto cache    = std::make_shared<compiler::signal_cache>();
+  auto exe      = compile(profiler, cache);
+
+  auto ref_profiler = std::make_shared<compiler::node_profiler>();
+  auto ref          = compile(ref_profiler, nullptr);
+
+  REQUIRE(exe.cache() == cache);
+  REQUIRE(!ref.cache());
+
+  SECTION("results")
+  {
+    for (auto sec : {0.0, 0.5, 1.0, 0.5, 0.0})
+      REQUIRE(run(exe, sec) == run(ref, sec));
+  }
+
+  SECTION("hits")
+  {
+    REQUIRE(run(exe, 1.0) == Approx(2 * std::sin(1.0)));
+    REQUIRE(calls(profiler) == 1);
+    REQUIRE(cache->size() > 0);
+
+    // same frame is not evaluated again, also in clones
+    REQUIRE(run(exe, 1.0) == Approx(2 * std::sin(1.0)));
+    REQUIRE(calls(profiler) == 1);
+    REQUIRE(cache->hits() > 0);
+
+    // new frame
+    REQUIRE(run(exe, 2.0) == Approx(2 * std::sin(2.0)));
+    REQUIRE(calls(profiler) == 2);
+
+    // discarded with memoized results
+    auto clone = exe.clone();
+    clone.clear_cache();
+    REQUIRE(cache->size() == 0);
+    REQUIRE(run(exe, 1.0) == Approx(2 * std::sin(1.0)));
+    REQUIRE(calls(profiler) == 3);
+
+    // without cache
+    for (auto i = 0; i < 3; ++i)
+      (void)run(ref, 1.0);
+    REQUIRE(calls(ref_profiler) == 3);
+  }
+
+  SECTION("budget")
+  {
+    cache->set_budget(0);
+
+    for (auto i = 0; i < 3; ++i)
+      REQUIRE(run(exe, 1.0) == Approx(2 * std::sin(1.0)));
+
+    REQUIRE(calls(profiler) == 3);
+    REQUIRE(cache->size() == 0);
+  }
+}
@@ -3,6 +3,7 @@
 // Distributed under LGPLv3 License. See LICENSE for more details.
 //
 
+#define CATCH_CONFIG_ENABLE_BENCHMARKING
 #include <catch2/catch.hpp>
 
 #include <yave/compiler/typecheck.hpp>
@@ -17,6 +18,9 @@ TEST_CASE("overloading")
   using Float  = Float32;
   using Double = Float64;
 
+  auto backend =
+    GENERATE(typecheck_backend::substitution, typecheck_backend::union_find);
+
   // empty loc map
   location_map loc;
 
@@ -40,7 +44,8 @@ TEST_CASE("overloading")
     SECTION("f 42")
     {
       auto app        = o << i;
-      auto [ty, app2] = type_of_overloaded(app, std::move(env), std::move(loc));
+      auto [ty, app2] =
+        type_of_overloaded(app, std::move(env), std::move(loc), backend);
 
       REQUIRE(same_type(ty, object_type<Int>()));
 
@@ -51,7 +56,8 @@ TEST_CASE("overloading")
     SECTION("f (f 42)")
     {
       auto app        = o << (o << i);
-      auto [ty, app2] = type_of_overloaded(app, std::move(env), std::move(loc));
+      auto [ty, app2] =
+        type_of_overloaded(app, std::move(env), std::move(loc), backend);
 
       REQUIRE(same_type(ty, object_type<Int>()));
 
@@ -62,7 +68,8 @@ TEST_CASE("overloading")
     SECTION("(id f) 42")
     {
       auto app        = (id << o) << i;
-      auto [ty, app2] = type_of_overloaded(app, std::move(env), std::move(loc));
+      auto [ty, app2] =
+        type_of_overloaded(app, std::move(env), std::move(loc), backend);
 
       REQUIRE(same_type(ty, object_type<Int>()));
 
@@ -79,7 +86,8 @@ TEST_CASE("overloading")
       _get_storage(*lam).body = o << var;
 
       auto app        = lam << i;
-      auto [ty, app2] = type_of_overloaded(app, std::move(env), std::move(loc));
+      auto [ty, app2] =
+        type_of_overloaded(app, std::move(env), std::move(loc), backend);
 
       REQUIRE(same_type(ty, object_type<Int>()));
 
@@ -120,13 +128,15 @@ TEST_CASE("overloading")
     {
       auto app = o << b;
       REQUIRE_THROWS_AS(
-        type_of_overloaded(app, std::move(env), std::move(loc)), message);
+        type_of_overloaded(app, std::move(env), std::move(loc), backend),
+        message);
     }
 
     SECTION("(id f) (f 42)")
     {
       auto app        = (id << o) << (o << i);
-      auto [ty, app2] = type_of_overloaded(app, std::move(env), std::move(loc));
+      auto [ty, app2] =
+        type_of_overloaded(app, std::move(env), std::move(loc), backend);
 
       REQUIRE(same_type(ty, object_type<Int>()));
 
@@ -137,7 +147,8 @@ TEST_CASE("overloading")
     SECTION("(id f) 42")
     {
       auto app        = (id << o) << i;
-      auto [ty, app2] = type_of_overloaded(app, std::move(env), std::move(loc));
+      auto [ty, app2] =
+        type_of_overloaded(app, std::move(env), std::move(loc), backend);
 
       REQUIRE(same_type(ty, object_type<Int>()));
 
@@ -154,7 +165,8 @@ TEST_CASE("overloading")
       _get_storage(*lam).body = (id << o) << var;
 
       auto app        = (id << lam) << i;
-      auto [ty, app2] = type_of_overloaded(app, std::move(env), std::move(loc));
+      auto [ty, app2] =
+        type_of_overloaded(app, std::move(env), std::move(loc), backend);
 
       REQUIRE(same_type(ty, object_type<Int>()));
 
@@ -218,7 +230,8 @@ TEST_CASE("overloading")
     SECTION("f Int")
     {
       auto app        = (id << ovl) << make_object<Int>();
-      auto [ty, app2] = type_of_overloaded(app, std::move(env), std::move(loc));
+      auto [ty, app2] =
+        type_of_overloaded(app, std::move(env), std::move(loc), backend);
 
       REQUIRE(same_type(ty, object_type<Int>()));
 
@@ -229,7 +242,8 @@ TEST_CASE("overloading")
     SECTION("f Float")
     {
       auto app        = (id << ovl) << make_object<Float>();
-      auto [ty, app2] = type_of_overloaded(app, std::move(env), std::move(loc));
+      auto [ty, app2] =
+        type_of_overloaded(app, std::move(env), std::move(loc), backend);
 
       REQUIRE(same_type(ty, object_type<Float>()));
 
@@ -240,7 +254,8 @@ TEST_CASE("overloading")
     SECTION("f List<Int>")
     {
       auto app        = (id << ovl) << make_object<List<Int>>();
-      auto [ty, app2] = type_of_overloaded(app, std::move(env), std::move(loc));
+      auto [ty, app2] =
+        type_of_overloaded(app, std::move(env), std::move(loc), backend);
 
       REQUIRE(same_type(ty, object_type<List<Int>>()));
 
@@ -251,7 +266,8 @@ TEST_CASE("overloading")
     SECTION("f List<Double>")
     {
       auto app        = (id << ovl) << make_object<List<Double>>();
-      auto [ty, app2] = type_of_overloaded(app, std::move(env), std::move(loc));
+      auto [ty, app2] =
+        type_of_overloaded(app, std::move(env), std::move(loc), backend);
 
       REQUIRE(same_type(ty, object_type<List<Double>>()));
 
@@ -268,7 +284,8 @@ TEST_CASE("overloading")
       _get_storage(*lam).body = ovl << var;
 
       auto app        = lam << make_object<Int>();
-      auto [ty, app2] = type_of_overloaded(app, std::move(env), std::move(loc));
+      auto [ty, app2] =
+        type_of_overloaded(app, std::move(env), std::move(loc), backend);
 
       REQUIRE(same_type(ty, object_type<Int>()));
 
@@ -285,7 +302,8 @@ TEST_CASE("overloading")
       _get_storage(*lam).body = id << ovl << var;
 
       auto app        = lam << make_object<List<Double>>();
-      auto [ty, app2] = type_of_overloaded(app, std::move(env), std::move(loc));
+      auto [ty, app2] =
+        type_of_overloaded(app, std::move(env), std::move(loc), backend);
 
       REQUIRE(same_type(ty, object_type<List<Double>>()));
 
@@ -322,7 +340,8 @@ TEST_CASE("overloading")
     SECTION("f Int")
     {
       auto app        = ovl << make_object<Int>();
-      auto [ty, app2] = type_of_overloaded(app, std::move(env), std::move(loc));
+      auto [ty, app2] =
+        type_of_overloaded(app, std::move(env), std::move(loc), backend);
 
       REQUIRE(same_type(ty, object_type<Int>()));
 
@@ -333,7 +352,8 @@ TEST_CASE("overloading")
     SECTION("f List<Int>")
     {
       auto app        = ovl << make_object<List<Int>>();
-      auto [ty, app2] = type_of_overloaded(app, std::move(env), std::move(loc));
+      auto [ty, app2] =
+        type_of_overloaded(app, std::move(env), std::move(loc), backend);
 
       REQUIRE(same_type(ty, object_type<List<Int>>()));
 
@@ -458,7 +478,8 @@ TEST_CASE("overloading")
 
       auto app = overloaded << (overloaded << h);
 
-      auto [ty, app2] = type_of_overloaded(app, std::move(env), std::move(loc));
+      auto [ty, app2] =
+        type_of_overloaded(app, std::move(env), std::move(loc), backend);
 
       REQUIRE(same_type(ty, object_type<closure<Int, Double>>()));
 
@@ -467,4 +488,223 @@ TEST_CASE("overloading")
       REQUIRE(same_type(ty, ty2));
     }
   }
-}
\ No newline at end of file
+}
+TEST_CASE("typed_ir")
+{
+  using Double = Float64;
+
+  struct F1 : Function<F1, Int, Int>
+  {
+    auto code() const -> return_type
+    {
+      throw;
+    }
+  };
+
+  struct F2 : Function<F2, Double, Double>
+  {
+    auto code() const -> return_type
+    {
+      throw;
+    }
+  };
+
+  struct G : Function<G, Int, Double, Int>
+  {
+    auto code() const -> return_type
+    {
+      throw;
+    }
+  };
+
+  auto f1 = make_object<F1>();
+  auto f2 = make_object<F2>();
+  auto i  = make_object<Int>(42);
+  auto d  = make_object<Double>(3.14);
+
+  SECTION("check")
+  {
+    auto app = make_object<Apply>(f1, i);
+
+    using node_type = typed_ir::node_type;
+    auto t          = node_type {
+      object_type<Int>(), object_type<closure<Int, Int>>(), object_type<Int>()};
+
+    REQUIRE(typed_ir(app, {{app.get(), t}}).check(object_type<Int>()));
+    REQUIRE(!typed_ir(app, {{app.get(), t}}).check(object_type<Double>()));
+    REQUIRE(!typed_ir(app, {}).check(object_type<Int>()));
+
+    auto app2 = make_object<Apply>(f2, i);
+    REQUIRE(!typed_ir(app2, {{app2.get(), t}}).check(object_type<Int>()));
+  }
+
+  SECTION("type_of_overloaded")
+  {
+    class_env env;
+    auto o = env.add_overloading(uid::random_generate(), {f1, f2});
+
+    // shared lambda used with different types
+    auto var                = make_object<Variable>();
+    auto lam                = make_object<Lambda>();
+    _get_storage(*lam).var  = var;
+    _get_storage(*lam).body = var;
+
+    auto app = make_object<Apply>(
+      make_object<Apply>(
+        make_object<G>(), make_object<Apply>(o, make_object<Apply>(lam, i))),
+      make_object<Apply>(lam, d));
+
+    SECTION("union_find")
+    {
+      auto ir         = typed_ir();
+      auto [ty, app2] = type_of_overloaded(
+        app, std::move(env), {}, typecheck_backend::union_find, &ir);
+
+      REQUIRE(same_type(ty, object_type<Int>()));
+      REQUIRE(ir.object() == app2);
+      // lambda is rebuilt for each use
+      REQUIRE(ir.size() == 7);
+      REQUIRE(ir.check(ty));
+      REQUIRE(!ir.check(object_type<Double>()));
+    }
+
+    SECTION("substitution")
+    {
+      auto ir      = typed_ir();
+      auto app2    = make_object<Apply>(o, i);
+      auto [ty, _] = type_of_overloaded(
+        app2, std::move(env), {}, typecheck_backend::substitution, &ir);
+
+      REQUIRE(same_type(ty, object_type<Int>()));
+      REQUIRE(!ir.object());
+    }
+  }
+}
+
+TEST_CASE("typecheck benchmark", "[.][benchmark]")
+{
+  using Double = Float64;
+
+  struct F1 : Function<F1, Int, Int>
+  {
+    auto code() const -> return_type
+    {
+      throw;
+    }
+  };
+
+  struct F2 : Function<F2, Double, Double>
+  {
+    auto code() const -> return_type
+    {
+      throw;
+    }
+  };
+
+  struct G1 : Function<G1, Int, Int, Int>
+  {
+    auto code() const -> return_type
+    {
+      throw;
+    }
+  };
+
+  struct G2 : Function<G2, Double, Double, Double>
+  {
+    auto code() const -> return_type
+    {
+      throw;
+    }
+  };
+
+  class_env env;
+
+  auto f_id = uid::random_generate();
+  auto g_id = uid::random_generate();
+
+  (void)env.add_overloading(f_id, {make_object<F1>(), make_object<F2>()});
+  (void)env.add_overloading(g_id, {make_object<G1>(), make_object<G2>()});
+
+  auto id = make_object<Identity>();
+
+  size_t n_leaves = 0;
+
+  // leaves: f 42, (lx.f x) 42, id (f 42)
+  auto leaf = [&]() -> object_ptr<const Object> {
+    auto i = make_object<Int>(42);
+    auto f = env.find_overloaded(f_id);
+
+    switch (n_leaves++ % 3) {
+      case 0:
+        return f << i;
+      case 1: {
+        auto var                = make_object<Variable>();
+        auto lam                = make_object<Lambda>();
+        _get_storage(*lam).var  = var;
+        _get_storage(*lam).body = f << var;
+        return lam << i;
+      }
+      default:
+        return id << (f << i);
+    }
+  };
+
+  // balanced tree of g, which has about n nodes
+  auto gen = [&](auto&& self, size_t n) -> object_ptr<const Object> {
+    if (n <= 6)
+      return leaf();
+    auto l = (n - 3) / 2;
+    auto g = env.find_overloaded(g_id);
+    return g << self(self, l) << self(self, n - 3 - l);
+  };
+
+  auto check = [&](auto& app, auto backend, typed_ir* ir = nullptr) {
+    auto classes    = env;
+    auto [ty, app2] =
+      type_of_overloaded(app, std::move(classes), {}, backend, ir);
+    return ty;
+  };
+
+  for (size_t n : {1000, 10000, 50000}) {
+
+    auto app = gen(gen, n);
+
+    REQUIRE(same_type(
+      check(app, typecheck_backend::union_find), object_type<Int>()));
+
+    BENCHMARK("union_find " + std::to_string(n))
+    {
+      return check(app, typecheck_backend::union_find);
+    };
+
+    auto ir         = typed_ir();
+    auto classes    = env;
+    auto [ty, app2] = type_of_overloaded(
+      app, std::move(classes), {}, typecheck_backend::union_find, &ir);
+
+    BENCHMARK("union_find with typed_ir " + std::to_string(n))
+    {
+      auto tmp = typed_ir();
+      return check(app, typecheck_backend::union_find, &tmp);
+    };
+
+    BENCHMARK("typed_ir check " + std::to_string(n))
+    {
+      return ir.check(ty);
+    };
+
+    // substitution backend is quadratic, takes minutes on largest graph
+    if (n > 10000)
+      continue;
+
+    BENCHMARK("substitution " + std::to_string(n))
+    {
+      return check(app, typecheck_backend::substitution);
+    };
+
+    BENCHMARK("type_of " + std::to_string(n))
+    {
+      return type_of(app2);
+    };
+  }
+}
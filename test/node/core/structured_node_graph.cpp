@@ -42,6 +42,35 @@ TEST_CASE("move")
   }
 }
 
+TEST_CASE("version")
+{
+  structured_node_graph ng;
+  auto v0 = ng.version();
+
+  auto g = ng.create_group({nullptr}, {});
+  REQUIRE(ng.version() != v0);
+
+  auto v1 = ng.version();
+  (void)ng.get_info(g);
+  (void)ng.output_sockets(g);
+  REQUIRE(ng.version() == v1);
+
+  // unique among graphs
+  auto ng2 = ng.clone();
+  REQUIRE(ng2.version() != ng.version());
+
+  ng.set_name(g, "g");
+  REQUIRE(ng.version() != v1);
+
+  auto v2 = ng.version();
+  REQUIRE(ng.add_output_socket(g, "out"));
+  REQUIRE(ng.version() != v2);
+
+  auto v3 = ng.version();
+  ng.destroy(g);
+  REQUIRE(ng.version() != v3);
+}
+
 TEST_CASE("root")
 {
   structured_node_graph ng;
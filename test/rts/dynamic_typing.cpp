@@ -3,6 +3,7 @@
 // Distributed under LGPLv3 License. See LICENSE for more details.
 //
 
+#define CATCH_CONFIG_ENABLE_BENCHMARKING
 #include <catch2/catch.hpp>
 
 #include <yave/rts/dynamic_typing.hpp>
@@ -618,6 +619,83 @@ TEST_CASE("copy_type")
   }
 }
 
+TEST_CASE("type_interner")
+{
+  struct F : Function<F, List<Int>, Maybe<Double>>
+  {
+    return_type code() const
+    {
+      throw;
+    }
+  };
+
+  auto interner = type_interner();
+
+  SECTION("intern")
+  {
+    auto t1 = object_type<F>();
+    auto t2 = copy_type(t1);
+    REQUIRE(t1 != t2);
+
+    auto i1 = interner.intern(t1);
+    auto i2 = interner.intern(t2);
+    REQUIRE(i1 == i2);
+    REQUIRE(interner.owns(i1));
+    REQUIRE(same_type(i1, t2));
+    REQUIRE(interner.intern(i1) == i1);
+  }
+
+  SECTION("different")
+  {
+    auto i1 = interner.intern(object_type<Int>());
+    auto i2 = interner.intern(object_type<Double>());
+    auto i3 = interner.intern(copy_type(object_type<Int>()));
+    REQUIRE(i1 != i2);
+    REQUIRE(!same_type(i1, i2));
+    REQUIRE(same_type(i1, i3));
+  }
+
+  SECTION("tap")
+  {
+    auto t1 = interner.tap(object_type<Int>(), object_type<Double>());
+    auto t2 =
+      interner.tap(object_type<Int>(), copy_type(object_type<Double>()));
+    REQUIRE(t1 == t2);
+    REQUIRE(interner.size() == 3);
+  }
+
+  SECTION("scope")
+  {
+    auto v = genvar();
+    {
+      auto scope = type_interner::scope(interner);
+      REQUIRE(type_interner::current() == &interner);
+
+      auto t1 = make_arrow_type(v, object_type<Int>());
+      auto t2 = make_arrow_type(copy_type(v), object_type<Int>());
+      REQUIRE(t1 == t2);
+      REQUIRE(make_var_type(42) == make_var_type(42));
+    }
+    REQUIRE(type_interner::current() == nullptr);
+    REQUIRE(
+      make_arrow_type(v, object_type<Int>())
+      != make_arrow_type(v, object_type<Int>()));
+  }
+
+  SECTION("multiple interners")
+  {
+    auto interner2 = type_interner();
+
+    auto t  = copy_type(object_type<F>());
+    auto i1 = interner.intern(t);
+    auto i2 = interner2.intern(copy_type(t));
+
+    REQUIRE(i1 != i2);
+    REQUIRE(same_type(i1, i2));
+    REQUIRE(interner.intern(i2) == i1);
+  }
+}
+
 TEST_CASE("lambda")
 {
   SECTION("lx.x")
@@ -812,4 +890,42 @@ TEST_CASE("lambda")
       REQUIRE(same_type(e.provided(), object_type<Int>()));
     }
   }
-}
\ No newline at end of file
+}
+
+TEST_CASE("type_of benchmark", "[.][benchmark]")
+{
+  struct F
+    : Function<F, closure<class X, class Y>, List<class X>, List<class Y>>
+  {
+    return_type code() const
+    {
+      throw;
+    }
+  };
+
+  struct G : Function<G, Int, Int>
+  {
+    return_type code() const
+    {
+      throw;
+    }
+  };
+
+  auto f  = make_object<F>();
+  auto g  = make_object<G>();
+  auto id = make_object<Identity>();
+
+  // (lx. f (id g) x) ((lx. f (id g) x) (... nil))
+  object_ptr<const Object> app = make_object<List<Int>>();
+  for (auto i = 0; i < 200; ++i) {
+    auto x = make_object<Variable>();
+    app    = make_object<Lambda>(x, f << (id << g) << x) << app;
+  }
+
+  REQUIRE(same_type(type_of(app), object_type<List<Int>>()));
+
+  BENCHMARK("type_of")
+  {
+    return type_of(app);
+  };
+}
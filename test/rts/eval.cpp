@@ -3,8 +3,10 @@
 // Distributed under LGPLv3 License. See LICENSE for more details.
 //
 
+#define CATCH_CONFIG_ENABLE_BENCHMARKING
 #include <yave/rts/rts.hpp>
 #include <catch2/catch.hpp>
+#include <thread>
 
 using namespace yave;
 
@@ -341,6 +343,126 @@ TEST_CASE("eval")
       REQUIRE(*value_cast<Int>(eval(app)) == 42);
       REQUIRE(*value_cast<Int>(eval(app)) == 42);
     }
+
+    SECTION("lx.((lx.x) 1)")
+    {
+      auto x   = make_object<Variable>();
+      auto lam = make_object<Lambda>(
+        x, make_object<Lambda>(x, x) << make_object<Int>(1));
+
+      auto app = lam << make_object<Int>(42);
+
+      REQUIRE_NOTHROW(check_type_dynamic<Int>(app));
+      REQUIRE(*value_cast<Int>(eval(app)) == 1);
+    }
+  }
+}
+
+TEST_CASE("Lambda instantiation", "[rts][eval]")
+{
+  static int count = 0;
+
+  struct F : Function<F, Int, Int, Int>
+  {
+    return_type code() const
+    {
+      return make_object<Int>(*eval_arg<0>() + *eval_arg<1>());
+    }
+  };
+
+  struct G : Function<G, Int, Int>
+  {
+    return_type code() const
+    {
+      ++count;
+      return make_object<Int>(*eval_arg<0>() * 2);
+    }
+  };
+
+  auto f = make_object<F>();
+  auto g = make_object<G>();
+  auto x = make_object<Variable>();
+
+  count = 0;
+
+  SECTION("shared subtree")
+  {
+    // lx. f (g 1) x
+    auto lam = make_object<Lambda>(x, f << (g << make_object<Int>(1)) << x);
+
+    REQUIRE(*value_cast<Int>(eval(lam << make_object<Int>(1))) == 3);
+    REQUIRE(*value_cast<Int>(eval(lam << make_object<Int>(2))) == 4);
+    REQUIRE(count == 1);
+  }
+
+  SECTION("shared variable")
+  {
+    // lx. f (g x) (g x), where (g x) is shared
+    auto gx  = g << x;
+    auto lam = make_object<Lambda>(x, f << gx << gx);
+
+    REQUIRE(*value_cast<Int>(eval(lam << make_object<Int>(1))) == 4);
+    REQUIRE(count == 1);
+    REQUIRE(*value_cast<Int>(eval(lam << make_object<Int>(2))) == 8);
+    REQUIRE(count == 2);
+  }
+
+  SECTION("nested")
+  {
+    // lx.ly. f (g x) y, as generated for group with 2 inputs
+    auto y   = make_object<Variable>();
+    auto lam =
+      make_object<Lambda>(x, make_object<Lambda>(y, f << (g << x) << y));
+
+    auto app = [&](int a, int b) {
+      return *value_cast<Int>(
+        eval(lam << make_object<Int>(a) << make_object<Int>(b)));
+    };
+
+    REQUIRE(app(1, 2) == 4);
+
+    // plans of both lambdas are built on first application, and instances of
+    // nested lambda reuse its plan.
+    auto n = detail::lambda_body_plans;
+    for (int i = 0; i < 10; ++i)
+      REQUIRE(app(i, 1) == 2 * i + 1);
+    REQUIRE(detail::lambda_body_plans == n);
+  }
+
+  SECTION("nested 3")
+  {
+    // lx.ly.lz. f (f x y) (f (g 1) z)
+    auto y   = make_object<Variable>();
+    auto z   = make_object<Variable>();
+    auto g1  = g << make_object<Int>(1);
+    auto lam = make_object<Lambda>(
+      x,
+      make_object<Lambda>(
+        y, make_object<Lambda>(z, f << (f << x << y) << (f << g1 << z))));
+
+    auto app = [&](int a, int b, int c) {
+      return *value_cast<Int>(eval(
+        lam << make_object<Int>(a) << make_object<Int>(b)
+            << make_object<Int>(c)));
+    };
+
+    REQUIRE(app(1, 2, 3) == 8);
+    auto n = detail::lambda_body_plans;
+    REQUIRE(app(10, 20, 30) == 62);
+    REQUIRE(app(0, 0, 0) == 2);
+    REQUIRE(detail::lambda_body_plans == n);
+    REQUIRE(count == 1);
+  }
+
+  SECTION("copy_apply_graph")
+  {
+    auto lam  = make_object<Lambda>(x, f << (g << make_object<Int>(1)) << x);
+    auto app  = lam << make_object<Int>(1);
+    auto copy = copy_apply_graph(app);
+
+    REQUIRE(*value_cast<Int>(eval(app)) == 3);
+    REQUIRE(*value_cast<Int>(eval(copy)) == 3);
+    REQUIRE(count == 2);
   }
 }
 
@@ -432,4 +554,316 @@ TEST_CASE("Deep tree", "[rts][eval]")
     auto r = eval(app);
     REQUIRE(*value_cast<Int>(r) == 42);
   }
-}
\ No newline at end of file
+}
+TEST_CASE("Long spine", "[rts][eval]")
+{
+  auto id = make_object<Identity>();
+
+  SECTION("id")
+  {
+    // id id id ... 42
+    object_ptr<> app = id;
+    for (auto i = 0; i < 1000; ++i) {
+      app = app << id;
+    }
+    app = app << make_object<Int>(42);
+
+    REQUIRE(*value_cast<Int>(eval(app)) == 42);
+    REQUIRE(*value_cast<Int>(eval(app)) == 42);
+  }
+
+  SECTION("lambda")
+  {
+    // (lx. (lx. ... (lx. id x) ...) x) 42
+    auto x           = make_object<Variable>();
+    object_ptr<> lam = make_object<Lambda>(x, id << x);
+    for (auto i = 0; i < 1000; ++i) {
+      lam = make_object<Lambda>(x, lam << x);
+    }
+    auto app = lam << make_object<Int>(42);
+
+    REQUIRE(*value_cast<Int>(eval(app)) == 42);
+  }
+}
+
+TEST_CASE("Tail call", "[rts][eval]")
+{
+  // counts down n while incrementing acc
+  struct Loop : Function<Loop, closure<Int, Int, Int>, Int, Int, Int>
+  {
+    return_type code() const
+    {
+      auto n   = eval_arg<1>();
+      auto acc = eval_arg<2>();
+
+      if (*n == 0)
+        return acc;
+
+      return arg<0>() << make_object<Int>(*n - 1) << make_object<Int>(*acc + 1);
+    }
+  };
+
+  SECTION("fix")
+  {
+    // deep enough to overflow native stack without trampoline
+    auto app = make_object<Fix>() << make_object<Loop>()
+               << make_object<Int>(1000000) << make_object<Int>(0);
+
+    REQUIRE(same_type(type_of(app), object_type<Int>()));
+    REQUIRE(*value_cast<Int>(eval(app)) == 1000000);
+    REQUIRE(*value_cast<Int>(eval(app)) == 1000000);
+  }
+
+  SECTION("shared")
+  {
+    static int count = 0;
+
+    struct G : Function<G, Int, Int>
+    {
+      return_type code() const
+      {
+        ++count;
+        return make_object<Int>(*eval_arg<0>() * 2);
+      }
+    };
+
+    struct Select : Function<Select, Bool, Int, Int, Int>
+    {
+      return_type code() const
+      {
+        // branches are returned unevaluated
+        if (*eval_arg<0>())
+          return arg<1>();
+        return arg<2>();
+      }
+    };
+
+    count = 0;
+
+    auto sel = make_object<Select>();
+    auto gx  = make_object<G>() << make_object<Int>(21);
+    auto l   = sel << make_object<Bool>(true) << gx << make_object<Int>(0);
+    auto r   = sel << make_object<Bool>(false) << make_object<Int>(0) << gx;
+
+    REQUIRE(*value_cast<Int>(eval(l)) == 42);
+    REQUIRE(*value_cast<Int>(eval(r)) == 42);
+    REQUIRE(*value_cast<Int>(eval(l)) == 42);
+    REQUIRE(count == 1);
+  }
+
+  SECTION("exception")
+  {
+    struct Throw : Function<Throw, Int, Int>
+    {
+      return_type code() const
+      {
+        throw std::runtime_error("tail");
+      }
+    };
+
+    struct F : Function<F, Int, Int>
+    {
+      return_type code() const
+      {
+        return make_object<Throw>() << arg<0>();
+      }
+    };
+
+    auto app = make_object<F>() << make_object<Int>(42);
+    REQUIRE_THROWS_AS(eval(app), exception_result);
+  }
+}
+
+TEST_CASE("eval benchmark", "[.][benchmark]")
+{
+  struct F : Function<F, closure<Int, Int>, Int, Int>
+  {
+    return_type code() const
+    {
+      return arg<0>() << arg<1>();
+    }
+  };
+
+  struct G : Function<G, Int, Int>
+  {
+    return_type code() const
+    {
+      return eval_arg<0>();
+    }
+  };
+
+  // returns spine deeper than arity of bottom closure
+  struct H : Function<H, Int, Int>
+  {
+    return_type code() const
+    {
+      auto id = make_object<Identity>();
+      return id << id << eval_arg<0>();
+    }
+  };
+
+  struct K : Function<K, Int, Int, Int>
+  {
+    return_type code() const
+    {
+      return eval_arg<0>();
+    }
+  };
+
+  auto f  = make_object<F>();
+  auto g  = make_object<G>();
+  auto h  = make_object<H>();
+  auto k  = make_object<K>();
+  auto id = make_object<Identity>();
+
+  object_ptr<> deep = f << g;
+  for (auto i = 0; i < 1000; ++i) {
+    deep = f << deep;
+  }
+  deep = deep << make_object<Int>(42);
+
+  object_ptr<> longs = id;
+  for (auto i = 0; i < 1000; ++i) {
+    longs = longs << id;
+  }
+  longs = longs << make_object<Int>(42);
+
+  object_ptr<> shorts = make_object<Int>(42);
+  for (auto i = 0; i < 1000; ++i) {
+    shorts = h << shorts;
+  }
+
+  // lx. k x (g (g ... 42))
+  object_ptr<> body = make_object<Int>(42);
+  for (auto i = 0; i < 100; ++i) {
+    body = g << body;
+  }
+  auto x   = make_object<Variable>();
+  auto lam = make_object<Lambda>(x, k << x << body);
+
+  struct Loop : Function<Loop, closure<Int, Int, Int>, Int, Int, Int>
+  {
+    return_type code() const
+    {
+      auto n   = eval_arg<1>();
+      auto acc = eval_arg<2>();
+
+      if (*n == 0)
+        return acc;
+
+      return arg<0>() << make_object<Int>(*n - 1) << make_object<Int>(*acc + 1);
+    }
+  };
+
+  // fix loop (n, acc) 10000 iterations
+  object_ptr<> loop = make_object<Fix>() << make_object<Loop>()
+                      << make_object<Int>(10000) << make_object<Int>(0);
+
+  // evaluate fresh copies to avoid cached results
+  auto run = [](auto& meter, const object_ptr<>& app) {
+    auto apps = std::vector<object_ptr<const Object>>(meter.runs());
+    for (auto&& a : apps)
+      a = copy_apply_graph(app);
+    meter.measure([&](int i) { return eval(apps[i]); });
+  };
+
+  BENCHMARK_ADVANCED("deep")(Catch::Benchmark::Chronometer meter)
+  {
+    run(meter, deep);
+  };
+
+  BENCHMARK_ADVANCED("long")(Catch::Benchmark::Chronometer meter)
+  {
+    run(meter, longs);
+  };
+
+  BENCHMARK_ADVANCED("short")(Catch::Benchmark::Chronometer meter)
+  {
+    run(meter, shorts);
+  };
+
+  BENCHMARK_ADVANCED("lambda")(Catch::Benchmark::Chronometer meter)
+  {
+    auto lams = std::vector<object_ptr<const Object>>(meter.runs());
+    for (auto&& l : lams)
+      l = copy_apply_graph(lam);
+    meter.measure([&](int i) {
+      for (auto j = 0; j < 100; ++j)
+        (void)eval(lams[i] << make_object<Int>(j));
+    });
+  };
+
+  BENCHMARK_ADVANCED("tail loop")(Catch::Benchmark::Chronometer meter)
+  {
+    run(meter, loop);
+  };
+}
+
+TEST_CASE("Cancellation", "[rts][eval]")
+{
+  struct Loop : Function<Loop, closure<Int, Int>, Int, Int>
+  {
+    return_type code() const
+    {
+      auto n = eval_arg<1>();
+      return arg<0>() << make_object<Int>(*n + 1);
+    }
+  };
+
+  // cancellation from closure code is forwarded as exception
+  auto is_cancelled = [](auto&& f) {
+    try {
+      f();
+    } catch (const result_error::cancelled&) {
+      return true;
+    } catch (const exception_result& e) {
+      auto err = value_cast_if<ResultError>(e.exception()->error());
+      return err && err->error_type == result_error_type::cancelled;
+    }
+    return false;
+  };
+
+  SECTION("not cancelled")
+  {
+    auto token = cancel_token();
+    auto scope = cancel_token::scope(token);
+    auto app   = make_object<Int>(42);
+    REQUIRE(*value_cast<Int>(eval(app)) == 42);
+    REQUIRE(!token.is_cancelled());
+  }
+
+  SECTION("cancelled")
+  {
+    auto token = cancel_token();
+    token.cancel();
+    auto scope = cancel_token::scope(token);
+    auto app   = make_object<Fix>() << make_object<Loop>() << make_object<Int>(0);
+    REQUIRE(is_cancelled([&] { (void)eval(app); }));
+  }
+
+  SECTION("async")
+  {
+    auto token = cancel_token();
+    auto app   = make_object<Fix>() << make_object<Loop>() << make_object<Int>(0);
+
+    auto th = std::thread([&] {
+      std::this_thread::sleep_for(std::chrono::milliseconds(10));
+      token.cancel();
+    });
+
+    auto scope = cancel_token::scope(token);
+    REQUIRE(is_cancelled([&] { (void)eval(app); }));
+    th.join();
+  }
+
+  SECTION("scope")
+  {
+    auto token = cancel_token();
+    token.cancel();
+    {
+      auto scope = cancel_token::scope(token);
+    }
+    auto app = make_object<Int>(42);
+    REQUIRE(*value_cast<Int>(eval(app)) == 42);
+  }
+}
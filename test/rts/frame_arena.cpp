@@ -0,0 +1,161 @@
+//
+// Copyright (c) 2019 mocabe (https://github.com/mocabe)
+// Distributed under LGPLv3 License. See LICENSE for more details.
+//
+
+#include <yave/rts/rts.hpp>
+#include <yave/rts/frame_arena.hpp>
+#include <yave/rts/task_pool.hpp>
+#include <catch2/catch.hpp>
+
+#include <thread>
+#include <array>
+
+using namespace yave;
+
+namespace yave {
+  using Int   = yave::Box<int>;
+  using Large = yave::Box<std::array<char, frame_arena::max_alloc_size * 2>>;
+} // namespace yave
+
+YAVE_DECL_TYPE(Int, "4a0ea2b3-2e65-4f8b-a4f3-0f8d6f4a1c3e");
+YAVE_DECL_TYPE(Large, "c7d1f0a4-5b8e-4e2a-9f36-1d0b7e8a2c54");
+
+namespace {
+
+  struct Add : Function<Add, Int, Int, Int>
+  {
+    return_type code() const
+    {
+      auto [x, y] = eval_args<0, 1>();
+      return make_object<Int>(*x + *y);
+    }
+  };
+
+  auto resource_of(const object_ptr<const Object>& obj)
+  {
+    return obj.get()->memory_resource;
+  }
+
+  auto build(const object_ptr<const Object>& leaf, int depth)
+    -> object_ptr<const Object>
+  {
+    if (depth == 0)
+      return leaf;
+    return make_object<Add>() << build(leaf, depth - 1)
+                              << build(leaf, depth - 1);
+  }
+} // namespace
+
+TEST_CASE("frame_arena")
+{
+  auto& arena = frame_arena::instance();
+
+  SECTION("scope")
+  {
+    auto i1 = make_object<Int>(1);
+    REQUIRE(resource_of(i1) == std::pmr::get_default_resource());
+    {
+      auto scope = frame_arena::scope();
+      auto i2    = make_object<Int>(2);
+      REQUIRE(resource_of(i2) == &arena);
+      // clones are allocated from arena
+      auto i3 = i1.clone();
+      REQUIRE(resource_of(i3) == &arena);
+    }
+    auto i4 = make_object<Int>(4);
+    REQUIRE(resource_of(i4) == std::pmr::get_default_resource());
+  }
+
+  SECTION("escape")
+  {
+    object_ptr<const Int> result;
+    {
+      auto scope = frame_arena::scope();
+      std::vector<object_ptr<const Int>> tmp;
+      for (int i = 0; i < 10000; ++i)
+        tmp.push_back(make_object<Int>(i));
+      result = tmp[42];
+    }
+    // allocate more on another thread
+    std::thread([] {
+      auto scope = frame_arena::scope();
+      for (int i = 0; i < 10000; ++i)
+        (void)make_object<Int>(i);
+    }).join();
+
+    REQUIRE(*result == 42);
+  }
+
+  SECTION("eval")
+  {
+    auto leaf = make_object<Add>() << make_object<Int>(1) << make_object<Int>(0);
+    auto tree = build(leaf, 10);
+
+    object_ptr<const Int> r;
+    {
+      auto scope = frame_arena::scope();
+      r          = value_cast<Int>(eval(tree));
+    }
+    REQUIRE(*r == 1024);
+    REQUIRE(resource_of(r) == &arena);
+  }
+
+  SECTION("parallel")
+  {
+    auto pool = task_pool(4);
+
+    auto leaf = make_object<Add>() << make_object<Int>(1) << make_object<Int>(0);
+    auto tree = build(leaf, 10);
+
+    object_ptr<const Int> r;
+    {
+      auto s1 = task_pool::scope(pool);
+      auto s2 = frame_arena::scope();
+      r       = value_cast<Int>(eval(tree));
+    }
+    REQUIRE(*r == 1024);
+  }
+
+  SECTION("large")
+  {
+    object_ptr<const Large> r;
+    {
+      auto scope = frame_arena::scope(arena, true);
+      auto i     = make_object<Int>(1);
+      auto l     = make_object<Large>();
+      REQUIRE(resource_of(l) == &arena);
+      REQUIRE(frame_arena::is_confined(i.get()));
+      // large objects are allocated from upstream, and always shared
+      REQUIRE(!frame_arena::is_confined(l.get()));
+      auto l2 = l;
+      REQUIRE(l.use_count() == 2);
+      r = l;
+    }
+    REQUIRE(r.use_count() == 1);
+    r = nullptr;
+  }
+
+  SECTION("owner")
+  {
+    auto scope = frame_arena::scope(arena, true);
+    auto i     = make_object<Int>(1);
+    REQUIRE(frame_arena::is_confined(i.get()));
+
+    // other threads use atomic reference counting
+    auto confined = true;
+    std::thread([&] { confined = frame_arena::is_confined(i.get()); }).join();
+    REQUIRE(!confined);
+  }
+
+  SECTION("recycle")
+  {
+    {
+      auto scope = frame_arena::scope();
+      for (int i = 0; i < 100000; ++i)
+        (void)make_object<Int>(i);
+    }
+    // freed blocks are kept or released, not leaked
+    REQUIRE(arena.n_blocks() <= arena.n_free_blocks() + 1);
+  }
+}
@@ -0,0 +1,283 @@
+//
+// Copyright (c) 2019 mocabe (https://github.com/mocabe)
+// Distributed under LGPLv3 License. See LICENSE for more details.
+//
+
+#define CATCH_CONFIG_ENABLE_BENCHMARKING
+#include <yave/rts/rts.hpp>
+#include <yave/rts/immediate.hpp>
+#include <catch2/catch.hpp>
+
+#include <limits>
+#include <cmath>
+
+using namespace yave;
+
+namespace yave {
+  using Int   = yave::Box<int64_t>;
+  using Float = yave::Box<double>;
+  using Bool  = yave::Box<bool>;
+  using Int32 = yave::Box<int32_t>;
+} // namespace yave
+
+YAVE_DECL_TYPE(Int, "a3c61e0d-5f5b-4c8e-9a52-8d1e4e1b7a10");
+YAVE_DECL_TYPE(Float, "0f6d8b0e-3b7d-4c55-8e0e-1fb6c3f4b2a1");
+YAVE_DECL_TYPE(Bool, "5e2f7a9c-6d4b-4a3e-b1c8-7f9d2e0a6b53");
+YAVE_DECL_TYPE(Int32, "c8b1d4e2-9a7f-4e6d-8c3b-2a5f1e7d9b04");
+
+namespace {
+
+  template <class T>
+  bool is_immediate(const object_ptr<T>& p)
+  {
+    return _get_storage(p).is_immediate();
+  }
+
+  struct AddInt : Function<AddInt, Int, Int, Int>
+  {
+    return_type code() const
+    {
+      auto [x, y] = eval_args<0, 1>();
+      return make_object<Int>(*x + *y);
+    }
+  };
+
+  struct AddIntImmediate : Function<AddIntImmediate, Int, Int, Int>
+  {
+    return_type code() const
+    {
+      auto [x, y] = eval_args<0, 1>();
+      return make_immediate<Int>(*x + *y);
+    }
+  };
+
+  struct AddFloatImmediate : Function<AddFloatImmediate, Float, Float, Float>
+  {
+    return_type code() const
+    {
+      auto [x, y] = eval_args<0, 1>();
+      return make_immediate<Float>(*x + *y);
+    }
+  };
+
+  struct LessImmediate : Function<LessImmediate, Int, Int, Bool>
+  {
+    return_type code() const
+    {
+      auto [x, y] = eval_args<0, 1>();
+      return make_immediate<Bool>(*x < *y);
+    }
+  };
+
+  /// add (add (add ... x) x) x
+  template <class F, class T>
+  auto add_chain(const object_ptr<T>& x, int n) -> object_ptr<const Object>
+  {
+    auto f   = make_object<F>();
+    auto app = object_ptr<const Object>(x);
+    for (auto i = 0; i < n; ++i)
+      app = f << app << x;
+    return app;
+  }
+} // namespace
+
+TEST_CASE("immediate int", "[rts][immediate]")
+{
+  SECTION("small")
+  {
+    for (auto v : {int64_t(0), int64_t(1), int64_t(-1), int64_t(42)}) {
+      auto i = make_immediate<Int>(v);
+      REQUIRE(i);
+      REQUIRE(is_immediate(i));
+      REQUIRE(*i == v);
+    }
+  }
+
+  SECTION("range")
+  {
+    auto max = (int64_t(1) << 62) - 1;
+    auto min = -(int64_t(1) << 62);
+
+    REQUIRE(is_immediate(make_immediate<Int>(max)));
+    REQUIRE(is_immediate(make_immediate<Int>(min)));
+    REQUIRE(*make_immediate<Int>(max) == max);
+    REQUIRE(*make_immediate<Int>(min) == min);
+
+    // out of range values are boxed
+    auto big = make_immediate<Int>(max + 1);
+    REQUIRE(!is_immediate(big));
+    REQUIRE(*big == max + 1);
+
+    auto small = make_immediate<Int>(std::numeric_limits<int64_t>::min());
+    REQUIRE(!is_immediate(small));
+    REQUIRE(*small == std::numeric_limits<int64_t>::min());
+  }
+
+  SECTION("refcount")
+  {
+    auto i = make_immediate<Int>(42);
+    REQUIRE(i.is_static());
+    REQUIRE(i.use_count() == 0);
+    auto j = i;
+    REQUIRE(i == j);
+    REQUIRE(*j == 42);
+  }
+
+  SECTION("typing")
+  {
+    object_ptr<const Object> i = make_immediate<Int>(42);
+    REQUIRE(has_type<Int>(i));
+    REQUIRE(!has_type<Float>(i));
+    REQUIRE(!has_type<Bool>(i));
+    REQUIRE(!has_type<Int32>(i));
+    REQUIRE(!has_type<Apply>(i));
+    REQUIRE(same_type(get_type(i), object_type<Int>()));
+    REQUIRE(same_type(type_of(i), object_type<Int>()));
+    REQUIRE(get_size(i) == sizeof(Int));
+    REQUIRE(std::string(get_name(i)) == object_type_traits<Int>::name);
+  }
+
+  SECTION("value_cast")
+  {
+    object_ptr<const Object> i = make_immediate<Int>(-7);
+    REQUIRE(*value_cast<Int>(i) == -7);
+    REQUIRE(value_cast_if<Int>(i));
+    REQUIRE(!value_cast_if<Float>(i));
+    REQUIRE_THROWS_AS(value_cast<Float>(i), bad_value_cast);
+  }
+
+  SECTION("clone")
+  {
+    auto i = make_immediate<Int>(42);
+    auto c = i.clone();
+    REQUIRE(!is_immediate(c));
+    REQUIRE(*c == 42);
+    *c = 24;
+    REQUIRE(*c == 24);
+    REQUIRE(*i == 42);
+  }
+}
+
+TEST_CASE("immediate float", "[rts][immediate]")
+{
+  SECTION("values")
+  {
+    for (auto v : {0.0, 1.0, -1.0, 0.5, 3.14, -2.5e10, 1e-10}) {
+      auto f = make_immediate<Float>(v);
+      REQUIRE(is_immediate(f));
+      REQUIRE(*f == v);
+    }
+  }
+
+  SECTION("boxed")
+  {
+    for (auto v :
+         {-0.0,
+          1e300,
+          -1e-300,
+          std::numeric_limits<double>::infinity(),
+          std::numeric_limits<double>::denorm_min()}) {
+      auto f = make_immediate<Float>(v);
+      REQUIRE(!is_immediate(f));
+      REQUIRE(std::bit_cast<uint64_t>(*f) == std::bit_cast<uint64_t>(v));
+    }
+
+    auto nan = make_immediate<Float>(std::numeric_limits<double>::quiet_NaN());
+    REQUIRE(std::isnan(*nan));
+  }
+
+  SECTION("typing")
+  {
+    object_ptr<const Object> f = make_immediate<Float>(1.5);
+    REQUIRE(has_type<Float>(f));
+    REQUIRE(!has_type<Int>(f));
+    REQUIRE(!has_type<Bool>(f));
+    REQUIRE(same_type(type_of(f), object_type<Float>()));
+    REQUIRE(*value_cast<Float>(f) == 1.5);
+  }
+}
+
+TEST_CASE("immediate bool", "[rts][immediate]")
+{
+  auto t = make_immediate<Bool>(true);
+  auto f = make_immediate<Bool>(false);
+  REQUIRE(is_immediate(t));
+  REQUIRE(is_immediate(f));
+  REQUIRE(*t);
+  REQUIRE(!*f);
+  REQUIRE(t != f);
+  REQUIRE(t == make_immediate<Bool>(true));
+
+  object_ptr<const Object> b = f;
+  REQUIRE(has_type<Bool>(b));
+  REQUIRE(!has_type<Int>(b));
+  REQUIRE(!has_type<Float>(b));
+  REQUIRE(same_type(type_of(b), object_type<Bool>()));
+}
+
+TEST_CASE("immediate eval", "[rts][immediate]")
+{
+  SECTION("int")
+  {
+    auto r = eval(add_chain<AddIntImmediate>(make_immediate<Int>(1), 100));
+    REQUIRE(is_immediate(r));
+    REQUIRE(*value_cast<Int>(r) == 101);
+  }
+
+  SECTION("mixed")
+  {
+    // boxed and immediate arguments
+    auto f   = make_object<AddIntImmediate>();
+    auto app = f << make_object<Int>(1) << make_immediate<Int>(2);
+    REQUIRE(*value_cast<Int>(eval(app)) == 3);
+  }
+
+  SECTION("float")
+  {
+    auto r = eval(add_chain<AddFloatImmediate>(make_immediate<Float>(0.5), 9));
+    REQUIRE(*value_cast<Float>(r) == 5.0);
+  }
+
+  SECTION("bool")
+  {
+    auto lt = make_object<LessImmediate>();
+    auto r1 = eval(lt << make_immediate<Int>(1) << make_immediate<Int>(2));
+    auto r2 = eval(lt << make_immediate<Int>(2) << make_immediate<Int>(1));
+    REQUIRE(*value_cast<Bool>(r1));
+    REQUIRE(!*value_cast<Bool>(r2));
+  }
+
+  SECTION("type check")
+  {
+    auto app = add_chain<AddIntImmediate>(make_immediate<Int>(1), 10);
+    REQUIRE(same_type(type_of(app), object_type<Int>()));
+  }
+}
+
+TEST_CASE("immediate benchmark", "[.][benchmark]")
+{
+  constexpr auto n = 1000;
+
+  auto boxed     = add_chain<AddInt>(make_object<Int>(1), n);
+  auto immediate = add_chain<AddIntImmediate>(make_immediate<Int>(1), n);
+
+  // evaluate fresh copies to avoid cached results
+  auto run = [](auto& meter, const object_ptr<const Object>& app) {
+    auto apps = std::vector<object_ptr<const Object>>(meter.runs());
+    for (auto&& a : apps)
+      a = copy_apply_graph(app);
+    meter.measure([&](int i) { return eval(apps[i]); });
+  };
+
+  BENCHMARK_ADVANCED("Num.Add chain boxed")
+  (Catch::Benchmark::Chronometer meter)
+  {
+    run(meter, boxed);
+  };
+
+  BENCHMARK_ADVANCED("Num.Add chain immediate")
+  (Catch::Benchmark::Chronometer meter)
+  {
+    run(meter, immediate);
+  };
+}
@@ -0,0 +1,136 @@
+//
+// Copyright (c) 2019 mocabe (https://github.com/mocabe)
+// Distributed under LGPLv3 License. See LICENSE for more details.
+//
+
+#define CATCH_CONFIG_ENABLE_BENCHMARKING
+#include <yave/rts/rts.hpp>
+#include <yave/rts/frame_arena.hpp>
+#include <catch2/catch.hpp>
+
+#include <thread>
+
+using namespace yave;
+
+namespace yave {
+  using Int = yave::Box<int>;
+} // namespace yave
+
+YAVE_DECL_TYPE(Int, "0b1f8e0c-64b1-4d3b-9d1f-3d8e5b0a9c27");
+
+namespace {
+
+  bool confined(const object_ptr<const Object>& obj)
+  {
+    return frame_arena::is_confined(obj.get());
+  }
+} // namespace
+
+TEST_CASE("confined refcount")
+{
+  auto& arena = frame_arena::instance();
+
+  SECTION("default")
+  {
+    auto i = make_object<Int>(42);
+    REQUIRE(!confined(i));
+    {
+      auto scope = frame_arena::scope(arena);
+      auto j     = make_object<Int>(42);
+      REQUIRE(!confined(j));
+    }
+  }
+
+  SECTION("confined")
+  {
+    object_ptr<const Int> escaped;
+    {
+      auto scope = frame_arena::scope(arena, true);
+      auto i     = make_object<Int>(42);
+      REQUIRE(confined(i));
+      {
+        auto j = i;
+        REQUIRE(i.use_count() == 2);
+      }
+      REQUIRE(i.use_count() == 1);
+      escaped = i;
+    }
+    // shared on exit of scope
+    REQUIRE(!confined(escaped));
+    REQUIRE(escaped.use_count() == 1);
+    REQUIRE(*escaped == 42);
+  }
+
+  SECTION("share")
+  {
+    auto scope = frame_arena::scope(arena, true);
+    auto i     = make_object<Int>(1);
+    REQUIRE(confined(i));
+    arena.share();
+    REQUIRE(!confined(i));
+
+    // new objects are confined again
+    auto j = make_object<Int>(2);
+    REQUIRE(confined(j));
+
+    std::thread([i] { REQUIRE(*i == 1); }).join();
+    REQUIRE(i.use_count() == 1);
+  }
+
+  SECTION("eval")
+  {
+    object_ptr<const Int> r;
+    {
+      auto scope = frame_arena::scope(arena, true);
+      auto app   = make_object<Int>(1);
+      r          = value_cast<Int>(eval(app));
+    }
+    REQUIRE(!confined(r));
+    REQUIRE(*r == 1);
+  }
+}
+
+TEST_CASE("refcount benchmark", "[.][benchmark]")
+{
+  auto& arena = frame_arena::instance();
+
+  constexpr int n = 100000;
+
+  BENCHMARK("copy/destroy atomic")
+  {
+    auto obj = make_object<Int>(42);
+    for (int i = 0; i < n; ++i) {
+      auto tmp = obj;
+      (void)tmp;
+    }
+    return obj.use_count();
+  };
+
+  BENCHMARK("copy/destroy confined")
+  {
+    auto scope = frame_arena::scope(arena, true);
+    auto obj   = make_object<Int>(42);
+    for (int i = 0; i < n; ++i) {
+      auto tmp = obj;
+      (void)tmp;
+    }
+    return obj.use_count();
+  };
+
+  BENCHMARK("make/destroy default")
+  {
+    int sum = 0;
+    for (int i = 0; i < n; ++i)
+      sum += *make_object<Int>(i);
+    return sum;
+  };
+
+  BENCHMARK("make/destroy confined")
+  {
+    auto scope = frame_arena::scope(arena, true);
+    int sum    = 0;
+    for (int i = 0; i < n; ++i)
+      sum += *make_object<Int>(i);
+    return sum;
+  };
+}
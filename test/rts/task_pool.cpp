@@ -0,0 +1,109 @@
+//
+// Copyright (c) 2019 mocabe (https://github.com/mocabe)
+// Distributed under LGPLv3 License. See LICENSE for more details.
+//
+
+#include <yave/rts/rts.hpp>
+#include <catch2/catch.hpp>
+
+using namespace yave;
+
+namespace yave {
+  using Int = yave::Box<int>;
+} // namespace yave
+
+YAVE_DECL_TYPE(Int, "7d27665a-c56a-40d1-8e2e-844cb48de9e9");
+
+namespace {
+
+  struct Add : Function<Add, Int, Int, Int>
+  {
+    return_type code() const
+    {
+      auto [x, y] = eval_args<0, 1>();
+      return make_object<Int>(*x + *y);
+    }
+  };
+
+  // build balanced tree which shares leaves
+  auto build(const object_ptr<const Object>& leaf, int depth)
+    -> object_ptr<const Object>
+  {
+    if (depth == 0)
+      return leaf;
+    return make_object<Add>() << build(leaf, depth - 1)
+                              << build(leaf, depth - 1);
+  }
+} // namespace
+
+TEST_CASE("task_pool")
+{
+  auto pool = task_pool(4);
+
+  SECTION("invoke")
+  {
+    std::atomic<int> n = 0;
+    pool.invoke([&] { ++n; }, [&] { ++n; }, [&] { ++n; });
+    REQUIRE(n == 3);
+  }
+
+  SECTION("nested")
+  {
+    std::atomic<int> n = 0;
+    auto f             = [&] {
+      pool.invoke([&] { ++n; }, [&] { ++n; });
+    };
+    auto scope = task_pool::scope(pool);
+    pool.invoke(f, f, f, f);
+    REQUIRE(n == 8);
+  }
+
+  SECTION("exception")
+  {
+    REQUIRE_THROWS_AS(
+      pool.invoke([] {}, [] { throw std::runtime_error("err"); }),
+      std::runtime_error);
+  }
+
+  SECTION("scope")
+  {
+    REQUIRE(task_pool::current() == nullptr);
+    {
+      auto scope = task_pool::scope(pool);
+      REQUIRE(task_pool::current() == &pool);
+    }
+    REQUIRE(task_pool::current() == nullptr);
+  }
+}
+
+TEST_CASE("eval_parallel")
+{
+  SECTION("sequential")
+  {
+    auto [x, y] = eval_parallel(make_object<Int>(1), make_object<Int>(2));
+    REQUIRE(*x == 1);
+    REQUIRE(*y == 2);
+  }
+
+  SECTION("parallel")
+  {
+    auto pool  = task_pool(4);
+    auto scope = task_pool::scope(pool);
+
+    for (int i = 0; i < 10; ++i) {
+      auto leaf = make_object<Add>() << make_object<Int>(1)
+                                     << make_object<Int>(0);
+      auto tree = build(leaf, 10);
+      REQUIRE(*value_cast<Int>(eval(tree)) == 1024);
+    }
+  }
+
+  SECTION("set_result")
+  {
+    auto app = make_object<Apply>(make_object<Add>(), make_object<Int>(1));
+    auto& storage = _get_storage(*app);
+    storage.set_result(make_object<Int>(1));
+    storage.set_result(make_object<Int>(2));
+    REQUIRE(*value_cast<Int>(storage.get_result()) == 1);
+  }
+}
@@ -0,0 +1,104 @@
+//
+// Copyright (c) 2019 mocabe (https://github.com/mocabe)
+// Distributed under LGPLv3 License. See LICENSE for more details.
+//
+
+#include <catch2/catch.hpp>
+
+#include <yave/support/trace.hpp>
+
+#include <sstream>
+#include <thread>
+
+using namespace yave;
+
+namespace {
+
+  auto count(const std::string& str, const std::string& pat)
+  {
+    size_t n = 0;
+    for (auto p = str.find(pat); p != str.npos; p = str.find(pat, p + 1))
+      ++n;
+    return n;
+  }
+
+  auto dump()
+  {
+    std::stringstream ss;
+    write_trace(ss);
+    return ss.str();
+  }
+} // namespace
+
+TEST_CASE("trace")
+{
+  SECTION("disabled")
+  {
+    stop_trace();
+    REQUIRE(!is_trace_enabled());
+    {
+      YAVE_TRACE_SPAN("disabled span");
+    }
+    REQUIRE(count(dump(), "disabled span") == 0);
+  }
+
+  SECTION("span")
+  {
+    start_trace();
+    REQUIRE(is_trace_enabled());
+    set_trace_thread_name("main");
+    {
+      YAVE_TRACE_SPAN("outer", "test");
+      {
+        YAVE_TRACE_SPAN("inner", "test");
+      }
+    }
+    stop_trace();
+
+    {
+      YAVE_TRACE_SPAN("after stop");
+    }
+
+    auto json = dump();
+    REQUIRE(json.starts_with("{"));
+    REQUIRE(count(json, R"("name":"outer")") == 1);
+    REQUIRE(count(json, R"("name":"inner")") == 1);
+    REQUIRE(count(json, R"("cat":"test")") == 2);
+    REQUIRE(count(json, R"("ph":"X")") == 2);
+    REQUIRE(count(json, R"("args":{"name":"main"})") == 1);
+    REQUIRE(count(json, "after stop") == 0);
+  }
+
+  SECTION("restart")
+  {
+    start_trace();
+    {
+      YAVE_TRACE_SPAN("first");
+    }
+    start_trace();
+    {
+      YAVE_TRACE_SPAN("second");
+    }
+    stop_trace();
+
+    auto json = dump();
+    REQUIRE(count(json, "first") == 0);
+    REQUIRE(count(json, "second") == 1);
+  }
+
+  SECTION("threads")
+  {
+    start_trace();
+    auto t = std::thread([] {
+      set_trace_thread_name("worker \"1\"");
+      YAVE_TRACE_SPAN("work");
+    });
+    t.join();
+    stop_trace();
+
+    // events of exited threads are kept
+    auto json = dump();
+    REQUIRE(count(json, R"("name":"work")") == 1);
+    REQUIRE(count(json, R"("name":"worker \"1\"")") == 1);
+  }
+}